@@ -0,0 +1,209 @@
+#include "compile_descriptor.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/graphics/material/texture_parameters.hpp"
+
+#include "shake/content/derived_data_cache.hpp"
+#include "shake/content/descriptor_format.hpp"
+#include "shake/content/load_font.hpp"
+#include "shake/content/load_material.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+//----------------------------------------------------------------
+// Lays out a compiled descriptor, gathering its strings as they are added
+class DescriptorWriter
+{
+public:
+    //----------------------------------------------------------------
+    // Equal strings, such as paths to the same shader, are stored once
+    descriptor_format::StringRef add_string( const std::string& string )
+    {
+        const auto [ it, is_new ] = m_string_offsets.emplace( string, static_cast<uint32_t>( m_string_table.size() ) );
+        if ( is_new ) { m_string_table.append( string ); }
+        return descriptor_format::StringRef { it->second, static_cast<uint32_t>( string.size() ) };
+    }
+
+    descriptor_format::StringRef add_path( const io::Path& path ) { return add_string( path.get_string() ); }
+
+    //----------------------------------------------------------------
+    // Where the items of write() end up, for the descriptor to refer to them
+    template<typename Descriptor_T>
+    static uint64_t get_array_offset()
+    {
+        return sizeof( descriptor_format::Header ) + sizeof( Descriptor_T );
+    }
+
+    //----------------------------------------------------------------
+    template<typename Descriptor_T, typename Item_T = descriptor_format::StringRef>
+    std::vector<uint8_t> write( const descriptor_format::Kind kind, const Descriptor_T& descriptor, const std::vector<Item_T>& items = { } ) const
+    {
+        const auto header = descriptor_format::Header
+        {
+            descriptor_format::magic,
+            descriptor_format::version,
+            static_cast<uint32_t>( kind ),
+            static_cast<uint32_t>( sizeof( Descriptor_T ) ),
+            get_array_offset<Descriptor_T>() + items.size() * sizeof( Item_T ),
+            m_string_table.size()
+        };
+
+        auto bytes = std::vector<uint8_t> { };
+        bytes.reserve( static_cast<std::size_t>( header.string_table_offset + header.string_table_size ) );
+        write_pod( bytes, header );
+        write_pod( bytes, descriptor );
+        for ( const auto& item : items ) { write_pod( bytes, item ); }
+        bytes.insert( bytes.end(), m_string_table.begin(), m_string_table.end() );
+        return bytes;
+    }
+
+private:
+    std::string                     m_string_table      { };
+    std::map<std::string, uint32_t> m_string_offsets    { };
+};
+
+//----------------------------------------------------------------
+std::vector<uint8_t> compile_texture( const json11::Json& json )
+{
+    // the image format is not used by the loader, but is required all the same
+    io::file::json::read_as<std::string>( json, { "image_format" } );
+
+    auto writer = DescriptorWriter { };
+    auto descriptor = descriptor_format::TextureDescriptor { };
+    descriptor.image_path           = writer.add_string( io::file::json::read_as<std::string>( json, { "texture" } ) );
+    descriptor.texture_format       = static_cast<uint32_t>( graphics::to_texture_format( io::file::json::read_as<std::string>( json, { "texture_format" } ) ) );
+    descriptor.filter               = static_cast<uint32_t>( graphics::to_filter( io::file::json::read_as<std::string>( json, { "interpolation_mode" } ) ) );
+    descriptor.generate_mip_maps    = io::file::json::read_as<bool>( json, { "generate_mip_maps" } ) ? 1 : 0;
+    return writer.write( descriptor_format::Kind::Texture, descriptor );
+}
+
+//----------------------------------------------------------------
+std::vector<uint8_t> compile_cube_map( const json11::Json& json )
+{
+    io::file::json::read_as<std::string>( json, { "image_format" } );
+
+    const auto cube_face_keys = std::array<const char*, 6> { "right", "left", "top", "bottom", "front", "back" };
+
+    auto writer = DescriptorWriter { };
+    auto descriptor = descriptor_format::CubeMapDescriptor { };
+    for ( std::size_t cube_face_index = 0; cube_face_index < cube_face_keys.size(); ++cube_face_index )
+    {
+        descriptor.face_paths[ cube_face_index ] = writer.add_string( io::file::json::read_as<std::string>( json, { cube_face_keys[ cube_face_index ] } ) );
+    }
+    descriptor.texture_format       = static_cast<uint32_t>( graphics::to_texture_format( io::file::json::read_as<std::string>( json, { "texture_format" } ) ) );
+    descriptor.filter               = static_cast<uint32_t>( graphics::to_filter( io::file::json::read_as<std::string>( json, { "interpolation_mode" } ) ) );
+    descriptor.generate_mip_maps    = io::file::json::read_as<bool>( json, { "generate_mip_maps" } ) ? 1 : 0;
+    return writer.write( descriptor_format::Kind::CubeMap, descriptor );
+}
+
+//----------------------------------------------------------------
+std::vector<uint8_t> compile_material( const json11::Json& json )
+{
+    const auto material_description = load::parse_material_description( json );
+
+    auto writer = DescriptorWriter { };
+    auto uniforms = std::vector<descriptor_format::UniformDescriptor> { };
+    for ( const auto& uniform_description : material_description.uniforms )
+    {
+        uniforms.emplace_back( descriptor_format::UniformDescriptor
+        {
+            static_cast<uint32_t>( uniform_description.type ),
+            writer.add_path( uniform_description.path )
+        } );
+    }
+
+    auto descriptor = descriptor_format::MaterialDescriptor { };
+    descriptor.shader_path      = writer.add_path( material_description.shader_path );
+    descriptor.uniforms_offset  = DescriptorWriter::get_array_offset<descriptor_format::MaterialDescriptor>();
+    descriptor.n_uniforms       = static_cast<uint32_t>( uniforms.size() );
+    return writer.write( descriptor_format::Kind::Material, descriptor, uniforms );
+}
+
+//----------------------------------------------------------------
+std::vector<uint8_t> compile_sprite( const json11::Json& json )
+{
+    auto writer = DescriptorWriter { };
+    auto descriptor = descriptor_format::SpriteDescriptor { };
+    descriptor.texture_path = writer.add_string( io::file::json::read_as<std::string>( json, { "texture" } ) );
+    descriptor.width        = io::file::json::read_as<float>( json, { "width"  } );
+    descriptor.height       = io::file::json::read_as<float>( json, { "height" } );
+    return writer.write( descriptor_format::Kind::Sprite, descriptor );
+}
+
+//----------------------------------------------------------------
+std::vector<uint8_t> compile_font( const json11::Json& json )
+{
+    const auto font_description = load::parse_font_description( json );
+
+    auto writer = DescriptorWriter { };
+    auto descriptor = descriptor_format::FontDescriptor { };
+    for ( std::size_t face_index = 0; face_index < load::n_faces_per_font; ++face_index )
+    {
+        descriptor.face_paths[ face_index ] = writer.add_path( font_description.face_paths[ face_index ] );
+    }
+    descriptor.rendering    = static_cast<int32_t>( font_description.rendering );
+    descriptor.pixel_size   = font_description.pixel_size;
+    descriptor.sdf_spread   = font_description.sdf_spread;
+    // for when the file is loaded as a dynamic font
+    descriptor.max_n_glyphs_per_page = io::file::json::has_key( json, "max_n_glyphs_per_page" )
+        ? static_cast<uint32_t>( io::file::json::read_as<int>( json, { "max_n_glyphs_per_page" } ) )
+        : 0;
+    return writer.write( descriptor_format::Kind::Font, descriptor );
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+std::optional<std::vector<uint8_t>> compile_descriptor( const json11::Json& json )
+{
+    using io::file::json::has_key;
+
+    // the kind of content is told by the keys that only its files have
+    if ( has_key( json, "texture" ) && has_key( json, "texture_format" ) )  { return compile_texture( json );   }
+    if ( has_key( json, "right" )   && has_key( json, "texture_format" ) )  { return compile_cube_map( json );  }
+    if ( has_key( json, "texture" ) && has_key( json, "width" ) )           { return compile_sprite( json );    }
+    if ( has_key( json, "shader" ) )                                        { return compile_material( json );  }
+    if ( has_key( json, "default" ) && has_key( json, "bold_itallic" ) )    { return compile_font( json );      }
+
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+std::size_t compile_descriptors( const io::Path& content_directory, const io::Path& output_directory )
+{
+    const auto directory = std::filesystem::path( content_directory.get_string() );
+    std::size_t n_compiled_descriptors { 0 };
+
+    for ( const auto& directory_entry : std::filesystem::recursive_directory_iterator( directory ) )
+    {
+        if ( !directory_entry.is_regular_file() || directory_entry.path().extension() != ".json" ) { continue; }
+
+        const auto bytes = compile_descriptor( io::file::json::read( io::Path { directory_entry.path().string() } ) );
+        if ( !bytes ) { continue; }
+
+        const auto compiled_descriptor_path = std::filesystem::path( output_directory.get_string() ) / directory_entry.path().lexically_relative( directory );
+        std::filesystem::create_directories( compiled_descriptor_path.parent_path() );
+
+        auto stream = std::ofstream( compiled_descriptor_path, std::ios::binary );
+        CHECK( stream.is_open(), "Could not create compiled descriptor: " + compiled_descriptor_path.string() );
+        stream.write( reinterpret_cast<const char*>( bytes->data() ), static_cast<std::streamsize>( bytes->size() ) );
+        CHECK( stream.good(), "Could not write compiled descriptor: " + compiled_descriptor_path.string() );
+
+        ++n_compiled_descriptors;
+    }
+
+    return n_compiled_descriptors;
+}
+
+} // namespace content
+} // namespace shake
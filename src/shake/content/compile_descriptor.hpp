@@ -0,0 +1,31 @@
+#ifndef COMPILE_DESCRIPTOR_HPP
+#define COMPILE_DESCRIPTOR_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "shake/io/file_json.hpp"
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Compiles the json of a texture, cube map, material, sprite or font file into a compiled descriptor,
+// with its enums resolved and its paths gathered in a string table, so loading it does not parse any json.
+// Returns nothing for other json files, which are left to be loaded as json.
+std::optional<std::vector<uint8_t>> compile_descriptor( const json11::Json& json );
+
+//----------------------------------------------------------------
+// Compiles all descriptors in the content directory,
+// writing them to the same relative paths in the output directory, keeping the .json extension,
+// so content that refers to them does not change.
+// Host the output directory before the content directory to load the compiled descriptors.
+// Returns the number of descriptors that were compiled.
+std::size_t compile_descriptors( const io::Path& content_directory, const io::Path& output_directory );
+
+} // namespace content
+} // namespace shake
+
+#endif // COMPILE_DESCRIPTOR_HPP
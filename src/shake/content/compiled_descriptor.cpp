@@ -0,0 +1,45 @@
+#include "compiled_descriptor.hpp"
+
+#include <string>
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+bool CompiledDescriptor::is_compiled_descriptor( const ContentBytes& bytes )
+{
+    auto magic = uint32_t { };
+    if ( bytes.size() < sizeof( magic ) ) { return false; }
+    std::memcpy( &magic, bytes.data(), sizeof( magic ) );
+    return magic == descriptor_format::magic;
+}
+
+//----------------------------------------------------------------
+CompiledDescriptor::CompiledDescriptor( ContentBytes bytes, const descriptor_format::Kind kind )
+    : m_bytes { std::move( bytes ) }
+{
+    CHECK_LE( sizeof( m_header ), m_bytes.size(), "Compiled descriptor is too short. It might be corrupted." );
+    std::memcpy( &m_header, m_bytes.data(), sizeof( m_header ) );
+
+    CHECK_EQ( m_header.magic,   descriptor_format::magic,   "Header of compiled descriptor is not as expected." );
+    CHECK_EQ( m_header.version, descriptor_format::version, "Compiled descriptor has an unsupported version, recompile it." );
+    CHECK_EQ( m_header.kind,    static_cast<uint32_t>( kind ), "Compiled descriptor is of another kind of content." );
+    CHECK_LE( sizeof( m_header ) + m_header.descriptor_size, m_bytes.size(), "Compiled descriptor is truncated." );
+    CHECK_LE( m_header.string_table_offset + m_header.string_table_size, m_bytes.size(), "Compiled descriptor is truncated." );
+}
+
+//----------------------------------------------------------------
+std::string_view CompiledDescriptor::get_string( const descriptor_format::StringRef& string_ref ) const
+{
+    CHECK_LE( uint64_t { string_ref.offset } + string_ref.size, m_header.string_table_size, "String of compiled descriptor is out of bounds." );
+    return m_bytes.as_string_view().substr( static_cast<std::size_t>( m_header.string_table_offset + string_ref.offset ), string_ref.size );
+}
+
+//----------------------------------------------------------------
+io::Path CompiledDescriptor::get_path( const descriptor_format::StringRef& string_ref ) const
+{
+    return io::Path { std::string { get_string( string_ref ) } };
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,63 @@
+#ifndef COMPILED_DESCRIPTOR_HPP
+#define COMPILED_DESCRIPTOR_HPP
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "shake/core/contracts/contracts.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/descriptor_format.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A descriptor compiled by compile_descriptors(), read straight from its bytes.
+// Strings are views into the bytes, so they are only valid for as long as the descriptor is.
+class CompiledDescriptor
+{
+public:
+    //----------------------------------------------------------------
+    // Json can't start with the magic, so this tells compiled descriptors apart from json descriptors
+    static bool is_compiled_descriptor( const ContentBytes& bytes );
+
+    //----------------------------------------------------------------
+    // Checks that the bytes are a compiled descriptor of the given kind
+    CompiledDescriptor( ContentBytes bytes, const descriptor_format::Kind kind );
+
+    //----------------------------------------------------------------
+    // Copies the descriptor out of the bytes, which might not be suitably aligned to read it in place
+    template<typename Descriptor_T>
+    Descriptor_T get_descriptor() const
+    {
+        CHECK_EQ( m_header.descriptor_size, sizeof( Descriptor_T ), "Compiled descriptor is not of the expected size." );
+        auto descriptor = Descriptor_T { };
+        std::memcpy( &descriptor, m_bytes.data() + sizeof( descriptor_format::Header ), sizeof( Descriptor_T ) );
+        return descriptor;
+    }
+
+    //----------------------------------------------------------------
+    template<typename Item_T>
+    std::vector<Item_T> get_array( const uint64_t offset, const uint32_t n_items ) const
+    {
+        CHECK_LE( offset + uint64_t { n_items } * sizeof( Item_T ), m_bytes.size(), "Compiled descriptor is truncated." );
+        auto items = std::vector<Item_T>( n_items );
+        std::memcpy( items.data(), m_bytes.data() + offset, n_items * sizeof( Item_T ) );
+        return items;
+    }
+
+    std::string_view    get_string  ( const descriptor_format::StringRef& string_ref ) const;
+    io::Path            get_path    ( const descriptor_format::StringRef& string_ref ) const;
+
+private:
+    ContentBytes                m_bytes     { };
+    descriptor_format::Header   m_header    { };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // COMPILED_DESCRIPTOR_HPP
@@ -0,0 +1,282 @@
+#include "content_archive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/content/content_id.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+//----------------------------------------------------------------
+uint64_t hash_path( std::string_view path )
+{
+    return ContentId { path.data(), path.size() }.get_hash();
+}
+
+//----------------------------------------------------------------
+uint64_t align_up( const uint64_t offset, const uint64_t alignment )
+{
+    return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+//----------------------------------------------------------------
+template<typename T>
+void write_pod( std::ofstream& stream, const T& value )
+{
+    stream.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+//----------------------------------------------------------------
+void write_padding( std::ofstream& stream, const uint64_t alignment )
+{
+    const auto position = static_cast<uint64_t>( stream.tellp() );
+    const auto n_padding_bytes = align_up( position, alignment ) - position;
+    static const char zeros[ archive_format::blob_alignment ] { };
+    stream.write( zeros, static_cast<std::streamsize>( n_padding_bytes ) );
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+std::shared_ptr<ContentArchive> ContentArchive::open( const io::Path& archive_path )
+{
+    // the constructor is private, so make_shared can't be used
+    return std::shared_ptr<ContentArchive>( new ContentArchive( archive_path ) );
+}
+
+//----------------------------------------------------------------
+ContentArchive::Mapping::Mapping( const io::Path& archive_path )
+{
+#ifdef _WIN32
+    file_handle = CreateFileA( archive_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    CHECK( file_handle != INVALID_HANDLE_VALUE, "Could not open content archive: " + archive_path.get_string() );
+
+    auto file_size = LARGE_INTEGER { };
+    if ( GetFileSizeEx( file_handle, &file_size ) )
+    {
+        size = static_cast<std::size_t>( file_size.QuadPart );
+        map_handle = CreateFileMappingA( file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    }
+    if ( map_handle != nullptr )
+    {
+        data = static_cast<const uint8_t*>( MapViewOfFile( map_handle, FILE_MAP_READ, 0, 0, 0 ) );
+    }
+
+    // the destructor does not run when the constructor throws
+    if ( data == nullptr )
+    {
+        if ( map_handle != nullptr ) { CloseHandle( map_handle ); }
+        CloseHandle( file_handle );
+    }
+#else
+    const auto file_descriptor = ::open( archive_path.c_str(), O_RDONLY );
+    CHECK( file_descriptor != -1, "Could not open content archive: " + archive_path.get_string() );
+
+    struct stat file_status { };
+    if ( fstat( file_descriptor, &file_status ) == 0 )
+    {
+        size = static_cast<std::size_t>( file_status.st_size );
+        void* const mapped = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0 );
+        if ( mapped != MAP_FAILED ) { data = static_cast<const uint8_t*>( mapped ); }
+    }
+
+    // the mapping stays valid after closing the file
+    ::close( file_descriptor );
+#endif
+
+    CHECK( data != nullptr, "Could not map content archive: " + archive_path.get_string() );
+}
+
+//----------------------------------------------------------------
+ContentArchive::Mapping::~Mapping()
+{
+#ifdef _WIN32
+    UnmapViewOfFile( data );
+    CloseHandle( map_handle );
+    CloseHandle( file_handle );
+#else
+    munmap( const_cast<uint8_t*>( data ), size );
+#endif
+}
+
+//----------------------------------------------------------------
+ContentArchive::ContentArchive( const io::Path& archive_path )
+    : m_path    { archive_path }
+    , m_mapping { archive_path }
+{
+    // a failing check unmaps the archive again, when the mapping is destroyed
+    const auto size = m_mapping.size;
+    CHECK_GE( size, sizeof( archive_format::Header ), "Content archive is too short. It might be corrupted." );
+    CHECK_EQ( get_header().magic,   archive_format::magic,      "Header of content archive is not as expected." );
+    CHECK_EQ( get_header().version, archive_format::version,    "Content archive has an unsupported version." );
+
+    // everything is bounds checked once here, so looking up files can trust the offsets
+    const auto& header = get_header();
+    CHECK_EQ( header.toc_offset % alignof( archive_format::Entry ), uint64_t { 0 }, "Table of contents of content archive is misaligned. It might be corrupted." );
+    CHECK_LE( header.toc_offset, size, "Content archive is truncated." );
+    CHECK_LE( header.n_entries, ( size - header.toc_offset ) / sizeof( archive_format::Entry ), "Content archive is truncated." );
+    CHECK_LE( header.string_table_offset, size, "Content archive is truncated." );
+    CHECK_LE( header.string_table_size, size - header.string_table_offset, "Content archive is truncated." );
+
+    const auto entries = get_entries();
+    for ( uint64_t entry_index = 0; entry_index < header.n_entries; ++entry_index )
+    {
+        const auto& entry = entries[ entry_index ];
+        CHECK_LE( entry.offset, size, "Content archive has a file outside of it. It might be corrupted." );
+        CHECK_LE( entry.size, size - entry.offset, "Content archive has a file outside of it. It might be corrupted." );
+        CHECK_LE( uint64_t { entry.path_offset } + entry.path_size, header.string_table_size, "Content archive has a path outside of its string table. It might be corrupted." );
+    }
+}
+
+//----------------------------------------------------------------
+ContentArchive::~ContentArchive() = default;
+
+//----------------------------------------------------------------
+std::optional<ContentBytes> ContentArchive::find( const io::Path& path ) const
+{
+    if ( const auto entry = find_entry( path ) )
+    {
+        return ContentBytes { shared_from_this(), m_mapping.data + entry->offset, static_cast<std::size_t>( entry->size ) };
+    }
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+std::optional<archive_format::Entry> ContentArchive::find_entry( const io::Path& path ) const
+{
+    const auto& path_str = path.get_string();
+    const auto path_hash = hash_path( path_str );
+
+    // entries are sorted by hash, and equal hashes are adjacent
+    const auto entries_begin = get_entries();
+    const auto entries_end = entries_begin + get_header().n_entries;
+    auto it = std::lower_bound( entries_begin, entries_end, path_hash, 
+        []( const archive_format::Entry& entry, const uint64_t hash ) { return entry.path_hash < hash; } );
+
+    for ( ; it != entries_end && it->path_hash == path_hash; ++it )
+    {
+        if ( get_entry_path( *it ) == path_str ) { return *it; }
+    }
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+void ContentArchive::for_each_entry( const std::function<void( std::string_view, const archive_format::Entry& )>& function ) const
+{
+    const auto entries = get_entries();
+    for ( uint64_t entry_index = 0; entry_index < get_header().n_entries; ++entry_index )
+    {
+        function( get_entry_path( entries[ entry_index ] ), entries[ entry_index ] );
+    }
+}
+
+//----------------------------------------------------------------
+const archive_format::Header& ContentArchive::get_header() const
+{
+    return *reinterpret_cast<const archive_format::Header*>( m_mapping.data );
+}
+
+//----------------------------------------------------------------
+const archive_format::Entry* ContentArchive::get_entries() const
+{
+    return reinterpret_cast<const archive_format::Entry*>( m_mapping.data + get_header().toc_offset );
+}
+
+//----------------------------------------------------------------
+std::string_view ContentArchive::get_entry_path( const archive_format::Entry& entry ) const
+{
+    const auto string_table = reinterpret_cast<const char*>( m_mapping.data + get_header().string_table_offset );
+    return std::string_view { string_table + entry.path_offset, entry.path_size };
+}
+
+//----------------------------------------------------------------
+std::size_t write_content_archive( const io::Path& content_directory, const io::Path& archive_path )
+{
+    const auto directory = std::filesystem::path( content_directory.get_string() );
+    CHECK( std::filesystem::is_directory( directory ), "Content directory does not exist: " + content_directory.get_string() );
+
+    // collect files, sorted by path first so archives are reproducible
+    auto paths = std::vector<std::string> { };
+    for ( const auto& directory_entry : std::filesystem::recursive_directory_iterator( directory ) )
+    {
+        if ( directory_entry.is_regular_file() )
+        {
+            paths.emplace_back( directory_entry.path().lexically_relative( directory ).generic_string() );
+        }
+    }
+    std::sort( std::begin( paths ), std::end( paths ) );
+
+    auto stream = std::ofstream( archive_path.get_string(), std::ios::binary );
+    CHECK( stream.is_open(), "Could not create content archive: " + archive_path.get_string() );
+
+    // the header is written last, once all offsets are known
+    auto header = archive_format::Header { archive_format::magic, archive_format::version, paths.size(), 0, 0, 0 };
+    write_pod( stream, header );
+
+    auto entries = std::vector<archive_format::Entry> { };
+    auto string_table = std::string { };
+    entries.reserve( paths.size() );
+
+    for ( const auto& path : paths )
+    {
+        auto file = std::ifstream( ( directory / path ), std::ios::binary );
+        const auto bytes = std::vector<char>( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+
+        write_padding( stream, archive_format::blob_alignment );
+        const auto offset = static_cast<uint64_t>( stream.tellp() );
+        stream.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+
+        entries.emplace_back( archive_format::Entry
+        {
+            hash_path( path ),
+            offset,
+            bytes.size(),
+            static_cast<uint32_t>( string_table.size() ),
+            static_cast<uint32_t>( path.size() )
+        } );
+        string_table += path;
+    }
+
+    header.string_table_offset = static_cast<uint64_t>( stream.tellp() );
+    header.string_table_size = string_table.size();
+    stream.write( string_table.data(), static_cast<std::streamsize>( string_table.size() ) );
+
+    // a stable sort keeps entries with colliding hashes in path order
+    std::stable_sort( std::begin( entries ), std::end( entries ), 
+        []( const archive_format::Entry& lhs, const archive_format::Entry& rhs ) { return lhs.path_hash < rhs.path_hash; } );
+
+    write_padding( stream, alignof( archive_format::Entry ) );
+    header.toc_offset = static_cast<uint64_t>( stream.tellp() );
+    for ( const auto& entry : entries )
+    {
+        write_pod( stream, entry );
+    }
+
+    stream.seekp( 0 );
+    write_pod( stream, header );
+
+    CHECK( stream.good(), "Could not write content archive: " + archive_path.get_string() );
+    return entries.size();
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,83 @@
+#ifndef CONTENT_ARCHIVE_HPP
+#define CONTENT_ARCHIVE_HPP
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_archive_format.hpp"
+#include "shake/content/content_bytes.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A memory mapped content archive.
+// Files are read in place, without copying them out of the archive.
+// Create archives from a content directory using write_content_archive().
+class ContentArchive : public std::enable_shared_from_this<ContentArchive>
+{
+public:
+    static std::shared_ptr<ContentArchive> open( const io::Path& archive_path );
+
+    ~ContentArchive();
+    NON_COPYABLE( ContentArchive )
+
+    //----------------------------------------------------------------
+    // Returns a view of the file with the given content path, if the archive contains it.
+    // The view keeps the archive mapped.
+    std::optional<ContentBytes> find( const io::Path& path ) const;
+
+    //----------------------------------------------------------------
+    // Returns the entry of the file with the given content path, if the archive contains it,
+    // for example to read files in the order they are stored in
+    std::optional<archive_format::Entry> find_entry( const io::Path& path ) const;
+
+    //----------------------------------------------------------------
+    // Calls the function with the content path and entry of every file in the archive
+    void for_each_entry( const std::function<void( std::string_view, const archive_format::Entry& )>& function ) const;
+
+    inline const io::Path& get_path() const { return m_path; }
+
+private:
+    explicit ContentArchive( const io::Path& archive_path );
+
+    const archive_format::Header&   get_header()    const;
+    const archive_format::Entry*    get_entries()   const;
+    std::string_view                get_entry_path( const archive_format::Entry& entry ) const;
+
+private:
+    //----------------------------------------------------------------
+    // The mapped archive file, unmapped when destroyed.
+    // The archive checks its contents after constructing the mapping,
+    // so an archive that fails a check is still unmapped.
+    struct Mapping
+    {
+        explicit Mapping( const io::Path& archive_path );
+        ~Mapping();
+        NON_COPYABLE( Mapping )
+
+        const uint8_t*  data            { nullptr };
+        std::size_t     size            { 0 };
+        void*           file_handle     { nullptr };
+        void*           map_handle      { nullptr };
+    };
+
+private:
+    io::Path        m_path          { };
+    Mapping         m_mapping;
+};
+
+//----------------------------------------------------------------
+// Packs all files in the content directory into a single archive.
+// Returns the number of files that were packed.
+std::size_t write_content_archive( const io::Path& content_directory, const io::Path& archive_path );
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_ARCHIVE_HPP
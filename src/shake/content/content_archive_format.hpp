@@ -0,0 +1,52 @@
+#ifndef CONTENT_ARCHIVE_FORMAT_HPP
+#define CONTENT_ARCHIVE_FORMAT_HPP
+
+#include <cstdint>
+
+namespace shake {
+namespace content {
+namespace archive_format {
+
+//----------------------------------------------------------------
+// Layout of a content archive (.shka):
+//
+//     Header
+//     file blobs, each aligned to blob_alignment
+//     string table, holding the content paths of all files
+//     table of contents, an Entry per file, sorted by path hash
+//
+// All values are little endian.
+// Archives are memory mapped and read in place,
+// so these structs must not contain any implicit padding.
+
+constexpr uint32_t magic            = 0x414b4853; // *reinterpret_cast<const uint32_t*>( "SHKA" );
+constexpr uint32_t version          = 1;
+constexpr uint64_t blob_alignment   = 64;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t n_entries;
+    uint64_t toc_offset;
+    uint64_t string_table_offset;
+    uint64_t string_table_size;
+};
+
+struct Entry
+{
+    uint64_t path_hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t path_offset;
+    uint32_t path_size;
+};
+
+static_assert( sizeof( Header ) == 40, "Unexpected padding in archive header." );
+static_assert( sizeof( Entry  ) == 32, "Unexpected padding in archive entry."  );
+
+} // namespace archive_format
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_ARCHIVE_FORMAT_HPP
@@ -0,0 +1,32 @@
+#include "content_budget.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+thread_local ContentSizeScope* current_scope { nullptr };
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+ContentSizeScope::ContentSizeScope()
+    : m_previous { current_scope }
+{
+    current_scope = this;
+}
+
+//----------------------------------------------------------------
+ContentSizeScope::~ContentSizeScope()
+{
+    current_scope = m_previous;
+}
+
+//----------------------------------------------------------------
+void ContentSizeScope::report( const std::size_t n_bytes )
+{
+    if ( current_scope != nullptr ) { current_scope->m_n_bytes += n_bytes; }
+}
+
+} // namespace content
+} // namespace shake
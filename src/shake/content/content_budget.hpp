@@ -0,0 +1,61 @@
+#ifndef CONTENT_BUDGET_HPP
+#define CONTENT_BUDGET_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_id.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A budget of 0 means the content is not limited
+struct ContentBudgetStatistics
+{
+    std::size_t n_bytes     { };
+    std::size_t budget      { };
+    std::size_t n_entries   { };
+    std::size_t n_evictions { };
+};
+
+//----------------------------------------------------------------
+// Loaders report the estimated resident size of the content they load,
+// such as the pixels of a texture, to the innermost scope on the calling thread.
+// The content manager opens a scope around every load, 
+// so nested loads report to their own content.
+class ContentSizeScope
+{
+public:
+    ContentSizeScope();
+    ~ContentSizeScope();
+    NON_COPYABLE( ContentSizeScope )
+
+    //----------------------------------------------------------------
+    // Does nothing outside of a scope
+    static void report( const std::size_t n_bytes );
+
+    inline std::size_t get_n_bytes() const { return m_n_bytes; }
+
+private:
+    std::size_t         m_n_bytes   { 0 };
+    ContentSizeScope*   m_previous  { nullptr };
+};
+
+//----------------------------------------------------------------
+// Cached content that nothing outside of the cache refers to, and could be evicted
+struct EvictionCandidate
+{
+    ContentId   id          { };
+    io::Path    path        { };
+    uint64_t    last_use    { };
+    std::size_t n_bytes     { };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_BUDGET_HPP
@@ -0,0 +1,90 @@
+#include "content_bundle.hpp"
+
+#include <filesystem>
+#include <set>
+#include <utility>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+std::vector<BundleEntry> parse_bundle_manifest( const json11::Json& manifest )
+{
+    CHECK( manifest.is_object(), "Bundle manifest should map type names to lists of paths." );
+
+    auto entries    = std::vector<BundleEntry> { };
+    auto listed     = std::set<std::pair<std::string, std::string>> { };
+    for ( const auto& [ type_name, paths ] : manifest.object_items() )
+    {
+        CHECK( paths.is_array(), "Bundle manifest should list the paths of type " + type_name + " in an array." );
+        for ( const auto& path : paths.array_items() )
+        {
+            CHECK( path.is_string(), "Bundle manifest contains a path of type " + type_name + " that is not a string." );
+            if ( listed.emplace( type_name, path.string_value() ).second )
+            {
+                entries.emplace_back( BundleEntry { type_name, io::Path { path.string_value() } } );
+            }
+        }
+    }
+    return entries;
+}
+
+//----------------------------------------------------------------
+uint64_t get_file_size( const io::Path& full_path )
+{
+    auto error = std::error_code { };
+    const auto file_size = std::filesystem::file_size( full_path.get_string(), error );
+    return error ? 0 : static_cast<uint64_t>( file_size );
+}
+
+//----------------------------------------------------------------
+float BundleProgress::get_fraction() const
+{
+    if ( n_items == 0 ) { return 1.f; }
+
+    // the sizes might be unknown, such as for empty files
+    if ( n_bytes == 0 ) { return static_cast<float>( n_loaded_items + n_failed_items ) / n_items; }
+
+    return static_cast<float>( static_cast<double>( n_loaded_bytes ) / n_bytes );
+}
+
+//----------------------------------------------------------------
+void BundleLoad::add_item( const ItemStateQuery& query, const uint64_t n_bytes )
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    m_items.emplace_back( Item { query, n_bytes } );
+}
+
+//----------------------------------------------------------------
+BundleProgress BundleLoad::get_progress() const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+
+    auto progress = BundleProgress { };
+    progress.n_items = m_items.size();
+    for ( auto& item : m_items )
+    {
+        if ( item.state == ItemState::Loading ) { item.state = item.query(); }
+
+        progress.n_bytes += item.n_bytes;
+        switch ( item.state )
+        {
+        case ItemState::Loading:
+            break;
+        case ItemState::Loaded:
+            ++progress.n_loaded_items;
+            progress.n_loaded_bytes += item.n_bytes;
+            break;
+        case ItemState::Failed:
+            ++progress.n_failed_items;
+            progress.n_loaded_bytes += item.n_bytes;
+            break;
+        }
+    }
+    return progress;
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,118 @@
+#ifndef CONTENT_BUNDLE_HPP
+#define CONTENT_BUNDLE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/file_json.hpp"
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A bundle manifest lists content that is loaded and unloaded together,
+// such as everything a level needs.
+// Content is listed under the name its type was registered with:
+//
+//     {
+//         "texture":  [ "textures/grass.json", "textures/rock.json" ],
+//         "material": [ "materials/terrain.json" ]
+//     }
+struct BundleEntry
+{
+    std::string type_name   { };
+    io::Path    path        { };
+};
+
+//----------------------------------------------------------------
+// Entries that are listed more than once are only returned once
+std::vector<BundleEntry> parse_bundle_manifest( const json11::Json& manifest );
+
+//----------------------------------------------------------------
+// Where the file of some content is stored.
+// Bundles read their files in order of location,
+// so each archive and directory is read front to back.
+struct ContentLocation
+{
+    // the archive that hosts the file, or the file itself
+    std::string source      { };
+    uint64_t    offset      { };
+    uint64_t    n_bytes     { };
+
+    inline bool operator<( const ContentLocation& other ) const
+    {
+        return std::tie( source, offset ) < std::tie( other.source, other.offset );
+    }
+};
+
+//----------------------------------------------------------------
+// The size of a loose file, or 0 if it can't be determined
+uint64_t get_file_size( const io::Path& full_path );
+
+//----------------------------------------------------------------
+struct BundleProgress
+{
+    std::size_t n_items         { };
+    std::size_t n_loaded_items  { };
+    std::size_t n_failed_items  { };
+    uint64_t    n_bytes         { };
+    uint64_t    n_loaded_bytes  { };
+
+    //----------------------------------------------------------------
+    // Weighted by file size, as larger files take longer to read and decode.
+    // Failed items count as done, so the fraction still reaches 1.
+    float get_fraction() const;
+
+    inline bool is_done() const { return n_loaded_items + n_failed_items == n_items; }
+};
+
+//----------------------------------------------------------------
+// The progress of loading a bundle using ContentManager::preload_bundle().
+// Items are done once their content is uploaded by ContentManager::process_uploads(),
+// so poll the progress between frames, for example from a loading screen.
+// The queries hold on to the loaded content,
+// so it is not evicted to meet content budgets while the bundle is loaded.
+class BundleLoad
+{
+public:
+    enum class ItemState
+    {
+        Loading,
+        Loaded,
+        Failed
+    };
+
+    using ItemStateQuery = std::function<ItemState()>;
+
+    BundleLoad() = default;
+    NON_COPYABLE( BundleLoad )
+
+    //----------------------------------------------------------------
+    void add_item( const ItemStateQuery& query, const uint64_t n_bytes );
+
+    //----------------------------------------------------------------
+    BundleProgress get_progress() const;
+
+private:
+    struct Item
+    {
+        ItemStateQuery  query   { };
+        uint64_t        n_bytes { };
+        // items are only queried until they are done
+        ItemState       state   { ItemState::Loading };
+    };
+
+    mutable std::mutex          m_mutex { };
+    mutable std::vector<Item>   m_items { };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_BUNDLE_HPP
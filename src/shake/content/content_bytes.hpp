@@ -0,0 +1,74 @@
+#ifndef CONTENT_BYTES_HPP
+#define CONTENT_BYTES_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A read only view of the bytes of a content file,
+// that keeps whatever stores the bytes alive.
+// For files in a hosted archive this is a view into the memory mapped archive,
+// for loose files it owns a buffer the file was read into.
+class ContentBytes
+{
+public:
+    ContentBytes() = default;
+
+    ContentBytes( std::shared_ptr<const void> owner, const uint8_t* data, const std::size_t size )
+        : m_owner   { std::move( owner ) }
+        , m_data    { data }
+        , m_size    { size }
+    { }
+
+    //----------------------------------------------------------------
+    // Takes ownership of a contiguous container of bytes
+    template<typename Container_T>
+    static ContentBytes make_owning( Container_T&& bytes )
+    {
+        const auto owner = std::make_shared<std::decay_t<Container_T>>( std::forward<Container_T>( bytes ) );
+        return ContentBytes { owner, reinterpret_cast<const uint8_t*>( owner->data() ), owner->size() };
+    }
+
+    inline const uint8_t*   data()  const { return m_data; }
+    inline std::size_t      size()  const { return m_size; }
+    inline bool             empty() const { return m_size == 0; }
+
+    inline const uint8_t*   begin() const { return m_data; }
+    inline const uint8_t*   end()   const { return m_data + m_size; }
+
+    //----------------------------------------------------------------
+    inline std::string_view as_string_view() const
+    {
+        return std::string_view { reinterpret_cast<const char*>( m_data ), m_size };
+    }
+
+    //----------------------------------------------------------------
+    // A pointer to the bytes, that shares their owner
+    inline std::shared_ptr<const uint8_t> share_data() const
+    {
+        return std::shared_ptr<const uint8_t> { m_owner, m_data };
+    }
+
+    //----------------------------------------------------------------
+    // A view of a part of the bytes, sharing their owner
+    inline ContentBytes get_sub_bytes( const std::size_t offset, const std::size_t size ) const
+    {
+        return ContentBytes { m_owner, m_data + offset, size };
+    }
+
+private:
+    std::shared_ptr<const void> m_owner { };
+    const uint8_t*              m_data  { nullptr };
+    std::size_t                 m_size  { 0 };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_BYTES_HPP
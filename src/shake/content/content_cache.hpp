@@ -0,0 +1,383 @@
+#ifndef CONTENT_CACHE_HPP
+#define CONTENT_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "shake/core/contracts/contracts.hpp"
+#include "shake/core/macros/macro_debug_only.hpp"
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_budget.hpp"
+#include "shake/content/content_id.hpp"
+#include "shake/content/flat_content_table.hpp"
+
+namespace shake {
+namespace content {
+
+template<typename Content_T>
+using ContentFuture = std::shared_future<std::shared_ptr<Content_T>>;
+
+//----------------------------------------------------------------
+// The part of a content cache that does not depend on the type of content,
+// so caches of all types can be kept within a budget together.
+// Entries remember when they were last used, in ticks,
+// which the content manager advances once per call to process_uploads().
+class ContentCacheBase
+{
+public:
+    ContentCacheBase() = default;
+    virtual ~ContentCacheBase() = default;
+    NON_COPYABLE( ContentCacheBase )
+
+    //----------------------------------------------------------------
+    // Adds an eviction candidate for all content that is only referred to by the cache
+    virtual void collect_eviction_candidates( std::vector<EvictionCandidate>& candidates ) const = 0;
+
+    //----------------------------------------------------------------
+    // Erases the content, unless something started referring to it since it was collected
+    virtual bool evict( const ContentId& id ) = 0;
+
+    virtual std::size_t get_n_entries() const = 0;
+
+    //----------------------------------------------------------------
+    // Evicts unreferenced content, least recently used first, until at most max_n_bytes are used.
+    // Returns the paths of the evicted content.
+    std::vector<io::Path> evict_to( const std::size_t max_n_bytes )
+    {
+        auto evicted_paths = std::vector<io::Path> { };
+        if ( m_n_bytes <= max_n_bytes ) { return evicted_paths; }
+
+        auto candidates = std::vector<EvictionCandidate> { };
+        collect_eviction_candidates( candidates );
+        std::sort( candidates.begin(), candidates.end(), []( const EvictionCandidate& a, const EvictionCandidate& b ) { return a.last_use < b.last_use; } );
+
+        for ( const auto& candidate : candidates )
+        {
+            if ( m_n_bytes <= max_n_bytes ) { break; }
+            if ( evict( candidate.id ) ) { evicted_paths.emplace_back( candidate.path ); }
+        }
+        return evicted_paths;
+    }
+
+    //----------------------------------------------------------------
+    // A budget of 0 means the cache is not limited
+    inline void         set_budget( const std::size_t budget )  { m_budget = budget; }
+    inline std::size_t  get_budget()    const                   { return m_budget; }
+    inline std::size_t  get_n_bytes()   const                   { return m_n_bytes; }
+    inline void         advance_use_tick()                      { ++m_use_tick; }
+
+    //----------------------------------------------------------------
+    ContentBudgetStatistics get_budget_statistics() const
+    {
+        return ContentBudgetStatistics { m_n_bytes, m_budget, get_n_entries(), m_n_evictions };
+    }
+
+protected:
+    std::atomic<std::size_t>    m_n_bytes       { 0 };
+    std::atomic<std::size_t>    m_budget        { 0 };
+    std::atomic<std::size_t>    m_n_evictions   { 0 };
+    std::atomic<uint64_t>       m_use_tick      { 0 };
+};
+
+//----------------------------------------------------------------
+// A cache of loaded content that can be used from multiple threads.
+// Content is keyed by content id, and ids are spread over shards by their hash,
+// so threads working on different content rarely contend for the same lock.
+// Concurrent loads of the same path are deduplicated:
+// the first caller loads, while the others wait for its result.
+template<typename Content_T>
+class ContentCache : public ContentCacheBase
+{
+public:
+    using ContentPtr    = std::shared_ptr<Content_T>;
+    using Future        = ContentFuture<Content_T>;
+    using Loader        = std::function<ContentPtr()>;
+
+    ContentCache() = default;
+    NON_COPYABLE( ContentCache )
+
+    //----------------------------------------------------------------
+    bool has( const ContentId& id ) const
+    {
+        const auto& shard = get_shard( id );
+        const auto lock = std::shared_lock<std::shared_mutex> { shard.mutex };
+        return shard.entries.find( id ) != nullptr;
+    }
+
+    bool has( const io::Path& path ) const { return has( ContentId { path } ); }
+
+    //----------------------------------------------------------------
+    // Content is returned by value, so it stays alive if it is evicted, erased or replaced afterwards
+    ContentPtr get( const ContentId& id ) const
+    {
+        const auto content = find( id );
+        CHECK( content != nullptr, "Map does not have expected key" );
+        return content;
+    }
+
+    ContentPtr get( const io::Path& path ) const { return get( ContentId { path } ); }
+
+    //----------------------------------------------------------------
+    // Returns nullptr if the content is not cached
+    ContentPtr find( const ContentId& id ) const
+    {
+        const auto& shard = get_shard( id );
+        const auto lock = std::shared_lock<std::shared_mutex> { shard.mutex };
+        const auto entry = shard.entries.find( id );
+        if ( entry == nullptr ) { return nullptr; }
+        mark_used( **entry );
+        return ( *entry )->content;
+    }
+
+    ContentPtr find( const io::Path& path ) const { return find( ContentId { path } ); }
+
+    //----------------------------------------------------------------
+    // Loads the content if it is not cached yet.
+    // If another thread is already loading the same path, this waits for it instead.
+    // The loader reports the size of the content to a ContentSizeScope.
+    ContentPtr get_or_load( const io::Path& path, const Loader& loader )
+    {
+        const auto id = ContentId { path };
+        auto& shard = get_shard( id );
+
+        {
+            const auto lock = std::shared_lock<std::shared_mutex> { shard.mutex };
+            if ( const auto entry = shard.entries.find( id ) ) 
+            { 
+                mark_used( **entry );
+                return ( *entry )->content; 
+            }
+        }
+
+        auto promise = std::promise<ContentPtr> { };
+        auto future = Future { };
+        {
+            const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+            if ( const auto entry = shard.entries.find( id ) ) { return ( *entry )->content; }
+
+            const auto loading_it = shard.loading.find( path );
+            if ( loading_it != shard.loading.end() ) 
+            { 
+                future = loading_it->second; 
+            }
+            else
+            {
+                shard.loading.emplace( path, promise.get_future().share() );
+            }
+        }
+
+        // someone else is loading, wait for them.
+        // Their content is taken from the future, as it might have been evicted from the cache already.
+        if ( future.valid() )
+        {
+            // rethrows if their load failed
+            return future.get();
+        }
+
+        try
+        {
+            const auto size_scope = ContentSizeScope { };
+            const auto content = loader();
+            const auto cached_content = insert( path, content, size_scope.get_n_bytes() );
+            promise.set_value( cached_content );
+            return cached_content;
+        }
+        catch ( ... )
+        {
+            {
+                const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+                shard.loading.erase( path );
+            }
+            promise.set_exception( std::current_exception() );
+            throw;
+        }
+    }
+
+    //----------------------------------------------------------------
+    // Stores the content, unless the path is already cached.
+    // Returns whatever is cached for the path afterwards.
+    ContentPtr insert( const io::Path& path, const ContentPtr& content, const std::size_t n_bytes = 0 )
+    {
+        const auto id = ContentId { path };
+        auto& shard = get_shard( id );
+        const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+        shard.loading.erase( path );
+
+        const auto [ entry, is_inserted ] = shard.entries.emplace( id, make_entry( path, content, n_bytes ) );
+        if ( is_inserted ) { m_n_bytes += n_bytes; }
+        DEBUG_ONLY( CHECK( ( *entry )->path == path, "Content id collision between " + path.get_string() + " and " + ( *entry )->path.get_string() ) );
+        return ( *entry )->content;
+    }
+
+    //----------------------------------------------------------------
+    // Stores the content, replacing whatever is cached for the path.
+    // Content obtained before keeps referring to the old content,
+    // get it again to use the new content.
+    ContentPtr replace( const io::Path& path, const ContentPtr& content, const std::size_t n_bytes = 0 )
+    {
+        const auto id = ContentId { path };
+        auto& shard = get_shard( id );
+        const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+
+        if ( const auto entry = shard.entries.find( id ) )
+        {
+            m_n_bytes -= ( *entry )->n_bytes;
+            m_n_bytes += n_bytes;
+            ( *entry )->content = content;
+            ( *entry )->n_bytes = n_bytes;
+            mark_used( **entry );
+            return ( *entry )->content;
+        }
+        const auto [ entry, is_inserted ] = shard.entries.emplace( id, make_entry( path, content, n_bytes ) );
+        m_n_bytes += n_bytes;
+        return ( *entry )->content;
+    }
+
+    //----------------------------------------------------------------
+    bool erase( const io::Path& path )
+    {
+        const auto id = ContentId { path };
+        auto& shard = get_shard( id );
+        const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+        return erase_locked( shard, id );
+    }
+
+    //----------------------------------------------------------------
+    void collect_eviction_candidates( std::vector<EvictionCandidate>& candidates ) const override
+    {
+        for ( const auto& shard : m_shards )
+        {
+            const auto lock = std::shared_lock<std::shared_mutex> { shard.mutex };
+            shard.entries.for_each( [ &candidates ]( const ContentId& id, const std::unique_ptr<Entry>& entry )
+            {
+                if ( entry->content.use_count() == 1 )
+                {
+                    candidates.emplace_back( EvictionCandidate { id, entry->path, entry->last_use.load( std::memory_order_relaxed ), entry->n_bytes } );
+                }
+            } );
+        }
+    }
+
+    //----------------------------------------------------------------
+    bool evict( const ContentId& id ) override
+    {
+        auto& shard = get_shard( id );
+        const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+        const auto entry = shard.entries.find( id );
+        if ( entry == nullptr || ( *entry )->content.use_count() != 1 ) { return false; }
+
+        ++m_n_evictions;
+        return erase_locked( shard, id );
+    }
+
+    //----------------------------------------------------------------
+    std::size_t get_n_entries() const override
+    {
+        std::size_t n_entries { 0 };
+        for ( const auto& shard : m_shards )
+        {
+            const auto lock = std::shared_lock<std::shared_mutex> { shard.mutex };
+            n_entries += shard.entries.get_size();
+        }
+        return n_entries;
+    }
+
+    //----------------------------------------------------------------
+    // Asynchronous loads are tracked separately from synchronous ones.
+    // A synchronous load never waits on an asynchronous one,
+    // because the latter might need the waiting thread to process its upload.
+    // Registers the given future, unless one was already pending for the path.
+    // Returns the pending future, and whether it is the given one.
+    std::pair<Future, bool> emplace_pending( const io::Path& path, const Future& future )
+    {
+        auto& shard = get_shard( ContentId { path } );
+        const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+        const auto result = shard.pending.emplace( path, future );
+        return { result.first->second, result.second };
+    }
+
+    //----------------------------------------------------------------
+    void erase_pending( const io::Path& path )
+    {
+        auto& shard = get_shard( ContentId { path } );
+        const auto lock = std::unique_lock<std::shared_mutex> { shard.mutex };
+        shard.pending.erase( path );
+    }
+
+private:
+    // Entries are stored by pointer, so references to their content
+    // survive the table moving its slots around
+    struct Entry
+    {
+        io::Path                        path        { };
+        ContentPtr                      content     { };
+        std::size_t                     n_bytes     { };
+        // Written while only holding a shared lock
+        mutable std::atomic<uint64_t>   last_use    { };
+    };
+
+    struct Shard
+    {
+        mutable std::shared_mutex                   mutex       { };
+        FlatContentTable<std::unique_ptr<Entry>>    entries     { };
+        std::map<io::Path, Future>                  loading     { };
+        std::map<io::Path, Future>                  pending     { };
+    };
+
+    static constexpr std::size_t n_shards = 16;
+
+    //----------------------------------------------------------------
+    std::unique_ptr<Entry> make_entry( const io::Path& path, const ContentPtr& content, const std::size_t n_bytes ) const
+    {
+        return std::unique_ptr<Entry>( new Entry { path, content, n_bytes, m_use_tick.load( std::memory_order_relaxed ) } );
+    }
+
+    //----------------------------------------------------------------
+    void mark_used( const Entry& entry ) const
+    {
+        entry.last_use.store( m_use_tick.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    }
+
+    //----------------------------------------------------------------
+    bool erase_locked( Shard& shard, const ContentId& id )
+    {
+        const auto entry = shard.entries.find( id );
+        if ( entry == nullptr ) { return false; }
+        m_n_bytes -= ( *entry )->n_bytes;
+        return shard.entries.erase( id );
+    }
+
+    //----------------------------------------------------------------
+    // The tables index their slots using the low bits of the hash,
+    // so the high bits select the shard
+    Shard& get_shard( const ContentId& id )
+    {
+        return m_shards[ ( id.get_hash() >> 32 ) % n_shards ];
+    }
+
+    //----------------------------------------------------------------
+    const Shard& get_shard( const ContentId& id ) const
+    {
+        return m_shards[ ( id.get_hash() >> 32 ) % n_shards ];
+    }
+
+private:
+    std::array<Shard, n_shards> m_shards;
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_CACHE_HPP
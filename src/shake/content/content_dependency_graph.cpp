@@ -0,0 +1,153 @@
+#include "content_dependency_graph.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+// The content that is being loaded on this thread, innermost last
+thread_local std::vector<io::Path> dependency_scopes { };
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+void ContentDependencyGraph::add_dependency( const io::Path& dependent, const io::Path& dependency )
+{
+    if ( dependent == dependency ) { return; }
+
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    m_dependencies[ dependent ].insert( dependency );
+    m_dependents[ dependency ].insert( dependent );
+}
+
+//----------------------------------------------------------------
+void ContentDependencyGraph::clear_dependencies( const io::Path& dependent )
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    const auto it = m_dependencies.find( dependent );
+    if ( it == m_dependencies.end() ) { return; }
+
+    for ( const auto& dependency : it->second )
+    {
+        const auto dependents_it = m_dependents.find( dependency );
+        dependents_it->second.erase( dependent );
+        if ( dependents_it->second.empty() ) { m_dependents.erase( dependents_it ); }
+    }
+    m_dependencies.erase( it );
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> ContentDependencyGraph::get_dependencies( const io::Path& path ) const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    const auto it = m_dependencies.find( path );
+    return it != m_dependencies.end() ? std::vector<io::Path>( it->second.begin(), it->second.end() ) : std::vector<io::Path> { };
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> ContentDependencyGraph::get_dependents( const io::Path& path ) const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    const auto it = m_dependents.find( path );
+    return it != m_dependents.end() ? std::vector<io::Path>( it->second.begin(), it->second.end() ) : std::vector<io::Path> { };
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> ContentDependencyGraph::get_transitive_dependencies( const io::Path& path ) const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    return get_reachable( m_dependencies, path );
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> ContentDependencyGraph::get_transitive_dependents( const io::Path& path ) const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    return get_reachable( m_dependents, path );
+}
+
+//----------------------------------------------------------------
+// A depth first search that adds paths once all of their dependencies have been added
+std::vector<io::Path> ContentDependencyGraph::get_load_order( const std::vector<io::Path>& paths ) const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+
+    auto load_order = std::vector<io::Path> { };
+    auto visited    = std::set<io::Path> { };
+    auto visiting   = std::set<io::Path> { };
+
+    const std::function<void( const io::Path& )> visit = [ & ]( const io::Path& path )
+    {
+        if ( visited.count( path ) != 0 ) { return; }
+        CHECK( visiting.count( path ) == 0, "Content depends on itself: " + path.get_string() );
+        visiting.insert( path );
+
+        const auto it = m_dependencies.find( path );
+        if ( it != m_dependencies.end() )
+        {
+            for ( const auto& dependency : it->second ) { visit( dependency ); }
+        }
+
+        visiting.erase( path );
+        visited.insert( path );
+        load_order.emplace_back( path );
+    };
+
+    for ( const auto& path : paths ) { visit( path ); }
+    return load_order;
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> ContentDependencyGraph::get_reachable( const Edges& edges, const io::Path& path )
+{
+    auto reachable  = std::vector<io::Path> { };
+    auto visited    = std::set<io::Path> { path };
+    auto to_visit   = std::vector<io::Path> { path };
+
+    while ( !to_visit.empty() )
+    {
+        const auto current = to_visit.back();
+        to_visit.pop_back();
+
+        const auto it = edges.find( current );
+        if ( it == edges.end() ) { continue; }
+        for ( const auto& next : it->second )
+        {
+            if ( visited.insert( next ).second )
+            {
+                reachable.emplace_back( next );
+                to_visit.emplace_back( next );
+            }
+        }
+    }
+    return reachable;
+}
+
+//----------------------------------------------------------------
+DependencyScope::DependencyScope( const std::optional<io::Path>& path )
+{
+    if ( !path ) { return; }
+    dependency_scopes.emplace_back( *path );
+    m_is_pushed = true;
+}
+
+//----------------------------------------------------------------
+DependencyScope::~DependencyScope()
+{
+    if ( m_is_pushed ) { dependency_scopes.pop_back(); }
+}
+
+//----------------------------------------------------------------
+std::optional<io::Path> DependencyScope::get_current()
+{
+    if ( dependency_scopes.empty() ) { return std::nullopt; }
+    return dependency_scopes.back();
+}
+
+} // namespace content
+} // namespace shake
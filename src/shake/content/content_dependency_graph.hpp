@@ -0,0 +1,83 @@
+#ifndef CONTENT_DEPENDENCY_GRAPH_HPP
+#define CONTENT_DEPENDENCY_GRAPH_HPP
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Records which content, or plain files such as images, other content was loaded from.
+// For example, a material depends on its program and textures, 
+// and a texture depends on its image file.
+// Nodes are content paths, and can be used from multiple threads.
+class ContentDependencyGraph
+{
+public:
+    ContentDependencyGraph() = default;
+    NON_COPYABLE( ContentDependencyGraph )
+
+    //----------------------------------------------------------------
+    void add_dependency( const io::Path& dependent, const io::Path& dependency );
+
+    //----------------------------------------------------------------
+    // Forgets what the content depends on, for example before it is loaded again.
+    // What depends on the content is kept.
+    void clear_dependencies( const io::Path& dependent );
+
+    //----------------------------------------------------------------
+    // The direct dependencies and dependents
+    std::vector<io::Path> get_dependencies  ( const io::Path& path ) const;
+    std::vector<io::Path> get_dependents    ( const io::Path& path ) const;
+
+    //----------------------------------------------------------------
+    // Everything that is reachable through dependencies, or dependents, excluding the path itself
+    std::vector<io::Path> get_transitive_dependencies   ( const io::Path& path ) const;
+    std::vector<io::Path> get_transitive_dependents     ( const io::Path& path ) const;
+
+    //----------------------------------------------------------------
+    // The paths and all of their transitive dependencies, 
+    // ordered such that every path comes after its dependencies
+    std::vector<io::Path> get_load_order( const std::vector<io::Path>& paths ) const;
+
+private:
+    using Edges = std::map<io::Path, std::set<io::Path>>;
+
+    static std::vector<io::Path> get_reachable( const Edges& edges, const io::Path& path );
+
+private:
+    mutable std::mutex  m_mutex         { };
+    Edges               m_dependencies  { };
+    Edges               m_dependents    { };
+};
+
+//----------------------------------------------------------------
+// Marks the content that is being loaded on the calling thread, for as long as the scope lives.
+// Content and files that are requested from the content manager within the scope
+// are recorded as dependencies of it. Scopes nest, as loads do.
+class DependencyScope
+{
+public:
+    explicit DependencyScope( const std::optional<io::Path>& path );
+    ~DependencyScope();
+    NON_COPYABLE( DependencyScope )
+
+    //----------------------------------------------------------------
+    // The content that is being loaded on the calling thread, if any
+    static std::optional<io::Path> get_current();
+
+private:
+    bool m_is_pushed { false };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_DEPENDENCY_GRAPH_HPP
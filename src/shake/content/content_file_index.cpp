@@ -0,0 +1,153 @@
+#include "content_file_index.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+
+#include "shake/core/log.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+void ContentFileIndex::invalidate
+( 
+    const std::vector<io::Path>&                        content_directories, 
+    const std::vector<std::shared_ptr<ContentArchive>>& content_archives 
+)
+{
+    const auto lock = std::unique_lock<std::shared_mutex> { m_mutex };
+    m_content_directories = content_directories;
+    m_content_archives = content_archives;
+    m_is_dirty = true;
+}
+
+//----------------------------------------------------------------
+std::optional<io::Path> ContentFileIndex::find( const io::Path& path )
+{
+    ++m_n_lookups;
+    // most paths are normal already, and are looked up as they are, without building a key
+    const auto& path_str = path.get_string();
+    const auto normal_path = is_normal( path_str ) ? std::nullopt : std::optional<std::string> { to_key( path_str ) };
+    const auto& key = normal_path ? *normal_path : path_str;
+
+    auto lock = std::shared_lock<std::shared_mutex> { m_mutex };
+    if ( m_is_dirty )
+    {
+        lock.unlock();
+        {
+            const auto rebuild_lock = std::unique_lock<std::shared_mutex> { m_mutex };
+            if ( m_is_dirty ) { rebuild(); }
+        }
+        lock.lock();
+    }
+
+    const auto it = m_files.find( key );
+    if ( it == m_files.end() ) { return std::nullopt; }
+
+    ++m_n_hits;
+    m_n_stats_saved += it->second.directory_index + 1;
+    return it->second.full_path;
+}
+
+//----------------------------------------------------------------
+FileIndexStatistics ContentFileIndex::get_statistics() const
+{
+    auto statistics = FileIndexStatistics { };
+    statistics.n_rebuilds       = m_n_rebuilds;
+    statistics.n_lookups        = m_n_lookups;
+    statistics.n_hits           = m_n_hits;
+    statistics.n_misses         = statistics.n_lookups - statistics.n_hits;
+    statistics.n_stats_saved    = m_n_stats_saved;
+    {
+        const auto lock = std::shared_lock<std::shared_mutex> { m_mutex };
+        statistics.n_files      = m_files.size();
+    }
+    return statistics;
+}
+
+//----------------------------------------------------------------
+// Normal paths use forward slashes, and have no empty, . or .. components
+bool ContentFileIndex::is_normal( const std::string& path )
+{
+    if ( path.empty() || path.find( '\\' ) != std::string::npos ) { return false; }
+
+    std::size_t component_start { 0 };
+    while ( component_start <= path.size() )
+    {
+        const auto component_end = std::min( path.find( '/', component_start ), path.size() );
+        const auto component = std::string_view { path }.substr( component_start, component_end - component_start );
+        if ( component.empty() || component == "." || component == ".." ) { return false; }
+        component_start = component_end + 1;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+std::string ContentFileIndex::to_key( const std::string& path )
+{
+    // "textures/a.png", "./textures/a.png" and "textures\a.png" refer to the same content
+    return std::filesystem::path( path ).lexically_normal().generic_string();
+}
+
+//----------------------------------------------------------------
+void ContentFileIndex::rebuild()
+{
+    m_files.clear();
+
+    for ( std::size_t directory_index = 0; directory_index < m_content_directories.size(); ++directory_index )
+    {
+        const auto archive_it = std::find_if( std::begin( m_content_archives ), std::end( m_content_archives ),
+            [ & ]( const auto& content_archive ) { return content_archive->get_path() == m_content_directories[ directory_index ]; } );
+
+        if ( archive_it != std::end( m_content_archives ) ) { index_archive( directory_index, **archive_it ); }
+        else                                                { index_directory( directory_index ); }
+    }
+
+    m_is_dirty = false;
+    ++m_n_rebuilds;
+}
+
+//----------------------------------------------------------------
+void ContentFileIndex::index_directory( const std::size_t directory_index )
+{
+    const auto directory = std::filesystem::path( m_content_directories[ directory_index ].get_string() );
+
+    auto error = std::error_code { };
+    auto it = std::filesystem::recursive_directory_iterator( directory, error );
+    if ( error )
+    {
+        LOG( "Could not index content directory " + directory.string() + ": " + error.message() );
+        return;
+    }
+
+    for ( ; !error && it != std::filesystem::recursive_directory_iterator(); it.increment( error ) )
+    {
+        // an entry that can't be queried is skipped, and does not end the scan
+        auto entry_error = std::error_code { };
+        if ( !it->is_regular_file( entry_error ) ) { continue; }
+
+        const auto relative_path = it->path().lexically_relative( directory ).generic_string();
+        const auto full_path = m_content_directories[ directory_index ] / io::Path( relative_path );
+
+        // emplace keeps the file of the directory that was hosted first
+        m_files.emplace( relative_path, IndexedFile { full_path, directory_index } );
+    }
+    LOG_IF( error, "Could not finish indexing content directory " + directory.string() + ", files that were not indexed are looked up on disk: " + error.message() );
+}
+
+//----------------------------------------------------------------
+void ContentFileIndex::index_archive( const std::size_t directory_index, const ContentArchive& content_archive )
+{
+    content_archive.for_each_entry( [ & ]( std::string_view path, const archive_format::Entry& )
+    {
+        const auto relative_path = std::string { path };
+        const auto full_path = content_archive.get_path() / io::Path( relative_path );
+        m_files.emplace( relative_path, IndexedFile { full_path, directory_index } );
+    } );
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,93 @@
+#ifndef CONTENT_FILE_INDEX_HPP
+#define CONTENT_FILE_INDEX_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_archive.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+struct FileIndexStatistics
+{
+    uint64_t n_rebuilds     { };
+    uint64_t n_files        { };
+    uint64_t n_lookups      { };
+    uint64_t n_hits         { };
+    uint64_t n_misses       { };
+    // the number of file system stats that resolving the hits by probing
+    // every hosted directory in order would have taken
+    uint64_t n_stats_saved  { };
+};
+
+//----------------------------------------------------------------
+// An in-memory index of all files in the hosted content directories and archives,
+// mapping content paths to the full path of the file that hosts them.
+// Files in an archive get the archive path as their directory.
+// Earlier directories take precedence over later ones,
+// so a mod directory hosted before the base directory overrides its files.
+// The index is built by scanning the directories once, on the first lookup after invalidation.
+class ContentFileIndex
+{
+public:
+    ContentFileIndex() = default;
+    NON_COPYABLE( ContentFileIndex )
+
+    //----------------------------------------------------------------
+    // Call whenever the hosted directories, or the files in them, have changed.
+    // Directories that are the path of one of the archives are indexed from the archive.
+    void invalidate
+    ( 
+        const std::vector<io::Path>&                        content_directories, 
+        const std::vector<std::shared_ptr<ContentArchive>>& content_archives 
+    );
+
+    //----------------------------------------------------------------
+    // Returns the full path of the file that hosts the given content path, if any
+    std::optional<io::Path> find( const io::Path& path );
+
+    //----------------------------------------------------------------
+    FileIndexStatistics get_statistics() const;
+
+private:
+    struct IndexedFile
+    {
+        io::Path    full_path           { };
+        std::size_t directory_index     { };
+    };
+
+    static bool         is_normal   ( const std::string& path );
+    static std::string  to_key      ( const std::string& path );
+
+    void rebuild();
+    void index_directory( const std::size_t directory_index );
+    void index_archive( const std::size_t directory_index, const ContentArchive& content_archive );
+
+private:
+    mutable std::shared_mutex                       m_mutex                 { };
+    std::vector<io::Path>                           m_content_directories   { };
+    std::vector<std::shared_ptr<ContentArchive>>    m_content_archives      { };
+    std::unordered_map<std::string, IndexedFile>    m_files                 { };
+    bool                                            m_is_dirty              { true };
+
+    std::atomic<uint64_t>                           m_n_rebuilds            { 0 };
+    std::atomic<uint64_t>                           m_n_lookups             { 0 };
+    std::atomic<uint64_t>                           m_n_hits                { 0 };
+    std::atomic<uint64_t>                           m_n_stats_saved         { 0 };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_FILE_INDEX_HPP
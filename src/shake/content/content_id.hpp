@@ -0,0 +1,85 @@
+#ifndef CONTENT_ID_HPP
+#define CONTENT_ID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// 64 bit FNV-1a, usable at compile time.
+// Hashes of several strings can be chained by passing the previous hash as the seed.
+constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+constexpr uint64_t hash_string( const char* str, const std::size_t size, const uint64_t seed = fnv_offset_basis )
+{
+    uint64_t hash { seed };
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        hash ^= static_cast<uint8_t>( str[ i ] );
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------
+// Identifies content by the hash of its path, 
+// so lookups don't need to compare strings.
+// Ids can be created at compile time using the _cid literal:
+//     content_manager.get<graphics::Texture>( "textures/grass.json"_cid );
+class ContentId
+{
+public:
+    constexpr ContentId() = default;
+
+    constexpr ContentId( const char* str, const std::size_t size )
+        : m_hash { make_hash( str, size ) }
+    { }
+
+    explicit ContentId( const io::Path& path )
+        : ContentId( path.get_string().data(), path.get_string().size() )
+    { }
+
+    static constexpr ContentId from_hash( const uint64_t hash )
+    {
+        auto id = ContentId { };
+        id.m_hash = hash;
+        return id;
+    }
+
+    constexpr uint64_t  get_hash()  const { return m_hash; }
+    constexpr bool      is_valid()  const { return m_hash != invalid_hash; }
+
+    constexpr bool operator==( const ContentId& other ) const { return m_hash == other.m_hash; }
+    constexpr bool operator!=( const ContentId& other ) const { return m_hash != other.m_hash; }
+
+    // hash tables use the invalid hash to mark empty slots
+    static constexpr uint64_t invalid_hash = 0;
+
+private:
+    static constexpr uint64_t make_hash( const char* str, const std::size_t size )
+    {
+        const auto hash = hash_string( str, size );
+        return hash != invalid_hash ? hash : 1;
+    }
+
+private:
+    uint64_t m_hash { invalid_hash };
+};
+
+namespace literals {
+
+//----------------------------------------------------------------
+constexpr ContentId operator""_cid( const char* str, const std::size_t size )
+{
+    return ContentId { str, size };
+}
+
+} // namespace literals
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_ID_HPP
@@ -1,10 +1,23 @@
 #ifndef CONTENT_MANAGER_HPP
 #define CONTENT_MANAGER_HPP
 
+#include <algorithm>
 #include <any>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
 #include <functional>
+#include <future>
+#include <limits>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include "shake/core/contracts/contracts.hpp"
 #include "shake/core/std/type_erased_map.hpp"
@@ -15,16 +28,34 @@
 #include "shake/core/macros/macro_strongly_typed_alias.hpp"
 #include "shake/core/type_traits/type_id.hpp"
 #include "shake/io/file.hpp"
+#include "shake/io/file_reader.hpp"
 #include "shake/io/path.hpp"
 
+#include "shake/content/content_archive.hpp"
+#include "shake/content/content_bundle.hpp"
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/content_cache.hpp"
+#include "shake/content/content_dependency_graph.hpp"
+#include "shake/content/content_file_index.hpp"
+#include "shake/content/content_id.hpp"
+#include "shake/content/content_trace.hpp"
+#include "shake/content/content_watcher.hpp"
+#include "shake/content/derived_data_cache.hpp"
 #include "shake/content/load_cube_map.hpp"
+#include "shake/content/load_dynamic_font.hpp"
 #include "shake/content/load_font.hpp"
+#include "shake/content/load_json.hpp"
 #include "shake/content/load_material.hpp"
 #include "shake/content/load_mesh.hpp"
 #include "shake/content/load_program.hpp"
 #include "shake/content/load_sprite.hpp"
 #include "shake/content/load_texture.hpp"
-#include "shake/content/load_voxel_grid.hpp"
+#include "shake/content/load_voxel_brick_model.hpp"
+#include "shake/content/load_voxel_mesh.hpp"
+#include "shake/content/load_voxel_model.hpp"
+#include "shake/content/scratch_arena.hpp"
+#include "shake/content/upload_queue.hpp"
+#include "shake/content/worker_pool.hpp"
 
 namespace shake {
 namespace content {
@@ -43,26 +74,78 @@ private:
     using ContentLoader         = std::function<std::shared_ptr<Content_T>( ContentManager*, io::Path )>;
     using ContentLoaderRegistry = TypeErasedMap;
 
+    // Content that can be loaded asynchronously is loaded in two stages.
+    // The decoder runs on a worker thread, and does all cpu work, such as file io and decoding.
+    // Its result is then passed to the uploader, which runs on the thread that owns the graphics context.
+    template<typename Decoded_T>
+    using ContentDecoder        = std::function<Decoded_T( ContentManager*, io::Path )>;
+    template<typename Content_T, typename Decoded_T>
+    using ContentUploader       = std::function<std::shared_ptr<Content_T>( ContentManager*, const Decoded_T& )>;
+
+    // The decoded data is erased by binding it into the upload
+    template<typename Content_T>
+    using ContentUpload         = std::function<std::shared_ptr<Content_T>()>;
+    template<typename Content_T>
+    using AsyncContentLoader    = std::function<ContentUpload<Content_T>( ContentManager*, io::Path )>;
+
+    // Reloads content of one type, if the path is cached, when its file has changed.
+    // Returns whether the path was cached.
+    using ContentReloader       = std::function<bool( const io::Path&, ContentWatcher::Clock::time_point )>;
+
+    // Caches are not copyable, so the registry holds them by pointer
     template<typename Content_T>
-    using ContentCache          = std::map<io::Path, std::shared_ptr<Content_T>>;
+    using ContentCachePtr       = std::shared_ptr<ContentCache<Content_T>>;
     using ContentCacheRegistry  = TypeErasedMap;
 
+    // Bundle manifests refer to content types by name
+    struct BundleContentType
+    {
+        std::function<BundleLoad::ItemStateQuery( const io::Path& )>    preload;
+        std::function<void( const io::Path& )>                          unload;
+    };
+
+    struct LoadedBundle
+    {
+        std::vector<BundleEntry>    entries     { };
+        std::shared_ptr<BundleLoad> load        { };
+        std::size_t                 n_preloads  { };
+    };
+
 public:
 
     ContentManager() = default;
     NON_COPYABLE( ContentManager )
 
     //----------------------------------------------------------------
-    void init()
+    void init( const std::size_t n_worker_threads = WorkerPool::get_default_n_threads() )
     {
         load::init_font_loader();
 
-        register_content_type<graphics::CubeMap>    ( load::load_cube_map   );
-        register_content_type<graphics::Font>       ( load::load_font       );
-        register_content_type<graphics::Material>   ( load::load_material   );
+        m_worker_pool = std::make_unique<WorkerPool>( n_worker_threads );
+
+        register_content_type<CoarseMesh,         std::shared_ptr<CoarseMesh>>( load::decode_coarse_mesh, load::upload_coarse_mesh );
+        register_content_type<graphics::CubeMap,  load::CubeMapData>          ( load::decode_cube_map,  load::upload_cube_map  );
+        register_content_type<DynamicFont,        std::shared_ptr<DynamicFont>>( load::decode_dynamic_font, load::upload_dynamic_font );
+        register_content_type<graphics::Font,     load::FontData>             ( load::decode_font,      load::upload_font      );
+        register_content_type<graphics::Material, load::MaterialData>         ( load::decode_material,  load::upload_material  );
+        register_content_type<Mesh,               std::shared_ptr<Mesh>>      ( load::decode_mesh,      load::upload_mesh      );
         register_content_type<graphics::Program>    ( load::load_program    );
-        register_content_type<graphics::Texture>    ( load::load_texture    );
-        //register_content_type<graphics::VoxelGrid>  ( load::load_voxel_grid );
+        register_content_type<graphics::Texture,  load::TextureData>          ( load::decode_texture,   load::upload_texture   );
+        register_content_type<VoxelBrickModel,    std::shared_ptr<VoxelBrickModel>>( load::decode_voxel_brick_model, load::upload_voxel_brick_model );
+        register_content_type<VoxelMesh,          std::shared_ptr<VoxelMesh>> ( load::decode_voxel_mesh,  load::upload_voxel_mesh  );
+        register_content_type<VoxelModel,         std::shared_ptr<VoxelModel>>( load::decode_voxel_model, load::upload_voxel_model );
+
+        register_content_type_name<CoarseMesh>          ( "coarse_mesh"         );
+        register_content_type_name<graphics::CubeMap>   ( "cube_map"            );
+        register_content_type_name<DynamicFont>         ( "dynamic_font"        );
+        register_content_type_name<graphics::Font>      ( "font"                );
+        register_content_type_name<graphics::Material>  ( "material"            );
+        register_content_type_name<Mesh>                ( "mesh"                );
+        register_content_type_name<graphics::Program>   ( "program"             );
+        register_content_type_name<graphics::Texture>   ( "texture"             );
+        register_content_type_name<VoxelBrickModel>     ( "voxel_brick_model"   );
+        register_content_type_name<VoxelMesh>           ( "voxel_mesh"          );
+        register_content_type_name<VoxelModel>          ( "voxel_model"         );
     }
 
     //----------------------------------------------------------------
@@ -71,7 +154,16 @@ public:
     // otherwise you will get segmentation faults.
     void destroy()
     {
+        // stop watching and decoding first, so no new uploads are pushed
+        m_content_watcher.reset();
+        m_worker_pool.reset();
+        m_upload_queue.clear();
+
+        m_bundles.clear();
+        m_bundle_content_references.clear();
+
         m_content_cache_registry.clear();
+        m_content_caches.clear();
 
         load::destroy_font_loader();
     }
@@ -80,38 +172,247 @@ public:
     // Add a directory to host content from
     void host_content_directory( const io::Path& content_directory )
     {
-        m_hosted_content_directories.emplace_back( content_directory );
+        {
+            const auto lock = std::unique_lock<std::shared_mutex> { m_hosted_content_mutex };
+            m_hosted_content_directories.emplace_back( content_directory );
+        }
+        rebuild_file_index();
+    }
+
+    //----------------------------------------------------------------
+    // Add an archive, created using write_content_archive(), to host content from.
+    // Archives and directories take precedence in the order they were hosted.
+    void host_content_archive( const io::Path& content_archive_path )
+    {
+        auto content_archive = ContentArchive::open( content_archive_path );
+        {
+            const auto lock = std::unique_lock<std::shared_mutex> { m_hosted_content_mutex };
+            m_hosted_content_archives.emplace_back( std::move( content_archive ) );
+            m_hosted_content_directories.emplace_back( content_archive_path );
+        }
+        rebuild_file_index();
     }
 
     //----------------------------------------------------------------
     void clear_hosted_content_directories()
     {
-        m_hosted_content_directories.clear();
+        {
+            const auto lock = std::unique_lock<std::shared_mutex> { m_hosted_content_mutex };
+            m_hosted_content_directories.clear();
+            m_hosted_content_archives.clear();
+        }
+        rebuild_file_index();
+    }
+
+    //----------------------------------------------------------------
+    // Paths are resolved using an index of the hosted directories,
+    // that is built on first use. Call this when files were added or removed.
+    void rebuild_file_index()
+    {
+        const auto lock = std::shared_lock<std::shared_mutex> { m_hosted_content_mutex };
+        m_file_index.invalidate( m_hosted_content_directories, m_hosted_content_archives );
+    }
+
+    //----------------------------------------------------------------
+    FileIndexStatistics get_file_index_statistics() const
+    {
+        return m_file_index.get_statistics();
     }
 
     //----------------------------------------------------------------
+    // Loaders should resolve the files they read through this function,
+    // so the files are recorded as dependencies of the content being loaded.
     inline io::Path get_full_path( const io::Path& path )
     {
-        for ( const auto& content_directory : m_hosted_content_directories )
+        CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::ResolvePath, path } );
+        record_dependency( path );
+        if ( const auto full_path = m_file_index.find( path ) )
         {
-            const auto full_path = content_directory / path;
-            if ( io::file::exists( full_path ) )
+            return *full_path;
+        }
+
+        // the file might have been created after the index was built
+        {
+            const auto lock = std::shared_lock<std::shared_mutex> { m_hosted_content_mutex };
+            for ( const auto& content_directory : m_hosted_content_directories )
             {
-                return full_path;
+                const auto full_path = content_directory / path;
+                if ( io::file::exists( full_path ) )
+                {
+                    return full_path;
+                }
             }
         }
         CHECK_FAIL( "File does not exist: " + path.get_string() );
         return io::Path { "" }; // to shut up warning
     }
 
+    //----------------------------------------------------------------
+    // Loaders should read files through this function, using a path from get_full_path(),
+    // so they can read from hosted archives as well as from loose files.
+    // Files from archives are not copied, the bytes point into the mapped archive.
+    ContentBytes read_content( const io::Path& full_path )
+    {
+        CONTENT_TRACE_ONLY( auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::ReadFile, full_path } );
+        if ( const auto bytes = find_archive_bytes( full_path ) )
+        {
+            CONTENT_TRACE_ONLY( trace_scope.set_n_bytes( bytes->size() ) );
+            return *bytes;
+        }
+
+        auto file_reader = io::FileReader( full_path );
+        const auto bytes = ContentBytes::make_owning( file_reader.read_bytes( file_reader.get_size() ) );
+        CONTENT_TRACE_ONLY( trace_scope.set_n_bytes( bytes.size() ) );
+        return bytes;
+    }
+
+    //----------------------------------------------------------------
+    // Like read_content(), but reads loose files into the scratch arena of the calling thread,
+    // so reading them allocates nothing once the arena has grown to fit them.
+    // The bytes are only valid until the load ends, so use this for files that are consumed while decoding,
+    // such as descriptors and compressed images, and never let the loaded content refer to them.
+    // Reads at most max_n_bytes from the start of the file, for formats that store what is needed first.
+    ContentBytes read_scratch_content( const io::Path& full_path, const std::size_t max_n_bytes = std::numeric_limits<std::size_t>::max() )
+    {
+        if ( !ScratchScope::is_active() )
+        {
+            const auto bytes = read_content( full_path );
+            return bytes.get_sub_bytes( 0, std::min( bytes.size(), max_n_bytes ) );
+        }
+
+        CONTENT_TRACE_ONLY( auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::ReadFile, full_path } );
+        if ( const auto bytes = find_archive_bytes( full_path ) )
+        {
+            const auto n_bytes = std::min( bytes->size(), max_n_bytes );
+            CONTENT_TRACE_ONLY( trace_scope.set_n_bytes( n_bytes ) );
+            return bytes->get_sub_bytes( 0, n_bytes );
+        }
+
+        const auto n_bytes = std::min( static_cast<std::size_t>( get_file_size( full_path ) ), max_n_bytes );
+        const auto data = static_cast<uint8_t*>( get_scratch_resource()->allocate( n_bytes, alignof( std::max_align_t ) ) );
+        auto stream = std::ifstream( full_path.get_string(), std::ios::binary );
+        CHECK( stream.read( reinterpret_cast<char*>( data ), static_cast<std::streamsize>( n_bytes ) ).good(), "Could not read file: " + full_path.get_string() );
+        CONTENT_TRACE_ONLY( trace_scope.set_n_bytes( n_bytes ) );
+        return ContentBytes { nullptr, data, n_bytes };
+    }
+
+    //----------------------------------------------------------------
+    // Where the file at a path from get_full_path() is stored, 
+    // to read several files in the order they are stored in
+    ContentLocation locate_content( const io::Path& full_path ) const
+    {
+        if ( const auto archive_file = find_archive_file( full_path ) )
+        {
+            const auto& [ content_archive, path ] = *archive_file;
+            if ( const auto entry = content_archive->find_entry( path ) )
+            {
+                return ContentLocation { content_archive->get_path().get_string(), entry->offset, entry->size };
+            }
+        }
+        return ContentLocation { full_path.get_string(), 0, get_file_size( full_path ) };
+    }
+
 public:
 
     //----------------------------------------------------------------
     template<typename Content_T>
     void  register_content_type( const ContentLoader< Content_T >& loader_function )
     {
+        // Content without a separate decoder is loaded entirely as part of its upload
+        const auto async_loader_function = AsyncContentLoader<Content_T>
+        {
+            [ loader_function ]( ContentManager* content_manager, io::Path full_path ) -> ContentUpload<Content_T>
+            {
+                return [ loader_function, content_manager, full_path ]() { return loader_function( content_manager, full_path ); };
+            }
+        };
+
+        m_content_loader_registry.emplace( loader_function );
+        m_content_loader_registry.emplace( async_loader_function );
+        register_content_cache<Content_T>();
+        register_content_reloader<Content_T>();
+    }
+
+    //----------------------------------------------------------------
+    template<typename Content_T, typename Decoded_T>
+    void  register_content_type
+    ( 
+        const ContentDecoder< Decoded_T >&              decoder_function, 
+        const ContentUploader< Content_T, Decoded_T >&  uploader_function 
+    )
+    {
+        const auto loader_function = ContentLoader<Content_T>
+        {
+            [ decoder_function, uploader_function ]( ContentManager* content_manager, io::Path full_path )
+            {
+                const auto decoded = [ & ]()
+                {
+                    CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { content_manager->get_content_tracer(), ContentTracePhase::Decode, full_path } );
+                    return decoder_function( content_manager, full_path );
+                }();
+                CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { content_manager->get_content_tracer(), ContentTracePhase::Upload, full_path } );
+                return uploader_function( content_manager, decoded );
+            }
+        };
+
+        const auto async_loader_function = AsyncContentLoader<Content_T>
+        {
+            [ decoder_function, uploader_function ]( ContentManager* content_manager, io::Path full_path ) -> ContentUpload<Content_T>
+            {
+                const auto decoded = [ & ]()
+                {
+                    CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { content_manager->get_content_tracer(), ContentTracePhase::Decode, full_path } );
+                    return std::make_shared<Decoded_T>( decoder_function( content_manager, full_path ) );
+                }();
+                // traced by the caller, which knows the content path to attribute the upload to
+                return [ uploader_function, content_manager, decoded ]() 
+                { 
+                    return uploader_function( content_manager, *decoded ); 
+                };
+            }
+        };
+
         m_content_loader_registry.emplace( loader_function );
-        m_content_cache_registry.emplace( ContentCache<Content_T> { } );
+        m_content_loader_registry.emplace( async_loader_function );
+        register_content_cache<Content_T>();
+        register_content_reloader<Content_T>();
+    }
+
+    //----------------------------------------------------------------
+    // Names the content type in bundle manifests
+    template<typename Content_T>
+    void register_content_type_name( const std::string& type_name )
+    {
+        const auto content_type = BundleContentType
+        {
+            [ this ]( const io::Path& path ) -> BundleLoad::ItemStateQuery
+            {
+                const auto future = preload_async<Content_T>( path );
+                return [ future, path ]()
+                {
+                    if ( future.wait_for( std::chrono::seconds { 0 } ) != std::future_status::ready ) { return BundleLoad::ItemState::Loading; }
+                    try 
+                    { 
+                        future.get(); 
+                        return BundleLoad::ItemState::Loaded;
+                    }
+                    catch ( ... ) 
+                    { 
+                        LOG( "Could not load " + path.get_string() + " of bundle." );
+                        return BundleLoad::ItemState::Failed; 
+                    }
+                };
+            },
+            // content that failed to load, or is still loading, is not cached, and has nothing to unload
+            [ this ]( const io::Path& path ) 
+            { 
+                if ( get_content_cache<Content_T>().has( path ) ) { unload<Content_T>( path ); }
+            }
+        };
+
+        const auto lock = std::lock_guard<std::mutex> { m_bundle_mutex };
+        const auto is_emplaced = m_bundle_content_types.emplace( type_name, content_type ).second;
+        CHECK( is_emplaced, "Content type name is already registered: " + type_name );
     }
 
     //----------------------------------------------------------------
@@ -121,41 +422,456 @@ public:
     // and use get() for everything else.
 
     //----------------------------------------------------------------
-    // Used to load content to the content cache
+    // Used to load content to the content cache.
+    // All of the functions below can be called from multiple threads,
+    // concurrent loads of the same content are only done once.
     template<typename Content_T> inline
-    const std::shared_ptr<Content_T>& preload( const io::Path& path )
+    std::shared_ptr<Content_T> preload( const io::Path& path )
+    {
+        auto& cache = get_content_cache<Content_T>();
+        DEBUG_ONLY( CHECK( !cache.has( path ), "Map has unexpected key" ) );
+        record_dependency( path );
+        return load_to_cache<Content_T>( cache, path );
+    }
+
+    //----------------------------------------------------------------
+    // Used to load content to the content cache, without blocking the calling thread.
+    // Decoding happens on the worker pool,
+    // after which the upload is queued until process_uploads() is called.
+    // Never wait on the returned future from the thread that processes the uploads,
+    // before processing them.
+    template<typename Content_T>
+    ContentFuture<Content_T> preload_async( const io::Path& path )
+    {
+        auto& cache             = get_content_cache<Content_T>();
+        const auto promise      = std::make_shared<std::promise<std::shared_ptr<Content_T>>>();
+        const auto future       = promise->get_future().share();
+        record_dependency( path );
+
+        if ( const auto content = cache.find( path ) )
+        {
+            promise->set_value( content );
+            return future;
+        }
+
+        // join a load of the same content that is already underway
+        const auto [ pending_future, is_emplaced ] = cache.emplace_pending( path, future );
+        if ( !is_emplaced ) { return pending_future; }
+
+        m_worker_pool->submit( [ this, &cache, path, promise ]()
+        {
+            try
+            {
+                const auto scratch_scope = ScratchScope { };
+                CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::Load, path } );
+                const auto full_path = get_full_path( path );
+                const AsyncContentLoader<Content_T>& async_loader = m_content_loader_registry.at<AsyncContentLoader<Content_T>>();
+                // decoders and uploaders both report sizes, such as that of cpu side content
+                std::size_t n_decoded_bytes { 0 };
+                const auto upload = [ & ]()
+                {
+                    const auto scope        = DependencyScope { path };
+                    const auto size_scope   = ContentSizeScope { };
+                    auto content_upload = async_loader( this, full_path );
+                    n_decoded_bytes = size_scope.get_n_bytes();
+                    return content_upload;
+                }();
+                CONTENT_TRACE_ONLY( const auto decoded_at = ContentTracer::Clock::now() );
+
+                m_upload_queue.push( [ &cache, path, promise, upload, n_decoded_bytes CONTENT_TRACE_ONLY( , this, decoded_at ) ]()
+                {
+                    try
+                    {
+                        CONTENT_TRACE_ONLY( m_content_tracer.record( ContentTracePhase::UploadQueue, path, path, decoded_at, ContentTracer::Clock::now() ) );
+                        CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::Upload, path } );
+                        const auto scratch_scope    = ScratchScope { };
+                        const auto scope            = DependencyScope { path };
+                        const auto size_scope   = ContentSizeScope { };
+                        // the content might have been loaded synchronously in the meantime,
+                        // in which case the cached content is kept
+                        const auto cached_content = cache.find( path );
+                        const auto content = cached_content != nullptr ? cached_content : upload();
+                        promise->set_value( cache.insert( path, content, n_decoded_bytes + size_scope.get_n_bytes() ) );
+                    }
+                    catch ( ... ) { promise->set_exception( std::current_exception() ); }
+                    cache.erase_pending( path );
+                } );
+            }
+            catch ( ... ) 
+            { 
+                promise->set_exception( std::current_exception() ); 
+                cache.erase_pending( path );
+            }
+        } );
+
+        return future;
+    }
+
+    //----------------------------------------------------------------
+    // For decoders of content that refers to other content, such as materials.
+    // Decodes the referred content on the calling thread, unless it is cached already,
+    // and returns the function that uploads it to the cache, to call from the uploader.
+    // Only the upload of the referred content is then left to process_uploads().
+    template<typename Content_T>
+    ContentUpload<Content_T> decode_dependency( const io::Path& path )
+    {
+        auto& cache = get_content_cache<Content_T>();
+        record_dependency( path );
+        if ( cache.has( path ) )
+        {
+            return [ this, path ]() { return get_or_load<Content_T>( path ); };
+        }
+
+        const auto full_path = get_full_path( path );
+        const AsyncContentLoader<Content_T>& async_loader = m_content_loader_registry.at<AsyncContentLoader<Content_T>>();
+        std::size_t n_decoded_bytes { 0 };
+        const auto upload = [ & ]()
+        {
+            const auto scope        = DependencyScope { path };
+            const auto size_scope   = ContentSizeScope { };
+            auto content_upload = async_loader( this, full_path );
+            n_decoded_bytes = size_scope.get_n_bytes();
+            return content_upload;
+        }();
+
+        return [ &cache, path, upload, n_decoded_bytes ]()
+        {
+            const auto scope        = DependencyScope { path };
+            const auto size_scope   = ContentSizeScope { };
+            // the content might have been loaded in the meantime, in which case the cached content is kept
+            const auto cached_content = cache.find( path );
+            const auto content = cached_content != nullptr ? cached_content : upload();
+            return cache.insert( path, content, n_decoded_bytes + size_scope.get_n_bytes() );
+        };
+    }
+
+    //----------------------------------------------------------------
+    // Loads the content again, without blocking the calling thread,
+    // and replaces the cached content once the new content is uploaded by process_uploads().
+    // Until then, and if loading fails, the old content stays in use.
+    // Pass when the file changed, to measure the latency of hot reloads.
+    template<typename Content_T>
+    ContentFuture<Content_T> reload
+    ( 
+        const io::Path&                         path, 
+        const ContentWatcher::Clock::time_point changed_at = ContentWatcher::Clock::now() 
+    )
+    {
+        auto& cache             = get_content_cache<Content_T>();
+        const auto promise      = std::make_shared<std::promise<std::shared_ptr<Content_T>>>();
+        const auto future       = promise->get_future().share();
+
+        const auto on_failure = [ this, path, promise ]()
+        {
+            LOG( "Could not reload " + path.get_string() + ", keeping the old content." );
+            record_reload( std::nullopt );
+            promise->set_exception( std::current_exception() );
+        };
+
+        m_worker_pool->submit( [ this, &cache, path, changed_at, promise, on_failure ]()
+        {
+            try
+            {
+                const auto scratch_scope = ScratchScope { };
+                CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::Load, path } );
+                const auto full_path = get_full_path( path );
+                const AsyncContentLoader<Content_T>& async_loader = m_content_loader_registry.at<AsyncContentLoader<Content_T>>();
+
+                // the dependencies are recorded anew, as the content might refer to other content now
+                m_dependency_graph.clear_dependencies( path );
+                // decoders and uploaders both report sizes, such as that of cpu side content
+                std::size_t n_decoded_bytes { 0 };
+                const auto upload = [ & ]()
+                {
+                    const auto scope        = DependencyScope { path };
+                    const auto size_scope   = ContentSizeScope { };
+                    auto content_upload = async_loader( this, full_path );
+                    n_decoded_bytes = size_scope.get_n_bytes();
+                    return content_upload;
+                }();
+                CONTENT_TRACE_ONLY( const auto decoded_at = ContentTracer::Clock::now() );
+
+                // content is only replaced on the thread that processes uploads, between frames
+                m_upload_queue.push( [ this, &cache, path, changed_at, promise, upload, n_decoded_bytes, on_failure CONTENT_TRACE_ONLY( , decoded_at ) ]()
+                {
+                    try
+                    {
+                        {
+                            CONTENT_TRACE_ONLY( m_content_tracer.record( ContentTracePhase::UploadQueue, path, path, decoded_at, ContentTracer::Clock::now() ) );
+                            CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::Upload, path } );
+                            const auto scratch_scope    = ScratchScope { };
+                            const auto scope            = DependencyScope { path };
+                            const auto size_scope       = ContentSizeScope { };
+                            const auto content          = upload();
+                            promise->set_value( cache.replace( path, content, n_decoded_bytes + size_scope.get_n_bytes() ) );
+                        }
+                        record_reload( ContentWatcher::Clock::now() - changed_at );
+                        LOG( "Reloaded " + path.get_string() );
+
+                        // dependents are reloaded only now, so they pick up the new content
+                        for ( const auto& dependent : m_dependency_graph.get_dependents( path ) ) { reload_path( dependent, changed_at ); }
+                    }
+                    catch ( ... ) { on_failure(); }
+                } );
+            }
+            catch ( ... ) { on_failure(); }
+        } );
+
+        return future;
+    }
+
+    //----------------------------------------------------------------
+    // Watches the hosted content directories,
+    // and reloads cached content whose file changed, using reload(),
+    // followed by the content that depends on it.
+    // Directories hosted after this call are not watched.
+    void enable_hot_reload()
+    {
+        auto content_directories = std::vector<io::Path> { };
+        {
+            const auto lock = std::shared_lock<std::shared_mutex> { m_hosted_content_mutex };
+            content_directories = m_hosted_content_directories;
+        }
+
+        m_content_watcher = std::make_unique<ContentWatcher>
+        (
+            content_directories,
+            [ this ]( const std::vector<std::pair<io::Path, ContentWatcher::Clock::time_point>>& changed_files )
+            {
+                // new files might have been written
+                rebuild_file_index();
+                for ( const auto& [ full_path, changed_at ] : changed_files )
+                {
+                    try
+                    {
+                        if ( const auto path = to_content_path( full_path ) ) { reload_path( *path, changed_at ); }
+                    }
+                    catch ( ... )
+                    {
+                        LOG( "Could not reload content for " + full_path.get_string() + ", keeping the old content." );
+                        record_reload( std::nullopt );
+                    }
+                }
+            }
+        );
+    }
+
+    //----------------------------------------------------------------
+    void disable_hot_reload()
+    {
+        m_content_watcher.reset();
+    }
+
+    //----------------------------------------------------------------
+    HotReloadStatistics get_hot_reload_statistics()
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_hot_reload_statistics_mutex };
+        return m_hot_reload_statistics;
+    }
+
+    //----------------------------------------------------------------
+    // Loaders that decode several independent parts, such as the faces of a cube map,
+    // use this to decode them in parallel on the worker pool.
+    // At most max_decode_concurrency threads are used per call, 0 means no limit.
+    void parallel_for( const std::size_t n_indices, const std::function<void( std::size_t )>& function )
+    {
+        if ( m_worker_pool == nullptr || m_max_decode_concurrency == 1 )
+        {
+            for ( std::size_t index = 0; index < n_indices; ++index ) { function( index ); }
+            return;
+        }
+
+        // the parts belong to the content being loaded on this thread
+        const auto current = DependencyScope::get_current();
+        CONTENT_TRACE_ONLY( const auto current_load = ContentTraceScope::get_current_load() );
+        m_worker_pool->parallel_for( n_indices, [ &current, &function CONTENT_TRACE_ONLY( , current_load ) ]( const std::size_t index )
+        {
+            const auto scope            = DependencyScope { current };
+            const auto scratch_scope    = ScratchScope { };
+            CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { current_load } );
+            function( index );
+        }, m_max_decode_concurrency );
+    }
+
+    //----------------------------------------------------------------
+    // Which content and files were loaded as part of loading other content.
+    // Dependencies are recorded as loaders request them from the content manager.
+    // Use the load order to preload content together with everything it depends on,
+    // and the dependents to find out what a change to some content affects.
+    inline const ContentDependencyGraph& get_dependency_graph() const { return m_dependency_graph; }
+
+    //----------------------------------------------------------------
+    // Records how long every load takes, split into phases, while tracing is enabled on it.
+    // Loads are only traced in builds that define SHAKE_CONTENT_TRACING.
+    inline ContentTracer& get_content_tracer() { return m_content_tracer; }
+
+    //----------------------------------------------------------------
+    // Loaders that derive expensive intermediate data, such as decoded images and rasterized fonts,
+    // store it in this directory, so it can be reused at the next startup.
+    // Nothing is cached unless a cache directory is set.
+    void set_cache_directory( const io::Path& cache_directory )
+    {
+        m_cache_directory = cache_directory;
+        m_derived_data_cache.set_directory( cache_directory );
+    }
+
+    //----------------------------------------------------------------
+    inline DerivedDataCache& get_derived_data_cache() { return m_derived_data_cache; }
+
+    //----------------------------------------------------------------
+    DerivedDataCacheStatistics get_derived_data_cache_statistics() const
     {
-        const auto full_path = get_full_path( path ); 
+        return m_derived_data_cache.get_statistics();
+    }
 
-        ContentCache<Content_T>& cache = m_content_cache_registry.at<ContentCache<Content_T>>();
-        DEBUG_ONLY( CHECK( !map::has( cache, path ), "Map has unexpected key" ) );
+    //----------------------------------------------------------------
+    void set_max_decode_concurrency( const std::size_t max_decode_concurrency )
+    {
+        m_max_decode_concurrency = max_decode_concurrency;
+    }
 
-        const ContentLoader<Content_T>& loader = m_content_loader_registry.at<ContentLoader<Content_T>>();
-        const std::shared_ptr<Content_T> content = loader( this, full_path ); 
-        cache[ path ] = content;
-        return cache[ path ];
+    //----------------------------------------------------------------
+    // Runs queued uploads of asynchronously loaded content,
+    // and evicts content to stay within the budgets afterwards.
+    // Call this regularly from the thread that owns the graphics context,
+    // and get content again afterwards, to use the content that reloads replaced.
+    // Returns the number of uploads that were processed.
+    std::size_t process_uploads( const std::size_t max_n_uploads = std::numeric_limits<std::size_t>::max() )
+    {
+        const auto n_uploads = m_upload_queue.process( max_n_uploads );
+        enforce_content_budgets();
+        return n_uploads;
+    }
+
+    //----------------------------------------------------------------
+    // Loaders call this to report the estimated resident size of the content they load,
+    // such as the pixels of a texture, so it can be kept within a budget
+    void report_content_size( const std::size_t n_bytes )
+    {
+        ContentSizeScope::report( n_bytes );
+    }
+
+    //----------------------------------------------------------------
+    // When content of the type takes more bytes than its budget,
+    // content that is only referred to by the cache is evicted, least recently used first.
+    // A budget of 0 means the content is not limited.
+    template<typename Content_T>
+    void set_content_budget( const std::size_t budget )
+    {
+        get_content_cache<Content_T>().set_budget( budget );
+    }
+
+    //----------------------------------------------------------------
+    // Like set_content_budget, for all types of content together
+    void set_total_content_budget( const std::size_t budget )
+    {
+        m_total_content_budget = budget;
+    }
+
+    //----------------------------------------------------------------
+    template<typename Content_T>
+    ContentBudgetStatistics get_content_budget_statistics()
+    {
+        return get_content_cache<Content_T>().get_budget_statistics();
+    }
+
+    //----------------------------------------------------------------
+    // The evictions count all content that enforce_content_budgets() evicted,
+    // to meet the budget of its type as well as the total budget
+    ContentBudgetStatistics get_total_content_budget_statistics() const
+    {
+        auto statistics = ContentBudgetStatistics { };
+        statistics.budget       = m_total_content_budget;
+        statistics.n_evictions  = m_n_total_evictions;
+        for ( const auto& cache : m_content_caches )
+        {
+            statistics.n_bytes      += cache->get_n_bytes();
+            statistics.n_entries    += cache->get_n_entries();
+        }
+        return statistics;
+    }
+
+    //----------------------------------------------------------------
+    // Evicts content until all budgets are met, as far as unreferenced content allows.
+    // Called by process_uploads().
+    void enforce_content_budgets()
+    {
+        auto evicted_paths = std::vector<io::Path> { };
+        for ( const auto& cache : m_content_caches )
+        {
+            if ( cache->get_budget() == 0 ) { continue; }
+            const auto cache_evicted_paths = cache->evict_to( cache->get_budget() );
+            evicted_paths.insert( evicted_paths.end(), cache_evicted_paths.begin(), cache_evicted_paths.end() );
+            m_n_total_evictions += cache_evicted_paths.size();
+        }
+
+        if ( m_total_content_budget != 0 )
+        {
+            std::size_t n_bytes { 0 };
+            for ( const auto& cache : m_content_caches ) { n_bytes += cache->get_n_bytes(); }
+
+            if ( n_bytes > m_total_content_budget )
+            {
+                // candidates of all types compete, so the least recently used content goes first
+                auto candidates = std::vector<std::pair<EvictionCandidate, ContentCacheBase*>> { };
+                for ( const auto& cache : m_content_caches )
+                {
+                    auto cache_candidates = std::vector<EvictionCandidate> { };
+                    cache->collect_eviction_candidates( cache_candidates );
+                    for ( auto& candidate : cache_candidates ) { candidates.emplace_back( std::move( candidate ), cache.get() ); }
+                }
+                std::sort( candidates.begin(), candidates.end(), []( const auto& a, const auto& b ) { return a.first.last_use < b.first.last_use; } );
+
+                for ( const auto& [ candidate, cache ] : candidates )
+                {
+                    if ( n_bytes <= m_total_content_budget ) { break; }
+                    if ( cache->evict( candidate.id ) )
+                    {
+                        n_bytes -= candidate.n_bytes;
+                        ++m_n_total_evictions;
+                        evicted_paths.emplace_back( candidate.path );
+                    }
+                }
+            }
+        }
+
+        for ( const auto& path : evicted_paths )
+        {
+            LOG( "Evicted " + path.get_string() );
+            m_dependency_graph.clear_dependencies( path );
+        }
+
+        for ( const auto& cache : m_content_caches ) { cache->advance_use_tick(); }
     }
 
     //----------------------------------------------------------------
     // Used if you want to obtain some content,
     // and it might not yet be in the cache
     template<typename Content_T>
-    const std::shared_ptr<Content_T>& get_or_load( const io::Path& path )
+    std::shared_ptr<Content_T> get_or_load( const io::Path& path )
     {
-        auto& cache = m_content_cache_registry.at<ContentCache<Content_T>>();
-        if ( !map::has( cache, path ) ) { preload<Content_T>( path ); }
-        return cache[ path ];
+        record_dependency( path );
+        return load_to_cache<Content_T>( get_content_cache<Content_T>(), path );
     }
 
     //----------------------------------------------------------------
     // Used if you want to obtain some content,
     // and assert it was already preloaded
     template< typename Content_T >
-    const std::shared_ptr<Content_T>& get( const io::Path& path )
+    std::shared_ptr<Content_T> get( const io::Path& path )
+    {
+        record_dependency( path );
+        return get_content_cache<Content_T>().get( path );
+    }
+
+    //----------------------------------------------------------------
+    // Prefer this overload in hot code,
+    // ids can be computed once, or at compile time using the _cid literal.
+    // Ids don't know their path, so loaders should use the path overload to have dependencies recorded.
+    template< typename Content_T >
+    std::shared_ptr<Content_T> get( const ContentId& id )
     {
-        auto& cache = m_content_cache_registry.at< ContentCache< Content_T> >();
-        DEBUG_ONLY( CHECK( map::has( cache, path ), "Map does not have expected key" ) );
-        return cache[ path ];
+        return get_content_cache<Content_T>().get( id );
     }
 
     //----------------------------------------------------------------
@@ -163,16 +879,275 @@ public:
     template< typename Content_T >
     void unload( const io::Path& path )
     {
-        auto& cache = m_content_cache_registry.at< ContentCache< Content_T > >();
-        bool erased = map::erase_if_has( cache, path );
+        bool erased = get_content_cache<Content_T>().erase( path );
         LOG_IF( !erased, "Unnecessary unload of " + path.get_string() );
+        m_dependency_graph.clear_dependencies( path );
+    }
+
+    //----------------------------------------------------------------
+    // Loads all content listed in the bundle manifest, see parse_bundle_manifest(), 
+    // without blocking the calling thread, like preload_async().
+    // Files are read in the order they are stored in, and decoded in parallel.
+    // Content shared between bundles is counted, and only unloaded with the last bundle that lists it.
+    // Preloading a bundle again returns the same load, and needs another unload_bundle().
+    std::shared_ptr<const BundleLoad> preload_bundle( const io::Path& manifest_path )
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_bundle_mutex };
+        auto& bundle = m_bundles[ manifest_path ];
+        if ( bundle.n_preloads == 0 )
+        {
+            // a failure leaves no half loaded bundle behind
+            try
+            {
+                bundle.entries = parse_bundle_manifest( load::read_json( this, get_full_path( manifest_path ) ) );
+                bundle.load = load_bundle_entries( bundle.entries );
+            }
+            catch ( ... )
+            {
+                m_bundles.erase( manifest_path );
+                throw;
+            }
+        }
+        else
+        {
+            for ( const auto& entry : bundle.entries ) { ++m_bundle_content_references[ { entry.type_name, entry.path } ]; }
+        }
+
+        ++bundle.n_preloads;
+        return bundle.load;
+    }
+
+    //----------------------------------------------------------------
+    // Unloads the content of a preloaded bundle, 
+    // except for content that other preloaded bundles also list.
+    // Wait for the bundle to be loaded first, content that is still loading is not unloaded.
+    // Content that failed to load is skipped.
+    void unload_bundle( const io::Path& manifest_path )
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_bundle_mutex };
+        const auto it = m_bundles.find( manifest_path );
+        CHECK( it != m_bundles.end(), "Bundle is not preloaded: " + manifest_path.get_string() );
+
+        auto& bundle = it->second;
+        for ( const auto& entry : bundle.entries )
+        {
+            const auto reference = m_bundle_content_references.find( { entry.type_name, entry.path } );
+            if ( --reference->second == 0 )
+            {
+                m_bundle_content_references.erase( reference );
+                m_bundle_content_types.at( entry.type_name ).unload( entry.path );
+            }
+        }
+
+        if ( --bundle.n_preloads == 0 ) { m_bundles.erase( it ); }
+    }
+
+private:
+
+    //----------------------------------------------------------------
+    template<typename Content_T>
+    void register_content_cache()
+    {
+        const auto cache = std::make_shared<ContentCache<Content_T>>();
+        m_content_cache_registry.emplace( ContentCachePtr<Content_T> { cache } );
+        m_content_caches.emplace_back( cache );
+    }
+
+    //----------------------------------------------------------------
+    template<typename Content_T>
+    void register_content_reloader()
+    {
+        m_content_reloaders.emplace_back( [ this ]( const io::Path& path, const ContentWatcher::Clock::time_point changed_at )
+        {
+            if ( !get_content_cache<Content_T>().has( path ) ) { return false; }
+            reload<Content_T>( path, changed_at );
+            return true;
+        } );
+    }
+
+    //----------------------------------------------------------------
+    // Expects the bundle mutex to be locked
+    std::shared_ptr<BundleLoad> load_bundle_entries( const std::vector<BundleEntry>& entries )
+    {
+        // resolve everything first, so a bundle with missing content loads nothing
+        auto located_entries = std::vector<std::pair<ContentLocation, const BundleEntry*>> { };
+        located_entries.reserve( entries.size() );
+        for ( const auto& entry : entries )
+        {
+            CHECK( m_bundle_content_types.count( entry.type_name ) == 1, "Bundle lists content of unknown type: " + entry.type_name );
+            located_entries.emplace_back( locate_content( get_full_path( entry.path ) ), &entry );
+        }
+
+        // the worker pool starts tasks in the order they are submitted, 
+        // so the files are read front to back
+        std::sort( located_entries.begin(), located_entries.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+
+        const auto bundle_load = std::make_shared<BundleLoad>();
+        for ( const auto& [ location, entry ] : located_entries )
+        {
+            ++m_bundle_content_references[ { entry->type_name, entry->path } ];
+            bundle_load->add_item( m_bundle_content_types.at( entry->type_name ).preload( entry->path ), location.n_bytes );
+        }
+        return bundle_load;
+    }
+
+    //----------------------------------------------------------------
+    // The hosted archive that contains the file at a path from get_full_path(), if any, 
+    // and the content path within that archive.
+    // The archive is shared, so it stays mapped if it is no longer hosted while its bytes are read.
+    std::optional<std::pair<std::shared_ptr<const ContentArchive>, io::Path>> find_archive_file( const io::Path& full_path ) const
+    {
+        const auto lock = std::shared_lock<std::shared_mutex> { m_hosted_content_mutex };
+        for ( const auto& content_archive : m_hosted_content_archives )
+        {
+            auto path = get_relative_path( full_path, content_archive->get_path() );
+            if ( path && content_archive->find_entry( *path ) ) { return std::make_pair( std::shared_ptr<const ContentArchive> { content_archive }, std::move( *path ) ); }
+        }
+        return std::nullopt;
+    }
+
+    //----------------------------------------------------------------
+    // The bytes of the file at a path from get_full_path(), if it is in a hosted archive
+    std::optional<ContentBytes> find_archive_bytes( const io::Path& full_path ) const
+    {
+        if ( const auto archive_file = find_archive_file( full_path ) )
+        {
+            const auto& [ content_archive, path ] = *archive_file;
+            return content_archive->find( path );
+        }
+        return std::nullopt;
+    }
+
+    //----------------------------------------------------------------
+    // Reloads the content at the path, of whatever type it is cached as.
+    // Paths that are not cached as content, such as image files, are only depended on,
+    // so their dependents are reloaded instead.
+    void reload_path( const io::Path& path, const ContentWatcher::Clock::time_point changed_at )
+    {
+        bool is_reloaded { false };
+        for ( const auto& reloader : m_content_reloaders ) { is_reloaded |= reloader( path, changed_at ); }
+        if ( is_reloaded ) { return; }
+
+        for ( const auto& dependent : m_dependency_graph.get_dependents( path ) ) { reload_path( dependent, changed_at ); }
+    }
+
+    //----------------------------------------------------------------
+    // Records the path as a dependency of the content that is being loaded on this thread, if any
+    void record_dependency( const io::Path& path )
+    {
+        if ( const auto current = DependencyScope::get_current() ) { m_dependency_graph.add_dependency( *current, path ); }
+    }
+
+    //----------------------------------------------------------------
+    // The path relative to the hosted directory that contains the file, if any
+    std::optional<io::Path> to_content_path( const io::Path& full_path ) const
+    {
+        const auto lock = std::shared_lock<std::shared_mutex> { m_hosted_content_mutex };
+        for ( const auto& content_directory : m_hosted_content_directories )
+        {
+            if ( auto path = get_relative_path( full_path, content_directory ) ) { return path; }
+        }
+        return std::nullopt;
+    }
+
+    //----------------------------------------------------------------
+    // The path of the file relative to the directory, if the file is below it.
+    // Whole path components are compared, so content_mods/a.png is not below content.
+    static std::optional<io::Path> get_relative_path( const io::Path& full_path, const io::Path& directory )
+    {
+        const auto& full_path_str = full_path.get_string();
+        auto directory_str = std::string_view { directory.get_string() };
+        while ( !directory_str.empty() && directory_str.back() == '/' ) { directory_str.remove_suffix( 1 ); }
+
+        if 
+        ( 
+            full_path_str.size() <= directory_str.size() 
+            || full_path_str.compare( 0, directory_str.size(), directory_str ) != 0 
+            || full_path_str[ directory_str.size() ] != '/'
+        )
+        {
+            return std::nullopt;
+        }
+
+        // skip the separators between the directory and the content path
+        const auto path_start = full_path_str.find_first_not_of( '/', directory_str.size() );
+        if ( path_start == std::string::npos ) { return std::nullopt; }
+        return io::Path { full_path_str.substr( path_start ) };
+    }
+
+    //----------------------------------------------------------------
+    // Pass no latency for failed reloads
+    void record_reload( const std::optional<ContentWatcher::Clock::duration>& latency )
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_hot_reload_statistics_mutex };
+        auto& statistics = m_hot_reload_statistics;
+        if ( !latency )
+        {
+            ++statistics.n_failed_reloads;
+            return;
+        }
+
+        const auto latency_seconds = std::chrono::duration<double> { *latency }.count();
+        statistics.mean_latency_seconds = ( statistics.mean_latency_seconds * statistics.n_reloads + latency_seconds ) / ( statistics.n_reloads + 1 );
+        statistics.max_latency_seconds  = std::max( statistics.max_latency_seconds, latency_seconds );
+        ++statistics.n_reloads;
+    }
+
+    //----------------------------------------------------------------
+    template<typename Content_T>
+    ContentCache<Content_T>& get_content_cache()
+    {
+        return *m_content_cache_registry.at<ContentCachePtr<Content_T>>();
+    }
+
+    //----------------------------------------------------------------
+    template<typename Content_T>
+    std::shared_ptr<Content_T> load_to_cache( ContentCache<Content_T>& cache, const io::Path& path )
+    {
+        return cache.get_or_load( path, [ this, &path ]()
+        {
+            const auto scratch_scope = ScratchScope { };
+            CONTENT_TRACE_ONLY( const auto trace_scope = ContentTraceScope { m_content_tracer, ContentTracePhase::Load, path } );
+            const auto full_path = get_full_path( path );
+            const ContentLoader<Content_T>& loader = m_content_loader_registry.at<ContentLoader<Content_T>>();
+            const auto scope = DependencyScope { path };
+            return loader( this, full_path );
+        } );
     }
 
 public:
-    PROPERTY_R ( std::vector<io::Path>, hosted_content_directories  )
+    PROPERTY_R ( std::vector<io::Path>,     hosted_content_directories  )
+    PROPERTY_R ( std::optional<io::Path>,   cache_directory             )
+
+    ContentLoaderRegistry       m_content_loader_registry;
+    ContentCacheRegistry        m_content_cache_registry;
+    // The same caches as in the registry, to go over all of them
+    std::vector<std::shared_ptr<ContentCacheBase>> m_content_caches;
+    std::atomic<std::size_t>    m_total_content_budget  { 0 };
+    std::atomic<std::size_t>    m_n_total_evictions     { 0 };
+
+    std::unique_ptr<WorkerPool> m_worker_pool;
+    UploadQueue                 m_upload_queue;
+    std::size_t                 m_max_decode_concurrency { 0 };
+
+    ContentFileIndex            m_file_index;
+    ContentDependencyGraph      m_dependency_graph;
+    ContentTracer               m_content_tracer;
+    DerivedDataCache            m_derived_data_cache;
+
+    // Written on the main thread, read by workers and the content watcher
+    std::vector<std::shared_ptr<ContentArchive>> m_hosted_content_archives;
+    mutable std::shared_mutex                   m_hosted_content_mutex;
+
+    std::map<std::string, BundleContentType>                    m_bundle_content_types;
+    std::map<io::Path, LoadedBundle>                            m_bundles;
+    std::map<std::pair<std::string, io::Path>, std::size_t>     m_bundle_content_references;
+    std::mutex                                                  m_bundle_mutex;
 
-    ContentLoaderRegistry   m_content_loader_registry;
-    ContentCacheRegistry    m_content_cache_registry;
+    std::vector<ContentReloader>    m_content_reloaders;
+    std::unique_ptr<ContentWatcher> m_content_watcher;
+    HotReloadStatistics             m_hot_reload_statistics;
+    std::mutex                      m_hot_reload_statistics_mutex;
 };
 
 
@@ -0,0 +1,256 @@
+#include "content_trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+std::atomic<uint32_t> n_threads { 0 };
+
+thread_local const uint32_t current_thread_index { n_threads++ };
+thread_local const ContentTraceScope* current_load { nullptr };
+thread_local uint32_t current_depth { 0 };
+
+//----------------------------------------------------------------
+std::string escape_json( const std::string& string )
+{
+    auto escaped = std::string { };
+    escaped.reserve( string.size() );
+    for ( const auto character : string )
+    {
+        switch ( character )
+        {
+        case '"':   escaped += "\\\""; break;
+        case '\\':  escaped += "\\\\"; break;
+        case '\n':  escaped += "\\n";  break;
+        case '\t':  escaped += "\\t";  break;
+        default:    escaped += character;
+        }
+    }
+    return escaped;
+}
+
+//----------------------------------------------------------------
+double to_microseconds( const ContentTracer::Clock::duration duration )
+{
+    return std::chrono::duration<double, std::micro> { duration }.count();
+}
+
+//----------------------------------------------------------------
+double to_milliseconds( const ContentTracer::Clock::duration duration )
+{
+    return std::chrono::duration<double, std::milli> { duration }.count();
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+const char* to_string( const ContentTracePhase phase )
+{
+    switch ( phase )
+    {
+    case ContentTracePhase::Load:           return "load";
+    case ContentTracePhase::ResolvePath:    return "resolve_path";
+    case ContentTracePhase::ReadFile:       return "read_file";
+    case ContentTracePhase::Decode:         return "decode";
+    case ContentTracePhase::UploadQueue:    return "upload_queue";
+    case ContentTracePhase::Upload:         return "upload";
+    }
+    CHECK_FAIL( "Unknown content trace phase." );
+    return ""; // to shut up warning
+}
+
+//----------------------------------------------------------------
+void ContentTracer::set_enabled( const bool is_enabled )
+{
+    if ( is_enabled && !this->is_enabled() ) { clear(); }
+    m_is_enabled.store( is_enabled, std::memory_order_relaxed );
+}
+
+//----------------------------------------------------------------
+void ContentTracer::record
+(
+    const ContentTracePhase     phase,
+    const io::Path&             asset,
+    const io::Path&             path,
+    const Clock::time_point     begin,
+    const Clock::time_point     end,
+    const uint64_t              n_bytes
+)
+{
+    if ( !is_enabled() ) { return; }
+    record( ContentTraceEvent { phase, asset, path, begin, end, n_bytes, current_thread_index, current_depth } );
+}
+
+//----------------------------------------------------------------
+void ContentTracer::record( ContentTraceEvent event )
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    m_events.emplace_back( std::move( event ) );
+}
+
+//----------------------------------------------------------------
+std::vector<ContentTraceEvent> ContentTracer::get_events() const
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    return m_events;
+}
+
+//----------------------------------------------------------------
+void ContentTracer::clear()
+{
+    const auto lock = std::lock_guard<std::mutex> { m_mutex };
+    m_events.clear();
+    m_start = Clock::now();
+}
+
+//----------------------------------------------------------------
+void ContentTracer::write_chrome_trace( const io::Path& trace_path ) const
+{
+    auto events = std::vector<ContentTraceEvent> { };
+    auto start  = Clock::time_point { };
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_mutex };
+        events  = m_events;
+        start   = m_start;
+    }
+
+    auto stream = std::ofstream( trace_path.get_string() );
+    CHECK( stream.good(), "Could not write content trace: " + trace_path.get_string() );
+
+    stream << "{\"traceEvents\":[";
+    for ( std::size_t event_index = 0; event_index < events.size(); ++event_index )
+    {
+        const auto& event = events[ event_index ];
+        // loads are named after their content, phases after what they do
+        const auto& name = event.phase == ContentTracePhase::Load ? event.asset.get_string() : std::string { to_string( event.phase ) };
+
+        stream
+            << ( event_index == 0 ? "" : "," ) << "\n"
+            << "{\"name\":\"" << escape_json( name ) << "\""
+            << ",\"cat\":\"" << to_string( event.phase ) << "\""
+            << ",\"ph\":\"X\""
+            << ",\"ts\":" << std::fixed << std::setprecision( 3 ) << to_microseconds( event.begin - start )
+            << ",\"dur\":" << to_microseconds( event.end - event.begin )
+            << ",\"pid\":0"
+            << ",\"tid\":" << event.thread_index
+            << ",\"args\":{\"asset\":\"" << escape_json( event.asset.get_string() ) << "\""
+            << ",\"path\":\"" << escape_json( event.path.get_string() ) << "\""
+            << ",\"bytes\":" << event.n_bytes
+            << ",\"depth\":" << event.depth << "}}";
+    }
+    stream << "\n]}\n";
+}
+
+//----------------------------------------------------------------
+std::string ContentTracer::get_summary() const
+{
+    constexpr auto n_phases = static_cast<std::size_t>( ContentTracePhase::Upload ) + 1;
+
+    struct AssetSummary
+    {
+        std::size_t                 n_loads         { };
+        std::array<double, n_phases> milliseconds   { };
+        uint64_t                    n_bytes_read    { };
+    };
+
+    auto asset_summaries = std::map<std::string, AssetSummary> { };
+    for ( const auto& event : get_events() )
+    {
+        auto& asset_summary = asset_summaries[ event.asset.get_string() ];
+        asset_summary.milliseconds[ static_cast<std::size_t>( event.phase ) ] += to_milliseconds( event.end - event.begin );
+        if ( event.phase == ContentTracePhase::Load     ) { ++asset_summary.n_loads; }
+        if ( event.phase == ContentTracePhase::ReadFile ) { asset_summary.n_bytes_read += event.n_bytes; }
+    }
+
+    auto sorted_summaries = std::vector<std::pair<std::string, AssetSummary>> { asset_summaries.begin(), asset_summaries.end() };
+    std::sort( sorted_summaries.begin(), sorted_summaries.end(), []( const auto& a, const auto& b )
+    {
+        return a.second.milliseconds[ 0 ] > b.second.milliseconds[ 0 ];
+    } );
+
+    auto stream = std::ostringstream { };
+    stream << std::left << std::setw( 48 ) << "asset" << std::right << std::setw( 8 ) << "loads";
+    for ( std::size_t phase_index = 0; phase_index < n_phases; ++phase_index )
+    {
+        stream << std::setw( 18 ) << ( std::string { to_string( static_cast<ContentTracePhase>( phase_index ) ) } + " ms" );
+    }
+    stream << std::setw( 18 ) << "bytes read" << "\n";
+
+    stream << std::fixed << std::setprecision( 3 );
+    for ( const auto& [ asset, asset_summary ] : sorted_summaries )
+    {
+        stream << std::left << std::setw( 48 ) << asset << std::right << std::setw( 8 ) << asset_summary.n_loads;
+        for ( const auto milliseconds : asset_summary.milliseconds ) { stream << std::setw( 18 ) << milliseconds; }
+        stream << std::setw( 18 ) << asset_summary.n_bytes_read << "\n";
+    }
+    return stream.str();
+}
+
+//----------------------------------------------------------------
+ContentTraceScope::ContentTraceScope( ContentTracer& tracer, const ContentTracePhase phase, const io::Path& path )
+    : m_previous_load   { current_load }
+    , m_previous_depth  { current_depth }
+{
+    if ( !tracer.is_enabled() ) { return; }
+
+    m_tracer                = &tracer;
+    m_event.phase           = phase;
+    m_event.path            = path;
+    m_event.thread_index    = current_thread_index;
+    m_event.depth           = current_depth;
+
+    // an upload outside of any load, such as one run by process_uploads(), finishes the load of its content
+    if ( phase == ContentTracePhase::Load || ( phase == ContentTracePhase::Upload && current_load == nullptr ) )
+    {
+        m_event.asset = path;
+        current_load = this;
+        ++current_depth;
+    }
+    else
+    {
+        // phases outside of any load, such as resolving a path from user code, are their own asset
+        m_event.asset = current_load != nullptr ? current_load->m_event.asset : path;
+    }
+
+    m_event.begin = ContentTracer::Clock::now();
+}
+
+//----------------------------------------------------------------
+ContentTraceScope::ContentTraceScope( const ContentTraceScope* load )
+    : m_previous_load   { current_load }
+    , m_previous_depth  { current_depth }
+{
+    if ( load == nullptr ) { return; }
+    current_load    = load;
+    current_depth   = load->m_event.depth + 1;
+}
+
+//----------------------------------------------------------------
+ContentTraceScope::~ContentTraceScope()
+{
+    current_load    = m_previous_load;
+    current_depth   = m_previous_depth;
+    if ( m_tracer == nullptr ) { return; }
+
+    m_event.end = ContentTracer::Clock::now();
+    m_tracer->record( std::move( m_event ) );
+}
+
+//----------------------------------------------------------------
+const ContentTraceScope* ContentTraceScope::get_current_load()
+{
+    return current_load;
+}
+
+} // namespace content
+} // namespace shake
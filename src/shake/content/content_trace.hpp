@@ -0,0 +1,147 @@
+#ifndef CONTENT_TRACE_HPP
+#define CONTENT_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+//----------------------------------------------------------------
+// Loads are only instrumented when SHAKE_CONTENT_TRACING is defined,
+// otherwise the instrumentation is compiled out entirely.
+// Instrumented builds record nothing until tracing is enabled on the tracer.
+#if defined( SHAKE_CONTENT_TRACING )
+    #define CONTENT_TRACE_ONLY( ... ) __VA_ARGS__
+#else
+    #define CONTENT_TRACE_ONLY( ... )
+#endif
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+enum class ContentTracePhase
+{
+    // the whole load of some content, on one thread
+    Load,
+    ResolvePath,
+    ReadFile,
+    Decode,
+    // from when decoded content is queued, until its upload starts
+    UploadQueue,
+    Upload
+};
+
+const char* to_string( const ContentTracePhase phase );
+
+//----------------------------------------------------------------
+struct ContentTraceEvent
+{
+    using Clock = std::chrono::steady_clock;
+
+    ContentTracePhase   phase           { };
+    // the content that was being loaded
+    io::Path            asset           { };
+    // the path the phase worked on, such as a file that was read for the asset
+    io::Path            path            { };
+    Clock::time_point   begin           { };
+    Clock::time_point   end             { };
+    uint64_t            n_bytes         { };
+    uint32_t            thread_index    { };
+    // how many loads the event is nested in, such as a texture load in the load of a material
+    uint32_t            depth           { };
+};
+
+//----------------------------------------------------------------
+// Collects the trace events of content loads, from all threads.
+class ContentTracer
+{
+public:
+    using Clock = ContentTraceEvent::Clock;
+
+    ContentTracer() = default;
+    NON_COPYABLE( ContentTracer )
+
+    //----------------------------------------------------------------
+    // Enabling tracing clears the events recorded before
+    void set_enabled( const bool is_enabled );
+    inline bool is_enabled() const { return m_is_enabled.load( std::memory_order_relaxed ); }
+
+    //----------------------------------------------------------------
+    // Records an event that was not measured by a scope, on the calling thread
+    void record
+    (
+        const ContentTracePhase     phase,
+        const io::Path&             asset,
+        const io::Path&             path,
+        const Clock::time_point     begin,
+        const Clock::time_point     end,
+        const uint64_t              n_bytes = 0
+    );
+
+    void record( ContentTraceEvent event );
+
+    //----------------------------------------------------------------
+    std::vector<ContentTraceEvent> get_events() const;
+    void clear();
+
+    //----------------------------------------------------------------
+    // Writes the events in the Chrome trace event format,
+    // to open in chrome://tracing or Perfetto.
+    // Nested loads show up nested on the thread that loaded them.
+    void write_chrome_trace( const io::Path& trace_path ) const;
+
+    //----------------------------------------------------------------
+    // A table of the time spent per phase for every loaded asset, slowest first.
+    // Times include the loads of nested content, such as the textures of a material.
+    std::string get_summary() const;
+
+private:
+    std::atomic<bool>               m_is_enabled    { false };
+    mutable std::mutex              m_mutex         { };
+    std::vector<ContentTraceEvent>  m_events        { };
+    Clock::time_point               m_start         { Clock::now() };
+};
+
+//----------------------------------------------------------------
+// Measures a phase of a load on the calling thread, and records it when the scope ends.
+// Phases within a Load scope are attributed to the content it loads.
+// So are those within an Upload scope that is not within a load, which finishes an asynchronous load
+// on the thread that processes uploads, without counting as another load.
+// Scopes do nothing when tracing is disabled.
+class ContentTraceScope
+{
+public:
+    ContentTraceScope( ContentTracer& tracer, const ContentTracePhase phase, const io::Path& path );
+
+    //----------------------------------------------------------------
+    // Continues a load on another thread, such as one that runs part of a ContentManager::parallel_for().
+    // Records nothing itself.
+    explicit ContentTraceScope( const ContentTraceScope* load );
+
+    ~ContentTraceScope();
+    NON_COPYABLE( ContentTraceScope )
+
+    //----------------------------------------------------------------
+    inline void set_n_bytes( const uint64_t n_bytes ) { m_event.n_bytes = n_bytes; }
+
+    //----------------------------------------------------------------
+    // The innermost Load scope on the calling thread, if any
+    static const ContentTraceScope* get_current_load();
+
+private:
+    ContentTracer*              m_tracer            { nullptr };
+    ContentTraceEvent           m_event             { };
+    const ContentTraceScope*    m_previous_load     { nullptr };
+    uint32_t                    m_previous_depth    { };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_TRACE_HPP
@@ -0,0 +1,139 @@
+#include "content_watcher.hpp"
+
+#include <array>
+#include <exception>
+#include <filesystem>
+#include <string>
+
+#if defined( __linux__ )
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "shake/core/contracts/contracts.hpp"
+#include "shake/core/log.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+ContentWatcher::ContentWatcher
+( 
+    const std::vector<io::Path>&        directories, 
+    OnFilesChanged                      on_files_changed, 
+    const std::chrono::milliseconds     debounce_duration 
+)
+    : m_on_files_changed    { std::move( on_files_changed ) }
+    , m_debounce_duration   { debounce_duration }
+{
+#if defined( __linux__ )
+    m_file_descriptor = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    CHECK_GE( m_file_descriptor, 0, "Could not initialize inotify." );
+
+    for ( const auto& directory : directories )
+    {
+        // hosted archives are regular files, they are not watched
+        if ( std::filesystem::is_directory( directory.get_string() ) ) { add_watches( directory.get_string() ); }
+    }
+
+    m_thread = std::thread { [ this ]() { run(); } };
+#else
+    static_cast<void>( directories );
+    LOG( "Watching content is not supported on this platform, content will not be hot reloaded." );
+#endif
+}
+
+//----------------------------------------------------------------
+ContentWatcher::~ContentWatcher()
+{
+    m_is_stopping = true;
+    if ( m_thread.joinable() ) { m_thread.join(); }
+#if defined( __linux__ )
+    if ( m_file_descriptor >= 0 ) { close( m_file_descriptor ); }
+#endif
+}
+
+//----------------------------------------------------------------
+// Inotify does not watch recursively, so every directory gets a watch of its own
+void ContentWatcher::add_watches( const std::string& directory )
+{
+#if defined( __linux__ )
+    const auto add_watch = [ this ]( const std::string& watched_directory )
+    {
+        const auto watch_descriptor = inotify_add_watch( m_file_descriptor, watched_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE );
+        if ( watch_descriptor >= 0 ) { m_watched_directories[ watch_descriptor ] = watched_directory; }
+    };
+
+    add_watch( directory );
+    auto error = std::error_code { };
+    for ( auto it = std::filesystem::recursive_directory_iterator( directory, error ); !error && it != std::filesystem::recursive_directory_iterator(); it.increment( error ) )
+    {
+        if ( it->is_directory() ) { add_watch( it->path().string() ); }
+    }
+#else
+    static_cast<void>( directory );
+#endif
+}
+
+//----------------------------------------------------------------
+void ContentWatcher::run()
+{
+#if defined( __linux__ )
+    // changed files, and when they first changed, since the last report
+    auto changed_files  = std::map<std::string, Clock::time_point> { };
+    auto last_change    = Clock::time_point { };
+
+    // events are aligned like the struct, so they can be read in place
+    alignas( inotify_event ) auto buffer = std::array<char, 4096> { };
+
+    while ( !m_is_stopping )
+    {
+        // wake up regularly, to check whether to stop or to report
+        auto poll_descriptor = pollfd { m_file_descriptor, POLLIN, 0 };
+        const auto timeout = static_cast<int>( m_debounce_duration.count() );
+        if ( poll( &poll_descriptor, 1, timeout ) > 0 )
+        {
+            const auto n_bytes = read( m_file_descriptor, buffer.data(), buffer.size() );
+            const auto now = Clock::now();
+            for ( auto offset = ssize_t { 0 }; offset < n_bytes; )
+            {
+                const auto event = reinterpret_cast<const inotify_event*>( buffer.data() + offset );
+                offset += static_cast<ssize_t>( sizeof( inotify_event ) + event->len );
+
+                const auto directory_it = m_watched_directories.find( event->wd );
+                if ( event->len == 0 || directory_it == m_watched_directories.end() ) { continue; }
+
+                const auto path = directory_it->second + "/" + event->name;
+                if ( event->mask & IN_ISDIR )
+                {
+                    // files written into a new directory need a watch on it
+                    if ( event->mask & IN_CREATE ) { add_watches( path ); }
+                    continue;
+                }
+                if ( event->mask & ( IN_CLOSE_WRITE | IN_MOVED_TO ) )
+                {
+                    changed_files.emplace( path, now );
+                    last_change = now;
+                }
+            }
+        }
+
+        if ( !changed_files.empty() && Clock::now() - last_change >= m_debounce_duration )
+        {
+            auto changes = std::vector<std::pair<io::Path, Clock::time_point>> { };
+            changes.reserve( changed_files.size() );
+            for ( const auto& [ path, changed_at ] : changed_files ) { changes.emplace_back( io::Path { path }, changed_at ); }
+            changed_files.clear();
+
+            // a failed reload must not end this thread, and with it the application
+            try                                       { m_on_files_changed( changes ); }
+            catch ( const std::exception& exception ) { LOG( std::string { "Could not handle changed content: " } + exception.what() ); }
+            catch ( ... )                             { LOG( "Could not handle changed content." ); }
+        }
+    }
+#endif
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,68 @@
+#ifndef CONTENT_WATCHER_HPP
+#define CONTENT_WATCHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+struct HotReloadStatistics
+{
+    std::size_t n_reloads               { };
+    std::size_t n_failed_reloads        { };
+    // From the file being saved, to the new content replacing the old in the cache
+    double      mean_latency_seconds    { };
+    double      max_latency_seconds     { };
+};
+
+//----------------------------------------------------------------
+// Watches directories, and everything below them, for files that are written or moved into place,
+// and reports them on a thread of its own.
+// Changes are reported once no new changes came in for the debounce duration,
+// as editors often write a file in several steps.
+// Exceptions thrown while handling changes are logged, and the watcher keeps watching.
+// Uses inotify, on other platforms nothing is reported.
+class ContentWatcher
+{
+public:
+    using Clock             = std::chrono::steady_clock;
+    // Called with the full paths of the changed files, and when each of them first changed
+    using OnFilesChanged    = std::function<void( const std::vector<std::pair<io::Path, Clock::time_point>>& )>;
+
+public:
+    ContentWatcher
+    ( 
+        const std::vector<io::Path>&        directories, 
+        OnFilesChanged                      on_files_changed, 
+        const std::chrono::milliseconds     debounce_duration = std::chrono::milliseconds { 50 } 
+    );
+    ~ContentWatcher();
+    NON_COPYABLE( ContentWatcher )
+
+private:
+    void run();
+    void add_watches( const std::string& directory );
+
+private:
+    OnFilesChanged                  m_on_files_changed;
+    std::chrono::milliseconds       m_debounce_duration;
+    int                             m_file_descriptor       { -1 };
+    std::map<int, std::string>      m_watched_directories   { };
+    std::atomic<bool>               m_is_stopping           { false };
+    std::thread                     m_thread;
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // CONTENT_WATCHER_HPP
@@ -0,0 +1,399 @@
+#include "cook_mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/content/mesh_optimizer.hpp"
+#include "shake/content/mesh_simplifier.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+//----------------------------------------------------------------
+uint64_t align_up( const uint64_t offset, const uint64_t alignment )
+{
+    return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+//----------------------------------------------------------------
+void write_padding( std::vector<uint8_t>& bytes, const uint64_t alignment )
+{
+    bytes.resize( align_up( bytes.size(), alignment ), 0 );
+}
+
+//----------------------------------------------------------------
+template<typename T>
+void write_stream( std::vector<uint8_t>& bytes, const std::vector<T>& values )
+{
+    const auto value_bytes = reinterpret_cast<const uint8_t*>( values.data() );
+    bytes.insert( bytes.end(), value_bytes, value_bytes + values.size() * sizeof( T ) );
+}
+
+//----------------------------------------------------------------
+uint16_t quantize_unorm16( const float value, const float min, const float max )
+{
+    if ( max <= min ) { return 0; }
+    const auto normalized = std::clamp( ( value - min ) / ( max - min ), 0.f, 1.f );
+    return static_cast<uint16_t>( std::lround( normalized * 65535.f ) );
+}
+
+//----------------------------------------------------------------
+int16_t quantize_snorm16( const float value )
+{
+    return static_cast<int16_t>( std::lround( std::clamp( value, -1.f, 1.f ) * 32767.f ) );
+}
+
+//----------------------------------------------------------------
+// Projects the normal onto an octahedron, and folds its lower half over the upper half
+glm::vec2 encode_octahedron( const glm::vec3& normal )
+{
+    const auto sign = []( const float value ) { return value < 0.f ? -1.f : 1.f; };
+
+    const auto n_l1 = std::abs( normal.x ) + std::abs( normal.y ) + std::abs( normal.z );
+    if ( n_l1 <= 0.f ) { return glm::vec2 { 0.f, 0.f }; }
+
+    auto x = normal.x / n_l1;
+    auto y = normal.y / n_l1;
+    if ( normal.z < 0.f )
+    {
+        const auto folded_x = ( 1.f - std::abs( y ) ) * sign( x );
+        const auto folded_y = ( 1.f - std::abs( x ) ) * sign( y );
+        x = folded_x;
+        y = folded_y;
+    }
+    return glm::vec2 { x, y };
+}
+
+//----------------------------------------------------------------
+// Face corners are v, v/vt, v//vn or v/vt/vn, with 1 based indices, or negative ones counting back from the last
+struct ObjCorner
+{
+    int position    { 0 };
+    int uv          { 0 };
+    int normal      { 0 };
+};
+
+ObjCorner parse_obj_corner( const std::string& corner_str )
+{
+    auto corner = ObjCorner { };
+    auto fields = std::istringstream { corner_str };
+    auto field  = std::string { };
+    for ( int* index : { &corner.position, &corner.uv, &corner.normal } )
+    {
+        if ( !std::getline( fields, field, '/' ) ) { break; }
+        if ( !field.empty() ) { *index = std::stoi( field ); }
+    }
+    return corner;
+}
+
+//----------------------------------------------------------------
+template<typename T>
+const T& get_obj_element( const std::vector<T>& elements, const int index, const std::string& element_name )
+{
+    const auto resolved_index = index < 0
+        ? static_cast<int64_t>( elements.size() ) + index
+        : static_cast<int64_t>( index ) - 1;
+    CHECK( resolved_index >= 0 && resolved_index < static_cast<int64_t>( elements.size() ), "Obj face refers to a missing " + element_name + "." );
+    return elements[ static_cast<std::size_t>( resolved_index ) ];
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+Mesh parse_obj( const std::string_view obj )
+{
+    auto positions  = std::vector<glm::vec3> { };
+    auto normals    = std::vector<glm::vec3> { };
+    auto uvs        = std::vector<glm::vec2> { };
+    auto corners    = std::vector<ObjCorner> { };
+
+    auto lines  = std::istringstream { std::string { obj } };
+    auto line   = std::string { };
+    auto face   = std::vector<ObjCorner> { };
+    while ( std::getline( lines, line ) )
+    {
+        auto tokens = std::istringstream { line };
+        auto keyword = std::string { };
+        tokens >> keyword;
+
+        if ( keyword == "v" )
+        {
+            auto position = glm::vec3 { 0.f };
+            tokens >> position.x >> position.y >> position.z;
+            positions.emplace_back( position );
+        }
+        else if ( keyword == "vn" )
+        {
+            auto normal = glm::vec3 { 0.f };
+            tokens >> normal.x >> normal.y >> normal.z;
+            normals.emplace_back( normal );
+        }
+        else if ( keyword == "vt" )
+        {
+            auto uv = glm::vec2 { 0.f, 0.f };
+            tokens >> uv.x >> uv.y;
+            uvs.emplace_back( uv );
+        }
+        else if ( keyword == "f" )
+        {
+            face.clear();
+            auto corner_str = std::string { };
+            while ( tokens >> corner_str ) { face.emplace_back( parse_obj_corner( corner_str ) ); }
+            CHECK( face.size() >= 3, "Obj face has fewer than 3 corners." );
+
+            for ( std::size_t corner_index = 1; corner_index + 1 < face.size(); ++corner_index )
+            {
+                corners.emplace_back( face[ 0 ] );
+                corners.emplace_back( face[ corner_index ] );
+                corners.emplace_back( face[ corner_index + 1 ] );
+            }
+        }
+    }
+
+    const auto has_normals  = !normals.empty()  && std::all_of( corners.begin(), corners.end(), []( const ObjCorner& corner ) { return corner.normal != 0; } );
+    const auto has_uvs      = !uvs.empty()      && std::all_of( corners.begin(), corners.end(), []( const ObjCorner& corner ) { return corner.uv     != 0; } );
+
+    auto mesh = Mesh { };
+    mesh.positions.reserve( corners.size() );
+    mesh.indices.reserve( corners.size() );
+    for ( const auto& corner : corners )
+    {
+        mesh.indices.emplace_back( static_cast<uint32_t>( mesh.positions.size() ) );
+        mesh.positions.emplace_back( get_obj_element( positions, corner.position, "position" ) );
+        if ( has_normals )  { mesh.normals.emplace_back( get_obj_element( normals, corner.normal, "normal" ) ); }
+        if ( has_uvs )      { mesh.uvs.emplace_back( get_obj_element( uvs, corner.uv, "texture coordinate" ) ); }
+    }
+    return mesh;
+}
+
+//----------------------------------------------------------------
+std::vector<uint8_t> serialize_mesh( const Mesh& mesh, const mesh_format::AttributeFormat attribute_format )
+{
+    CHECK( mesh.get_n_vertices() <= std::numeric_limits<uint32_t>::max(), "Mesh has too many vertices to cook." );
+    CHECK( !mesh.has_normals()  || mesh.normals.size()  == mesh.get_n_vertices(), "Mesh should have one normal per vertex." );
+    CHECK( !mesh.has_uvs()      || mesh.uvs.size()      == mesh.get_n_vertices(), "Mesh should have one texture coordinate per vertex." );
+    CHECK_LE( mesh.lods.size(), mesh_format::max_n_lods, "Mesh has too many levels of detail to cook." );
+
+    // a mesh without levels of detail is a single level
+    const auto lods = mesh.has_lods() ? mesh.lods : std::vector<MeshLod> { MeshLod { 0, mesh.indices.size(), mesh.get_n_vertices(), 0.f } };
+    for ( std::size_t lod_index = 0; lod_index < lods.size(); ++lod_index )
+    {
+        const auto& lod = lods[ lod_index ];
+        CHECK_LE( lod.first_index + lod.n_indices, mesh.indices.size(), "Level of detail refers to missing indices." );
+        CHECK( lod_index == 0 ? lod.n_vertices == mesh.get_n_vertices() : lod.n_vertices <= lods[ lod_index - 1 ].n_vertices, "Coarser levels of detail should use the first vertices of finer levels, optimize the mesh first." );
+        for ( auto index_index = lod.first_index; index_index < lod.first_index + lod.n_indices; ++index_index )
+        {
+            CHECK_LT( mesh.indices[ index_index ], lod.n_vertices, "Level of detail uses vertices after its own, optimize the mesh first." );
+        }
+    }
+
+    const auto is_quantized = attribute_format == mesh_format::AttributeFormat::Quantized;
+    const auto index_size   = mesh.get_n_vertices() <= std::numeric_limits<uint16_t>::max() + std::size_t { 1 } ? sizeof( uint16_t ) : sizeof( uint32_t );
+
+    auto header = mesh_format::Header { };
+    header.magic            = mesh_format::magic;
+    header.version          = mesh_format::version;
+    header.n_vertices       = static_cast<uint32_t>( mesh.get_n_vertices() );
+    header.n_lods           = static_cast<uint32_t>( lods.size() );
+    header.index_size       = static_cast<uint32_t>( index_size );
+    header.attribute_format = static_cast<uint32_t>( attribute_format );
+    header.has_normals      = mesh.has_normals()    ? 1 : 0;
+    header.has_uvs          = mesh.has_uvs()        ? 1 : 0;
+
+    // bounds are stored for float meshes too, for culling
+    for ( int axis = 0; axis < 3; ++axis )
+    {
+        header.position_min[ axis ] = mesh.positions.empty() ? 0.f : std::numeric_limits<float>::max();
+        header.position_max[ axis ] = mesh.positions.empty() ? 0.f : std::numeric_limits<float>::lowest();
+        for ( const auto& position : mesh.positions )
+        {
+            header.position_min[ axis ] = std::min( header.position_min[ axis ], position[ axis ] );
+            header.position_max[ axis ] = std::max( header.position_max[ axis ], position[ axis ] );
+        }
+    }
+    for ( int axis = 0; axis < 2; ++axis )
+    {
+        header.uv_min[ axis ] = mesh.uvs.empty() ? 0.f : std::numeric_limits<float>::max();
+        header.uv_max[ axis ] = mesh.uvs.empty() ? 0.f : std::numeric_limits<float>::lowest();
+        for ( const auto& uv : mesh.uvs )
+        {
+            header.uv_min[ axis ] = std::min( header.uv_min[ axis ], uv[ axis ] );
+            header.uv_max[ axis ] = std::max( header.uv_max[ axis ], uv[ axis ] );
+        }
+    }
+
+    // the header and level table are written last, once the stream offsets are known
+    auto lod_headers = std::vector<mesh_format::Lod>( lods.size(), mesh_format::Lod { } );
+    auto bytes = std::vector<uint8_t>( sizeof( header ) + lods.size() * sizeof( mesh_format::Lod ), 0 );
+
+    const auto write_positions = [ & ]( const std::size_t first_vertex, const std::size_t end_vertex )
+    {
+        if ( !is_quantized )
+        {
+            write_stream( bytes, std::vector<glm::vec3>( mesh.positions.begin() + first_vertex, mesh.positions.begin() + end_vertex ) );
+            return;
+        }
+
+        auto quantized_positions = std::vector<uint16_t>( ( end_vertex - first_vertex ) * 4, 0 );
+        for ( auto vertex = first_vertex; vertex < end_vertex; ++vertex )
+        {
+            for ( int axis = 0; axis < 3; ++axis )
+            {
+                quantized_positions[ ( vertex - first_vertex ) * 4 + axis ] = quantize_unorm16( mesh.positions[ vertex ][ axis ], header.position_min[ axis ], header.position_max[ axis ] );
+            }
+        }
+        write_stream( bytes, quantized_positions );
+    };
+
+    const auto write_normals = [ & ]( const std::size_t first_vertex, const std::size_t end_vertex )
+    {
+        if ( !is_quantized )
+        {
+            write_stream( bytes, std::vector<glm::vec3>( mesh.normals.begin() + first_vertex, mesh.normals.begin() + end_vertex ) );
+            return;
+        }
+
+        auto quantized_normals = std::vector<int16_t>( ( end_vertex - first_vertex ) * 2 );
+        for ( auto vertex = first_vertex; vertex < end_vertex; ++vertex )
+        {
+            const auto encoded_normal = encode_octahedron( mesh.normals[ vertex ] );
+            quantized_normals[ ( vertex - first_vertex ) * 2     ] = quantize_snorm16( encoded_normal.x );
+            quantized_normals[ ( vertex - first_vertex ) * 2 + 1 ] = quantize_snorm16( encoded_normal.y );
+        }
+        write_stream( bytes, quantized_normals );
+    };
+
+    const auto write_uvs = [ & ]( const std::size_t first_vertex, const std::size_t end_vertex )
+    {
+        if ( !is_quantized )
+        {
+            write_stream( bytes, std::vector<glm::vec2>( mesh.uvs.begin() + first_vertex, mesh.uvs.begin() + end_vertex ) );
+            return;
+        }
+
+        auto quantized_uvs = std::vector<uint16_t>( ( end_vertex - first_vertex ) * 2 );
+        for ( auto vertex = first_vertex; vertex < end_vertex; ++vertex )
+        {
+            quantized_uvs[ ( vertex - first_vertex ) * 2     ] = quantize_unorm16( mesh.uvs[ vertex ].x, header.uv_min[ 0 ], header.uv_max[ 0 ] );
+            quantized_uvs[ ( vertex - first_vertex ) * 2 + 1 ] = quantize_unorm16( mesh.uvs[ vertex ].y, header.uv_min[ 1 ], header.uv_max[ 1 ] );
+        }
+        write_stream( bytes, quantized_uvs );
+    };
+
+    // coarsest level first, each adding the vertices after those of the coarser levels
+    for ( auto lod_index = lods.size(); lod_index-- > 0; )
+    {
+        const auto& lod         = lods[ lod_index ];
+        auto&       lod_header  = lod_headers[ lod_index ];
+        const auto first_vertex = lod_index + 1 < lods.size() ? lods[ lod_index + 1 ].n_vertices : std::size_t { 0 };
+
+        lod_header.n_indices    = static_cast<uint32_t>( lod.n_indices );
+        lod_header.n_vertices   = static_cast<uint32_t>( lod.n_vertices );
+        lod_header.error        = lod.error;
+
+        write_padding( bytes, mesh_format::stream_alignment );
+        lod_header.position_offset = bytes.size();
+        write_positions( first_vertex, lod.n_vertices );
+
+        if ( mesh.has_normals() )
+        {
+            write_padding( bytes, mesh_format::stream_alignment );
+            lod_header.normal_offset = bytes.size();
+            write_normals( first_vertex, lod.n_vertices );
+        }
+
+        if ( mesh.has_uvs() )
+        {
+            write_padding( bytes, mesh_format::stream_alignment );
+            lod_header.uv_offset = bytes.size();
+            write_uvs( first_vertex, lod.n_vertices );
+        }
+
+        write_padding( bytes, mesh_format::stream_alignment );
+        lod_header.index_offset = bytes.size();
+        const auto first_index  = mesh.indices.begin() + lod.first_index;
+        if ( index_size == sizeof( uint16_t ) )
+        {
+            write_stream( bytes, std::vector<uint16_t>( first_index, first_index + lod.n_indices ) );
+        }
+        else { write_stream( bytes, std::vector<uint32_t>( first_index, first_index + lod.n_indices ) ); }
+    }
+
+    std::memcpy( bytes.data(), &header, sizeof( header ) );
+    std::memcpy( bytes.data() + sizeof( header ), lod_headers.data(), lod_headers.size() * sizeof( mesh_format::Lod ) );
+    return bytes;
+}
+
+//----------------------------------------------------------------
+void cook_mesh
+(
+    const io::Path&                     content_directory,
+    const io::Path&                     mesh_path,
+    const io::Path&                     cooked_mesh_path,
+    const mesh_format::AttributeFormat  attribute_format
+)
+{
+    const auto obj_path = std::filesystem::path( ( content_directory / mesh_path ).get_string() );
+    auto obj_stream = std::ifstream( obj_path, std::ios::binary );
+    CHECK( obj_stream.is_open(), "Could not open mesh file: " + obj_path.string() );
+    const auto obj = std::string( std::istreambuf_iterator<char>( obj_stream ), std::istreambuf_iterator<char>() );
+
+    auto mesh = parse_obj( obj );
+    weld_vertices( mesh );
+    generate_mesh_lods( mesh );
+    optimize_mesh( mesh );
+    if ( attribute_format == mesh_format::AttributeFormat::Quantized )
+    {
+        for ( auto& normal : mesh.normals )
+        {
+            const auto length = glm::length( normal );
+            if ( length > 0.f ) { normal = normal * ( 1.f / length ); }
+        }
+    }
+    const auto bytes = serialize_mesh( mesh, attribute_format );
+
+    std::filesystem::create_directories( std::filesystem::path( cooked_mesh_path.get_string() ).parent_path() );
+    auto stream = std::ofstream( cooked_mesh_path.get_string(), std::ios::binary );
+    CHECK( stream.is_open(), "Could not create cooked mesh: " + cooked_mesh_path.get_string() );
+    stream.write( reinterpret_cast<const char*>( bytes.data() ), static_cast<std::streamsize>( bytes.size() ) );
+    CHECK( stream.good(), "Could not write cooked mesh: " + cooked_mesh_path.get_string() );
+}
+
+//----------------------------------------------------------------
+std::size_t cook_meshes( const io::Path& content_directory, const io::Path& output_directory )
+{
+    const auto directory = std::filesystem::path( content_directory.get_string() );
+    std::size_t n_cooked_meshes { 0 };
+
+    for ( const auto& directory_entry : std::filesystem::recursive_directory_iterator( directory ) )
+    {
+        if ( !directory_entry.is_regular_file() || directory_entry.path().extension() != ".obj" ) { continue; }
+
+        const auto mesh_path = directory_entry.path().lexically_relative( directory );
+        auto cooked_mesh_path = std::filesystem::path( output_directory.get_string() ) / mesh_path;
+        cooked_mesh_path.replace_extension( mesh_format::file_extension );
+
+        cook_mesh
+        (
+            content_directory,
+            io::Path { mesh_path.generic_string() },
+            io::Path { cooked_mesh_path.string() }
+        );
+        ++n_cooked_meshes;
+    }
+
+    return n_cooked_meshes;
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,49 @@
+#ifndef COOK_MESH_HPP
+#define COOK_MESH_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/mesh.hpp"
+#include "shake/content/mesh_format.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Parses a wavefront .obj file into a triangle soup, with three vertices per triangle.
+// Only positions, normals, texture coordinates and faces are read, polygons are triangulated as fans.
+// Normals and texture coordinates are kept if every face corner refers to one.
+Mesh parse_obj( const std::string_view obj );
+
+//----------------------------------------------------------------
+// Lays out a mesh as a cooked mesh (.smesh), with the vertices of coarser levels of detail first,
+// as optimize_mesh() orders them.
+// Quantizing requires unit length normals.
+std::vector<uint8_t> serialize_mesh( const Mesh& mesh, const mesh_format::AttributeFormat attribute_format );
+
+//----------------------------------------------------------------
+// Converts a mesh file (.obj) into a cooked mesh (.smesh),
+// welding its vertices, generating its levels of detail,
+// and optimizing it for the vertex cache, overdraw and vertex fetch.
+void cook_mesh
+(
+    const io::Path&                     content_directory,
+    const io::Path&                     mesh_path,
+    const io::Path&                     cooked_mesh_path,
+    const mesh_format::AttributeFormat  attribute_format = mesh_format::AttributeFormat::Quantized
+);
+
+//----------------------------------------------------------------
+// Cooks all mesh files in the content directory,
+// writing them to the same relative paths in the output directory, with the .smesh extension.
+// Returns the number of meshes that were cooked.
+std::size_t cook_meshes( const io::Path& content_directory, const io::Path& output_directory );
+
+} // namespace content
+} // namespace shake
+
+#endif // COOK_MESH_HPP
@@ -0,0 +1,146 @@
+#include "cook_texture.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/io/file_json.hpp"
+
+#include "shake/graphics/material/texture_parameters.hpp"
+
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/cooked_texture_format.hpp"
+#include "shake/content/load_image.hpp"
+#include "shake/content/load_texture.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+//----------------------------------------------------------------
+uint64_t align_up( const uint64_t offset, const uint64_t alignment )
+{
+    return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+//----------------------------------------------------------------
+ContentBytes read_file( const std::filesystem::path& path )
+{
+    auto stream = std::ifstream( path, std::ios::binary );
+    CHECK( stream.is_open(), "Could not open file: " + path.string() );
+    return ContentBytes::make_owning( std::vector<char>( std::istreambuf_iterator<char>( stream ), std::istreambuf_iterator<char>() ) );
+}
+
+//----------------------------------------------------------------
+// Texture files have a texture format, other files referring to a texture, such as sprites, don't
+bool is_texture_file( const json11::Json& json )
+{
+    return io::file::json::has_key( json, "texture" ) && io::file::json::has_key( json, "texture_format" );
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+void cook_texture( const io::Path& content_directory, const io::Path& texture_path, const io::Path& cooked_texture_path )
+{
+    const auto content = io::file::json::read( content_directory / texture_path );
+
+    const auto image_path               = io::file::json::read_as<std::string>  ( content, { "texture"             } );
+    const auto texture_format_str       = io::file::json::read_as<std::string>  ( content, { "texture_format"      } );
+    const auto interpolation_mode_str   = io::file::json::read_as<std::string>  ( content, { "interpolation_mode"  } );
+    const auto generate_mipmaps         = io::file::json::read_as<bool>         ( content, { "generate_mip_maps"   } );
+
+    const auto texture_format   = graphics::to_texture_format( texture_format_str );
+    const auto filter           = graphics::to_filter( interpolation_mode_str );
+
+    const auto image_bytes = read_file( std::filesystem::path( content_directory.get_string() ) / image_path );
+    auto mip_levels = std::vector<load::Image> { load::decode_image( image_bytes, load::to_n_channels( texture_format ) ) };
+
+    if ( generate_mipmaps )
+    {
+        while ( mip_levels.back().width > 1 || mip_levels.back().height > 1 )
+        {
+            mip_levels.emplace_back( load::downsample_image( mip_levels.back() ) );
+        }
+    }
+
+    // lay out the file
+    auto header = cooked_texture_format::Header
+    {
+        cooked_texture_format::magic,
+        cooked_texture_format::version,
+        static_cast<uint32_t>( texture_format ),
+        static_cast<uint32_t>( filter ),
+        static_cast<uint32_t>( mip_levels.front().n_channels ),
+        static_cast<uint32_t>( mip_levels.size() )
+    };
+
+    auto mip_level_headers = std::vector<cooked_texture_format::MipLevel> { };
+    auto offset = static_cast<uint64_t>( sizeof( header ) + mip_levels.size() * sizeof( cooked_texture_format::MipLevel ) );
+    for ( const auto& mip_level : mip_levels )
+    {
+        offset = align_up( offset, cooked_texture_format::pixel_alignment );
+        mip_level_headers.emplace_back( cooked_texture_format::MipLevel
+        {
+            offset,
+            mip_level.get_n_bytes(),
+            static_cast<uint32_t>( mip_level.width ),
+            static_cast<uint32_t>( mip_level.height )
+        } );
+        offset += mip_level.get_n_bytes();
+    }
+
+    // write the file
+    std::filesystem::create_directories( std::filesystem::path( cooked_texture_path.get_string() ).parent_path() );
+    auto stream = std::ofstream( cooked_texture_path.get_string(), std::ios::binary );
+    CHECK( stream.is_open(), "Could not create cooked texture: " + cooked_texture_path.get_string() );
+
+    stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    stream.write( reinterpret_cast<const char*>( mip_level_headers.data() ), static_cast<std::streamsize>( mip_level_headers.size() * sizeof( cooked_texture_format::MipLevel ) ) );
+
+    for ( std::size_t mip_level_index = 0; mip_level_index < mip_levels.size(); ++mip_level_index )
+    {
+        const auto n_padding_bytes = mip_level_headers[ mip_level_index ].offset - static_cast<uint64_t>( stream.tellp() );
+        const auto padding = std::string( n_padding_bytes, '\0' );
+        stream.write( padding.data(), static_cast<std::streamsize>( padding.size() ) );
+
+        const auto& mip_level = mip_levels[ mip_level_index ];
+        stream.write( reinterpret_cast<const char*>( mip_level.pixels.get() ), static_cast<std::streamsize>( mip_level.get_n_bytes() ) );
+    }
+
+    CHECK( stream.good(), "Could not write cooked texture: " + cooked_texture_path.get_string() );
+}
+
+//----------------------------------------------------------------
+std::size_t cook_textures( const io::Path& content_directory, const io::Path& output_directory )
+{
+    const auto directory = std::filesystem::path( content_directory.get_string() );
+    std::size_t n_cooked_textures { 0 };
+
+    for ( const auto& directory_entry : std::filesystem::recursive_directory_iterator( directory ) )
+    {
+        if ( !directory_entry.is_regular_file() || directory_entry.path().extension() != ".json" ) { continue; }
+        if ( !is_texture_file( io::file::json::read( io::Path { directory_entry.path().string() } ) ) ) { continue; }
+
+        const auto texture_path = directory_entry.path().lexically_relative( directory );
+        auto cooked_texture_path = std::filesystem::path( output_directory.get_string() ) / texture_path;
+        cooked_texture_path.replace_extension( cooked_texture_format::file_extension );
+
+        cook_texture
+        (
+            content_directory,
+            io::Path { texture_path.generic_string() },
+            io::Path { cooked_texture_path.string() }
+        );
+        ++n_cooked_textures;
+    }
+
+    return n_cooked_textures;
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,25 @@
+#ifndef COOK_TEXTURE_HPP
+#define COOK_TEXTURE_HPP
+
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Converts a texture file (.json), and the image it refers to, into a cooked texture (.stex).
+// The image is decoded with the channels of its texture format,
+// and its mip maps are generated if the texture file asks for them.
+// Paths in the texture file are relative to the content directory.
+void cook_texture( const io::Path& content_directory, const io::Path& texture_path, const io::Path& cooked_texture_path );
+
+//----------------------------------------------------------------
+// Cooks all texture files in the content directory,
+// writing them to the same relative paths in the output directory, with the .stex extension.
+// Returns the number of textures that were cooked.
+std::size_t cook_textures( const io::Path& content_directory, const io::Path& output_directory );
+
+} // namespace content
+} // namespace shake
+
+#endif // COOK_TEXTURE_HPP
@@ -0,0 +1,53 @@
+#ifndef COOKED_TEXTURE_FORMAT_HPP
+#define COOKED_TEXTURE_FORMAT_HPP
+
+#include <cstdint>
+
+namespace shake {
+namespace content {
+namespace cooked_texture_format {
+
+//----------------------------------------------------------------
+// Layout of a cooked texture (.stex):
+//
+//     Header
+//     MipLevel, for each mip level, starting at the full size level
+//     pixels of each mip level, each aligned to pixel_alignment
+//
+// Pixels are stored decoded, tightly packed, with one byte per channel,
+// so they can be uploaded without any further processing.
+// Texture format and filter are stored as the values of their graphics::gl enums,
+// so cooked textures need to be recooked when those enums change.
+
+constexpr uint32_t magic            = 0x58455453; // *reinterpret_cast<const uint32_t*>( "STEX" );
+constexpr uint32_t version          = 1;
+constexpr uint64_t pixel_alignment  = 16;
+
+constexpr const char* file_extension = ".stex";
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t texture_format;
+    uint32_t filter;
+    uint32_t n_channels;
+    uint32_t n_mip_levels;
+};
+
+struct MipLevel
+{
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+static_assert( sizeof( Header   ) == 24, "Unexpected padding in cooked texture header." );
+static_assert( sizeof( MipLevel ) == 24, "Unexpected padding in cooked texture mip level." );
+
+} // namespace cooked_texture_format
+} // namespace content
+} // namespace shake
+
+#endif // COOKED_TEXTURE_FORMAT_HPP
@@ -0,0 +1,139 @@
+#include "derived_data_cache.hpp"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "shake/core/log.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+// Increment when the layout of entries changes
+constexpr uint32_t entry_magic      = 0x43444453; // "SDDC"
+constexpr uint32_t entry_version    = 1;
+
+struct EntryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    int64_t  derive_nanoseconds;
+    uint64_t n_bytes;
+};
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+std::optional<ContentBytes> DerivedDataCache::find( const char* kind, const uint64_t key ) const
+{
+    if ( const auto entry = find_entry( kind, key ) ) { return entry->bytes; }
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+// Storing is best effort: the data was derived already,
+// so a cache directory that is read only or full must not fail the load
+void DerivedDataCache::store( const char* kind, const uint64_t key, const std::vector<uint8_t>& bytes, const std::chrono::nanoseconds derive_duration ) const
+{
+    if ( !is_enabled() ) { return; }
+
+    const auto path = get_path( kind, key );
+    auto error = std::error_code { };
+    std::filesystem::create_directories( std::filesystem::path( path.get_string() ).parent_path(), error );
+    if ( error )
+    {
+        LOG( "Could not create derived data directory for " + path.get_string() + ": " + error.message() );
+        return;
+    }
+
+    // write to a temporary file first, so an entry is either complete or absent,
+    // named per thread, as the same entry might be derived on several threads at once
+    const auto temporary_path = path.get_string() + "." + std::to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) ) + ".tmp";
+    {
+        auto stream = std::ofstream( temporary_path, std::ios::binary );
+        const auto header = EntryHeader { entry_magic, entry_version, key, derive_duration.count(), bytes.size() };
+        stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        stream.write( reinterpret_cast<const char*>( bytes.data() ), static_cast<std::streamsize>( bytes.size() ) );
+        stream.close();
+        if ( !stream )
+        {
+            LOG( "Could not write derived data: " + path.get_string() );
+            std::filesystem::remove( temporary_path, error );
+            return;
+        }
+    }
+
+    std::filesystem::rename( temporary_path, path.get_string(), error );
+    if ( error )
+    {
+        LOG( "Could not store derived data " + path.get_string() + ": " + error.message() );
+        std::filesystem::remove( temporary_path, error );
+    }
+}
+
+//----------------------------------------------------------------
+DerivedDataCacheStatistics DerivedDataCache::get_statistics() const
+{
+    return DerivedDataCacheStatistics
+    {
+        m_n_hits.load(),
+        m_n_misses.load(),
+        static_cast<double>( m_nanoseconds_saved.load() ) * 1e-9
+    };
+}
+
+//----------------------------------------------------------------
+// Returns nothing if there is no entry, or if it was written for a different key or layout
+std::optional<DerivedDataCache::Entry> DerivedDataCache::find_entry( const char* kind, const uint64_t key ) const
+{
+    if ( !is_enabled() ) { return std::nullopt; }
+
+    auto stream = std::ifstream( get_path( kind, key ).get_string(), std::ios::binary | std::ios::ate );
+    if ( !stream.good() ) { return std::nullopt; }
+
+    // entries hold whole decoded images, so they are read in one go
+    const auto n_file_bytes = static_cast<std::streamoff>( stream.tellg() );
+    if ( n_file_bytes < 0 ) { return std::nullopt; }
+    auto file_bytes = std::vector<uint8_t>( static_cast<std::size_t>( n_file_bytes ) );
+    stream.seekg( 0 );
+    if ( !stream.read( reinterpret_cast<char*>( file_bytes.data() ), n_file_bytes ) ) { return std::nullopt; }
+
+    const auto bytes = ContentBytes::make_owning( std::move( file_bytes ) );
+    auto position = std::size_t { 0 };
+    auto header = EntryHeader { };
+    if ( !read_pod( bytes, position, header ) ) { return std::nullopt; }
+    if ( header.magic != entry_magic || header.version != entry_version || header.key != key ) { return std::nullopt; }
+    if ( position + header.n_bytes != bytes.size() ) { return std::nullopt; }
+
+    return Entry
+    {
+        bytes.get_sub_bytes( position, static_cast<std::size_t>( header.n_bytes ) ),
+        std::chrono::nanoseconds { header.derive_nanoseconds }
+    };
+}
+
+//----------------------------------------------------------------
+io::Path DerivedDataCache::get_path( const char* kind, const uint64_t key ) const
+{
+    auto file_name = std::array<char, 64> { };
+    std::snprintf( file_name.data(), file_name.size(), "%.32s_%016llx.bin", kind, static_cast<unsigned long long>( key ) );
+    return *m_directory / io::Path { std::string { file_name.data() } };
+}
+
+//----------------------------------------------------------------
+void DerivedDataCache::record_hit( const std::chrono::nanoseconds saved_duration )
+{
+    ++m_n_hits;
+    m_nanoseconds_saved += saved_duration.count();
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,147 @@
+#ifndef DERIVED_DATA_CACHE_HPP
+#define DERIVED_DATA_CACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/content_id.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Appends the bytes of a trivially copyable value
+template<typename T>
+void write_pod( std::vector<uint8_t>& bytes, const T& value )
+{
+    const auto value_bytes = reinterpret_cast<const uint8_t*>( &value );
+    bytes.insert( bytes.end(), value_bytes, value_bytes + sizeof( T ) );
+}
+
+//----------------------------------------------------------------
+// Copies a trivially copyable value out of the bytes, which might not be suitably aligned to read it in place.
+// Returns false if the bytes are too short.
+template<typename T>
+bool read_pod( const ContentBytes& bytes, std::size_t& position, T& value )
+{
+    if ( position + sizeof( T ) > bytes.size() ) { return false; }
+    std::memcpy( &value, bytes.data() + position, sizeof( T ) );
+    position += sizeof( T );
+    return true;
+}
+
+//----------------------------------------------------------------
+// Hashes the bytes of content, chained onto the seed
+inline uint64_t hash_bytes( const ContentBytes& bytes, const uint64_t seed = fnv_offset_basis )
+{
+    return hash_string( reinterpret_cast<const char*>( bytes.data() ), bytes.size(), seed );
+}
+
+//----------------------------------------------------------------
+struct DerivedDataCacheStatistics
+{
+    std::size_t n_hits          { };
+    std::size_t n_misses        { };
+    // The time it took to derive the data of all hits, minus the time it took to read them
+    double      seconds_saved   { };
+};
+
+//----------------------------------------------------------------
+// Stores the intermediate data that loaders derive from content files, such as decoded pixels,
+// in a directory, so it can be reused at the next startup if the content did not change.
+// Entries are keyed by a hash of everything they were derived from,
+// which should include a version that loaders increment when they change what they derive.
+// Nothing is cached unless a directory is set.
+// All functions can be called from multiple threads.
+class DerivedDataCache
+{
+public:
+    template<typename T>
+    using Derive        = std::function<T()>;
+    template<typename T>
+    using Serialize     = std::function<std::vector<uint8_t>( const T& )>;
+    // Returns nothing if the bytes are not as expected, in which case the data is derived again
+    template<typename T>
+    using Deserialize   = std::function<std::optional<T>( const ContentBytes& )>;
+
+public:
+    //----------------------------------------------------------------
+    void set_directory( const std::optional<io::Path>& directory ) { m_directory = directory; }
+    inline bool is_enabled() const { return m_directory.has_value(); }
+
+    //----------------------------------------------------------------
+    // Returns the data stored for the key, if any.
+    // The kind of data, such as "image", prefixes the file name, to tell entries apart.
+    std::optional<ContentBytes> find( const char* kind, const uint64_t key ) const;
+
+    //----------------------------------------------------------------
+    // Stores data along with how long it took to derive, to report the time saved when it is found.
+    // Failing to store is logged, not reported, as the data can always be derived again.
+    void store( const char* kind, const uint64_t key, const std::vector<uint8_t>& bytes, const std::chrono::nanoseconds derive_duration ) const;
+
+    //----------------------------------------------------------------
+    // Reads the data for the key from the cache if possible,
+    // and otherwise derives it, and stores it for next time
+    template<typename T>
+    T get_or_derive
+    (
+        const char*             kind,
+        const uint64_t          key,
+        const Derive<T>&        derive,
+        const Serialize<T>&     serialize,
+        const Deserialize<T>&   deserialize
+    )
+    {
+        if ( !is_enabled() ) { return derive(); }
+
+        const auto start = std::chrono::steady_clock::now();
+        if ( const auto entry = find_entry( kind, key ) )
+        {
+            if ( auto value = deserialize( entry->bytes ) )
+            {
+                const auto read_duration = std::chrono::steady_clock::now() - start;
+                record_hit( entry->derive_duration - std::chrono::duration_cast<std::chrono::nanoseconds>( read_duration ) );
+                return std::move( *value );
+            }
+        }
+
+        ++m_n_misses;
+        auto value = derive();
+        const auto derive_duration = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start );
+        store( kind, key, serialize( value ), derive_duration );
+        return value;
+    }
+
+    //----------------------------------------------------------------
+    DerivedDataCacheStatistics get_statistics() const;
+
+private:
+    struct Entry
+    {
+        ContentBytes                bytes           { };
+        std::chrono::nanoseconds    derive_duration { };
+    };
+
+    std::optional<Entry>    find_entry  ( const char* kind, const uint64_t key ) const;
+    io::Path                get_path    ( const char* kind, const uint64_t key ) const;
+    void                    record_hit  ( const std::chrono::nanoseconds saved_duration );
+
+private:
+    std::optional<io::Path>     m_directory         { };
+    std::atomic<std::size_t>    m_n_hits            { 0 };
+    std::atomic<std::size_t>    m_n_misses          { 0 };
+    std::atomic<int64_t>        m_nanoseconds_saved { 0 };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // DERIVED_DATA_CACHE_HPP
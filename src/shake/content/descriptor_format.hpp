@@ -0,0 +1,118 @@
+#ifndef DESCRIPTOR_FORMAT_HPP
+#define DESCRIPTOR_FORMAT_HPP
+
+#include <cstdint>
+
+namespace shake {
+namespace content {
+namespace descriptor_format {
+
+//----------------------------------------------------------------
+// Layout of a compiled descriptor:
+//
+//     Header
+//     the descriptor struct of its kind, such as MaterialDescriptor
+//     arrays the descriptor refers to, such as the uniforms of a material
+//     string table, holding all paths
+//
+// Compiled descriptors keep the path of the json descriptor they were compiled from,
+// so content refers to them in the same way, and loaders tell them apart by their magic.
+// Enums are stored as the values of their graphics::gl enums,
+// so descriptors need to be recompiled when those enums change.
+// All values are little endian.
+// Descriptors are read in place, so these structs must not contain any implicit padding.
+
+constexpr uint32_t magic    = 0x43534453; // *reinterpret_cast<const uint32_t*>( "SDSC" );
+constexpr uint32_t version  = 1;
+
+enum class Kind : uint32_t
+{
+    Texture,
+    CubeMap,
+    Material,
+    Sprite,
+    Font
+};
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;
+    uint32_t descriptor_size;
+    uint64_t string_table_offset;
+    uint64_t string_table_size;
+};
+
+// A string in the string table
+struct StringRef
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct TextureDescriptor
+{
+    StringRef image_path;
+    uint32_t  texture_format;
+    uint32_t  filter;
+    uint32_t  generate_mip_maps;
+    uint32_t  padding;
+};
+
+// Faces in the order right, left, top, bottom, front, back
+struct CubeMapDescriptor
+{
+    StringRef face_paths[ 6 ];
+    uint32_t  texture_format;
+    uint32_t  filter;
+    uint32_t  generate_mip_maps;
+    uint32_t  padding;
+};
+
+struct UniformDescriptor
+{
+    uint32_t  type;
+    StringRef path;
+};
+
+struct MaterialDescriptor
+{
+    StringRef shader_path;
+    uint64_t  uniforms_offset;
+    uint32_t  n_uniforms;
+    uint32_t  padding;
+};
+
+struct SpriteDescriptor
+{
+    StringRef texture_path;
+    float     width;
+    float     height;
+};
+
+// Faces in the order default, itallic, bold, bold itallic.
+// The same file describes a dynamic font, which only uses the faces and the glyphs per page, 0 if left out.
+struct FontDescriptor
+{
+    StringRef face_paths[ 4 ];
+    int32_t   rendering;
+    int32_t   pixel_size;
+    int32_t   sdf_spread;
+    uint32_t  max_n_glyphs_per_page;
+};
+
+static_assert( sizeof( Header               ) == 32, "Unexpected padding in descriptor header."     );
+static_assert( sizeof( StringRef            ) == 8,  "Unexpected padding in string ref."            );
+static_assert( sizeof( TextureDescriptor    ) == 24, "Unexpected padding in texture descriptor."    );
+static_assert( sizeof( CubeMapDescriptor    ) == 64, "Unexpected padding in cube map descriptor."   );
+static_assert( sizeof( UniformDescriptor    ) == 12, "Unexpected padding in uniform descriptor."    );
+static_assert( sizeof( MaterialDescriptor   ) == 24, "Unexpected padding in material descriptor."   );
+static_assert( sizeof( SpriteDescriptor     ) == 16, "Unexpected padding in sprite descriptor."     );
+static_assert( sizeof( FontDescriptor       ) == 48, "Unexpected padding in font descriptor."       );
+
+} // namespace descriptor_format
+} // namespace content
+} // namespace shake
+
+#endif // DESCRIPTOR_FORMAT_HPP
@@ -0,0 +1,232 @@
+#include "dynamic_font.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/graphics/gl/gl_enum.hpp"
+#include "shake/graphics/gl/gl_int.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+// Keeps glyphs in neighbouring cells from bleeding into each other when sampled
+constexpr int cell_padding = 1;
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+DynamicFont::DynamicFont
+(
+    std::array<ContentBytes, load::n_faces_per_font> face_bytes,
+    const std::size_t max_n_glyphs_per_page
+)
+    : m_face_bytes              { std::move( face_bytes ) }
+    , m_max_n_glyphs_per_page   { max_n_glyphs_per_page }
+{
+    CHECK_GT( m_max_n_glyphs_per_page, 0u, "A page should hold at least one glyph." );
+
+    // opening a face only reads the tables of the font,
+    // glyphs are not rasterized until they are used
+    for ( std::size_t face_index = 0; face_index < load::n_faces_per_font; ++face_index )
+    {
+        m_faces[ face_index ] = load::open_font_face( m_face_bytes[ face_index ] );
+    }
+}
+
+//----------------------------------------------------------------
+DynamicFont::~DynamicFont()
+{
+    for ( const auto face : m_faces )
+    {
+        load::close_font_face( face );
+    }
+}
+
+//----------------------------------------------------------------
+DynamicGlyph DynamicFont::get_glyph( const FontStyle style, const char32_t codepoint, const int pixel_size )
+{
+    auto& page = get_page( style, pixel_size );
+
+    const auto cached_glyph_it = page.glyphs.find( codepoint );
+    if ( cached_glyph_it != std::end( page.glyphs ) )
+    {
+        ++m_statistics.n_hits;
+        auto& cached_glyph = cached_glyph_it->second;
+        page.lru.splice( std::begin( page.lru ), page.lru, cached_glyph.lru_position );
+        cached_glyph.n_texture_requests = page.n_texture_requests;
+        return cached_glyph.glyph;
+    }
+
+    ++m_statistics.n_misses;
+    const auto glyph_bitmap = load::rasterize_glyph( get_face( style, pixel_size ), codepoint );
+    const auto cell_index = take_cell( page );
+
+    // glyphs that extend beyond the line height or the maximum advance of the face are clipped
+    const auto cell_x   = ( cell_index % page.n_columns ) * page.cell_width;
+    const auto cell_row = cell_index / page.n_columns;
+    const auto cell_y   = cell_row * page.cell_height;
+    const auto width    = std::min( glyph_bitmap.image.width,   page.cell_width  - cell_padding );
+    const auto height   = std::min( glyph_bitmap.image.height,  page.cell_height - cell_padding );
+    const auto page_width = page.n_columns * page.cell_width;
+    for ( int row = 0; row < page.cell_height; ++row )
+    {
+        auto* page_row = page.pixels.data() + static_cast<std::size_t>( cell_y + row ) * page_width + cell_x;
+        std::fill( page_row, page_row + page.cell_width, uint8_t { 0 } );
+        if ( row < height )
+        {
+            std::memcpy( page_row, glyph_bitmap.image.pixels.get() + static_cast<std::size_t>( row ) * glyph_bitmap.image.width, static_cast<std::size_t>( width ) );
+        }
+    }
+    page.dirty_rows[ cell_row ] = true;
+
+    // uvs are relative to the texture of the row of cells
+    const auto page_width_f     = static_cast<float>( page_width );
+    const auto cell_height_f    = static_cast<float>( page.cell_height );
+    const auto glyph = DynamicGlyph
+    {
+        UvRect
+        {
+            cell_x / page_width_f,
+            0.f,
+            ( cell_x + width  ) / page_width_f,
+            height / cell_height_f
+        },
+        glm::ivec2 { width, height },
+        glyph_bitmap.bearing,
+        glyph_bitmap.advance,
+        make_page_key( style, pixel_size ),
+        cell_row
+    };
+
+    page.lru.push_front( codepoint );
+    page.glyphs.emplace( codepoint, CachedGlyph { glyph, cell_index, std::begin( page.lru ), page.n_texture_requests } );
+    return glyph;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<graphics::Texture> DynamicFont::get_texture( const DynamicGlyph& glyph )
+{
+    const auto page_it = m_pages.find( glyph.page_key );
+    CHECK( page_it != std::end( m_pages ), "Glyph does not belong to this font." );
+    auto& page = page_it->second;
+    CHECK( glyph.page_row >= 0 && glyph.page_row < page.n_rows, "Glyph does not belong to a row of its page." );
+
+    // glyphs used so far may be evicted again
+    ++page.n_texture_requests;
+
+    // rows of cells are contiguous in the pixels of the page,
+    // and only the row that received new glyphs is uploaded again
+    if ( page.dirty_rows[ glyph.page_row ] )
+    {
+        const auto page_width   = page.n_columns * page.cell_width;
+        const auto n_row_bytes  = static_cast<std::size_t>( page_width ) * page.cell_height;
+
+        // cells are not aligned to four bytes
+        graphics::gl::pixel_store( graphics::gl::PixelStorageMode::UnpackAlignment, graphics::gl::Size { 1 } );
+        page.row_textures[ glyph.page_row ] = std::make_shared<graphics::Texture>
+        (
+            page.pixels.data() + glyph.page_row * n_row_bytes,
+            page_width,
+            page.cell_height,
+            graphics::gl::TextureFormat::R,
+            graphics::gl::Filter::Linear
+        );
+        graphics::gl::pixel_store( graphics::gl::PixelStorageMode::UnpackAlignment, graphics::gl::Size { 4 } ); // Set back to initial value
+
+        page.dirty_rows[ glyph.page_row ] = false;
+        ++m_statistics.n_texture_uploads;
+        m_statistics.n_uploaded_bytes += n_row_bytes;
+    }
+    return page.row_textures[ glyph.page_row ];
+}
+
+//----------------------------------------------------------------
+uint32_t DynamicFont::make_page_key( const FontStyle style, const int pixel_size )
+{
+    return ( static_cast<uint32_t>( style ) << 16 ) | static_cast<uint32_t>( pixel_size );
+}
+
+//----------------------------------------------------------------
+FT_Face DynamicFont::get_face( const FontStyle style, const int pixel_size )
+{
+    const auto face_index = static_cast<std::size_t>( style );
+    const auto face = m_faces[ face_index ];
+
+    // a face has a single active size, so switch only when a different size is used
+    if ( m_face_pixel_sizes[ face_index ] != pixel_size )
+    {
+        CHECK_EQ( FT_Set_Pixel_Sizes( face, 0, static_cast<FT_UInt>( pixel_size ) ), 0, "Could not set pixel size." );
+        m_face_pixel_sizes[ face_index ] = pixel_size;
+    }
+    return face;
+}
+
+//----------------------------------------------------------------
+DynamicFont::GlyphPage& DynamicFont::get_page( const FontStyle style, const int pixel_size )
+{
+    CHECK_GT( pixel_size, 0, "Pixel size should be positive." );
+    CHECK_LT( pixel_size, 1 << 16, "Pixel size is too large." );
+
+    const auto page_key = make_page_key( style, pixel_size );
+    const auto page_it = m_pages.find( page_key );
+    if ( page_it != std::end( m_pages ) )
+    {
+        return page_it->second;
+    }
+
+    // size cells after the metrics of the face, which are in units of 1/64th of a pixel
+    const auto& metrics = get_face( style, pixel_size )->size->metrics;
+    const auto line_height  = static_cast<int>( ( metrics.height      + 63 ) >> 6 );
+    const auto max_advance  = static_cast<int>( ( metrics.max_advance + 63 ) >> 6 );
+
+    auto page = GlyphPage { };
+    page.style          = style;
+    page.pixel_size     = pixel_size;
+    page.cell_width     = std::max( max_advance, pixel_size ) + cell_padding;
+    page.cell_height    = std::max( line_height, pixel_size ) + cell_padding;
+    page.n_columns      = static_cast<int>( std::ceil( std::sqrt( static_cast<double>( m_max_n_glyphs_per_page ) ) ) );
+    page.n_rows         = static_cast<int>( ( m_max_n_glyphs_per_page + page.n_columns - 1 ) / page.n_columns );
+    page.pixels.assign( static_cast<std::size_t>( page.n_columns * page.cell_width ) * page.n_rows * page.cell_height, 0 );
+    page.row_textures.resize( static_cast<std::size_t>( page.n_rows ) );
+    page.dirty_rows.assign( static_cast<std::size_t>( page.n_rows ), true );
+
+    // hand out cells from the top left
+    for ( auto cell_index = static_cast<int>( m_max_n_glyphs_per_page ) - 1; cell_index >= 0; --cell_index )
+    {
+        page.free_cells.emplace_back( cell_index );
+    }
+
+    ++m_statistics.n_pages;
+    return m_pages.emplace( page_key, std::move( page ) ).first->second;
+}
+
+//----------------------------------------------------------------
+int DynamicFont::take_cell( GlyphPage& page )
+{
+    if ( page.free_cells.empty() )
+    {
+        const auto evicted_codepoint = page.lru.back();
+        const auto evicted_glyph_it = page.glyphs.find( evicted_codepoint );
+
+        // if even the least recently used glyph was used since the textures were last requested, all glyphs were,
+        // and overwriting one would draw the new glyph in its place
+        CHECK_LT( evicted_glyph_it->second.n_texture_requests, page.n_texture_requests, "More glyphs of a page were used between requests of its textures than the page holds." );
+
+        page.lru.pop_back();
+        page.free_cells.emplace_back( evicted_glyph_it->second.cell_index );
+        page.glyphs.erase( evicted_glyph_it );
+        ++m_statistics.n_evictions;
+    }
+
+    const auto cell_index = page.free_cells.back();
+    page.free_cells.pop_back();
+    return cell_index;
+}
+
+} // namespace content
+} // namespace shake
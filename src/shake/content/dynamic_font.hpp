@@ -0,0 +1,146 @@
+#ifndef DYNAMIC_FONT_HPP
+#define DYNAMIC_FONT_HPP
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+#include "shake/core/math/math.hpp"
+#include "shake/graphics/material/texture.hpp"
+
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/glyph_atlas.hpp"
+#include "shake/content/load_font.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+enum class FontStyle : uint8_t
+{
+    Default,
+    Itallic,
+    Bold,
+    BoldItallic
+};
+
+//----------------------------------------------------------------
+// Where a glyph can be found in the texture of its row of cells, and how to place it
+struct DynamicGlyph
+{
+    UvRect      uv_rect     { };
+    glm::ivec2  size        { };
+    glm::ivec2  bearing     { };
+    glm::ivec2  advance     { };
+    uint32_t    page_key    { };
+    int         page_row    { };
+};
+
+//----------------------------------------------------------------
+struct DynamicFontStatistics
+{
+    std::size_t n_hits              { 0 };
+    std::size_t n_misses            { 0 };
+    std::size_t n_evictions         { 0 };
+    std::size_t n_pages             { 0 };
+    std::size_t n_texture_uploads   { 0 };
+    std::size_t n_uploaded_bytes    { 0 };
+};
+
+//----------------------------------------------------------------
+// A font that keeps its faces open, and rasterizes glyphs the first time they are used.
+// Any unicode codepoint can be requested, at any pixel size.
+//
+// Glyphs of the same style and pixel size share a page,
+// divided into cells that are large enough for any glyph at that size.
+// Every row of cells has its own texture, so a new glyph only uploads its row, not the whole page.
+// When all cells of a page are taken, the least recently used glyph makes room.
+// Glyphs used since the textures of their page were last requested are never evicted,
+// so text can request all of its glyphs first, and their textures afterwards.
+// A page can't hold more glyphs than it has cells in between, and requesting more fails.
+// Glyphs can be evicted afterwards, so they should be requested again every time text is drawn.
+//
+// Page textures are created on the thread that calls get_texture,
+// so a dynamic font should be used from the render thread only.
+class DynamicFont
+{
+public:
+    static constexpr std::size_t default_max_n_glyphs_per_page = 1024;
+
+    DynamicFont
+    (
+        std::array<ContentBytes, load::n_faces_per_font> face_bytes,
+        const std::size_t max_n_glyphs_per_page = default_max_n_glyphs_per_page
+    );
+    ~DynamicFont();
+
+    NON_COPYABLE( DynamicFont )
+
+    //----------------------------------------------------------------
+    DynamicGlyph get_glyph( const FontStyle style, const char32_t codepoint, const int pixel_size );
+
+    //----------------------------------------------------------------
+    // The texture of the row of the page that holds the glyph,
+    // which is recreated if glyphs were added to the row since it was last requested
+    std::shared_ptr<graphics::Texture> get_texture( const DynamicGlyph& glyph );
+
+    inline const DynamicFontStatistics& get_statistics() const { return m_statistics; }
+
+private:
+    struct CachedGlyph
+    {
+        DynamicGlyph                    glyph                   { };
+        int                             cell_index              { };
+        std::list<char32_t>::iterator   lru_position            { };
+        // the number of texture requests of the page when the glyph was last used
+        std::size_t                     n_texture_requests      { };
+    };
+
+    struct GlyphPage
+    {
+        FontStyle                                       style               { };
+        int                                             pixel_size          { };
+        int                                             cell_width          { };
+        int                                             cell_height         { };
+        int                                             n_columns           { };
+        int                                             n_rows              { };
+        std::vector<uint8_t>                            pixels              { };
+        std::vector<int>                                free_cells          { };
+        std::unordered_map<char32_t, CachedGlyph>       glyphs              { };
+        // the most recently used glyph is at the front
+        std::list<char32_t>                             lru                 { };
+        std::vector<std::shared_ptr<graphics::Texture>> row_textures        { };
+        std::vector<bool>                               dirty_rows          { };
+        // the number of times the textures of the page were requested
+        std::size_t                                     n_texture_requests  { 0 };
+    };
+
+private:
+    static uint32_t make_page_key( const FontStyle style, const int pixel_size );
+
+    FT_Face     get_face( const FontStyle style, const int pixel_size );
+    GlyphPage&  get_page( const FontStyle style, const int pixel_size );
+    int         take_cell( GlyphPage& page );
+
+private:
+    std::array<ContentBytes,    load::n_faces_per_font> m_face_bytes                { };
+    std::array<FT_Face,         load::n_faces_per_font> m_faces                     { };
+    // the pixel size that is currently set on each face
+    std::array<int,             load::n_faces_per_font> m_face_pixel_sizes          { };
+    std::size_t                                         m_max_n_glyphs_per_page     { };
+    std::map<uint32_t, GlyphPage>                       m_pages                     { };
+    DynamicFontStatistics                               m_statistics                { };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // DYNAMIC_FONT_HPP
@@ -0,0 +1,153 @@
+#ifndef FLAT_CONTENT_TABLE_HPP
+#define FLAT_CONTENT_TABLE_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "shake/content/content_id.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// An open addressing hash table keyed by content id, using linear probing.
+// Ids are already well distributed hashes, so they index the slots directly.
+// Slots only hold the hash and the value, so probing walks contiguous memory.
+// Values are moved on insertion and erasure,
+// so store them by pointer if references to them need to remain stable.
+template<typename Value_T>
+class FlatContentTable
+{
+public:
+    FlatContentTable() = default;
+
+    //----------------------------------------------------------------
+    Value_T* find( const ContentId& id )
+    {
+        return const_cast<Value_T*>( static_cast<const FlatContentTable*>( this )->find( id ) );
+    }
+
+    //----------------------------------------------------------------
+    const Value_T* find( const ContentId& id ) const
+    {
+        if ( m_slots.empty() ) { return nullptr; }
+
+        for ( auto slot_index = get_home_index( id.get_hash() ); ; slot_index = get_next_index( slot_index ) )
+        {
+            const auto& slot = m_slots[ slot_index ];
+            if ( slot.hash == id.get_hash() )           { return &slot.value; }
+            if ( slot.hash == ContentId::invalid_hash ) { return nullptr; }
+        }
+    }
+
+    //----------------------------------------------------------------
+    // Inserts the value, unless the id is already present.
+    // Returns the stored value, and whether it was inserted.
+    std::pair<Value_T*, bool> emplace( const ContentId& id, Value_T value )
+    {
+        // keep the load factor at or below one half, so probe sequences stay short
+        if ( ( m_size + 1 ) * 2 > m_slots.size() ) 
+        { 
+            rehash( m_slots.empty() ? min_n_slots : m_slots.size() * 2 ); 
+        }
+
+        auto slot_index = get_home_index( id.get_hash() );
+        for ( ; m_slots[ slot_index ].hash != ContentId::invalid_hash; slot_index = get_next_index( slot_index ) )
+        {
+            if ( m_slots[ slot_index ].hash == id.get_hash() ) { return { &m_slots[ slot_index ].value, false }; }
+        }
+
+        m_slots[ slot_index ] = Slot { id.get_hash(), std::move( value ) };
+        ++m_size;
+        return { &m_slots[ slot_index ].value, true };
+    }
+
+    //----------------------------------------------------------------
+    // Uses backward shift deletion, so no tombstones are left behind
+    bool erase( const ContentId& id )
+    {
+        if ( m_slots.empty() ) { return false; }
+
+        auto slot_index = get_home_index( id.get_hash() );
+        for ( ; m_slots[ slot_index ].hash != id.get_hash(); slot_index = get_next_index( slot_index ) )
+        {
+            if ( m_slots[ slot_index ].hash == ContentId::invalid_hash ) { return false; }
+        }
+
+        auto hole_index = slot_index;
+        for ( auto next_index = get_next_index( hole_index ); m_slots[ next_index ].hash != ContentId::invalid_hash; next_index = get_next_index( next_index ) )
+        {
+            // an entry can fill the hole if the hole lies between its home slot and its current slot
+            const auto home_index = get_home_index( m_slots[ next_index ].hash );
+            const auto distance_to_hole = ( hole_index - home_index ) & get_mask();
+            const auto distance_to_next = ( next_index - home_index ) & get_mask();
+            if ( distance_to_hole < distance_to_next )
+            {
+                m_slots[ hole_index ] = std::move( m_slots[ next_index ] );
+                hole_index = next_index;
+            }
+        }
+
+        m_slots[ hole_index ] = Slot { };
+        --m_size;
+        return true;
+    }
+
+    //----------------------------------------------------------------
+    template<typename Function_T>
+    void for_each( Function_T&& function ) const
+    {
+        for ( const auto& slot : m_slots )
+        {
+            if ( slot.hash != ContentId::invalid_hash ) { function( ContentId::from_hash( slot.hash ), slot.value ); }
+        }
+    }
+
+    //----------------------------------------------------------------
+    void clear()
+    {
+        m_slots.clear();
+        m_size = 0;
+    }
+
+    inline std::size_t get_size() const { return m_size; }
+
+private:
+    struct Slot
+    {
+        uint64_t    hash    { ContentId::invalid_hash };
+        Value_T     value   { };
+    };
+
+    static constexpr std::size_t min_n_slots = 16;
+
+    //----------------------------------------------------------------
+    inline std::size_t get_mask() const { return m_slots.size() - 1; }
+    inline std::size_t get_home_index( const uint64_t hash ) const { return static_cast<std::size_t>( hash ) & get_mask(); }
+    inline std::size_t get_next_index( const std::size_t slot_index ) const { return ( slot_index + 1 ) & get_mask(); }
+
+    //----------------------------------------------------------------
+    void rehash( const std::size_t n_slots )
+    {
+        auto old_slots = std::move( m_slots );
+        m_slots = std::vector<Slot>( n_slots );
+        m_size = 0;
+        for ( auto& slot : old_slots )
+        {
+            if ( slot.hash != ContentId::invalid_hash ) 
+            { 
+                emplace( ContentId::from_hash( slot.hash ), std::move( slot.value ) ); 
+            }
+        }
+    }
+
+private:
+    std::vector<Slot>   m_slots { };
+    std::size_t         m_size  { 0 };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // FLAT_CONTENT_TABLE_HPP
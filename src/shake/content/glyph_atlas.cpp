@@ -0,0 +1,138 @@
+#include "glyph_atlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+ShelfPacker::ShelfPacker( const int width, const int height, const int padding )
+    : m_width   { width }
+    , m_height  { height }
+    , m_padding { padding }
+{ }
+
+//----------------------------------------------------------------
+std::optional<AtlasRect> ShelfPacker::pack( const int width, const int height )
+{
+    const auto padded_width = width + m_padding;
+    const auto padded_height = height + m_padding;
+
+    // use the fitting shelf that wastes the least height
+    auto best_shelf = m_shelves.end();
+    for ( auto shelf = m_shelves.begin(); shelf != m_shelves.end(); ++shelf )
+    {
+        const auto fits = shelf->height >= padded_height && shelf->x + padded_width <= m_width;
+        if ( fits && ( best_shelf == m_shelves.end() || shelf->height < best_shelf->height ) )
+        {
+            best_shelf = shelf;
+        }
+    }
+
+    // otherwise open a new shelf
+    if ( best_shelf == m_shelves.end() )
+    {
+        if ( m_top + padded_height > m_height || padded_width > m_width ) { return std::nullopt; }
+        m_shelves.emplace_back( Shelf { m_top, padded_height, 0 } );
+        m_top += padded_height;
+        best_shelf = std::prev( m_shelves.end() );
+    }
+
+    const auto rect = AtlasRect { best_shelf->x, best_shelf->y, width, height };
+    best_shelf->x += padded_width;
+    m_packed_area += static_cast<long long>( width ) * height;
+    return rect;
+}
+
+//----------------------------------------------------------------
+float ShelfPacker::get_occupancy() const
+{
+    return static_cast<float>( m_packed_area ) / ( static_cast<float>( m_width ) * m_height );
+}
+
+//----------------------------------------------------------------
+GlyphAtlas pack_glyph_atlas( const std::vector<load::Image>& bitmaps, const int padding )
+{
+    // pack from high to low, so shelves fill up with glyphs of similar height
+    auto order = std::vector<std::size_t>( bitmaps.size() );
+    std::iota( std::begin( order ), std::end( order ), 0 );
+    std::stable_sort( std::begin( order ), std::end( order ),
+        [ & ]( const std::size_t lhs, const std::size_t rhs ) { return bitmaps[ lhs ].height > bitmaps[ rhs ].height; } );
+
+    // start at a size that could hold the total area, and grow until everything fits
+    long long total_area { 0 };
+    for ( const auto& bitmap : bitmaps )
+    {
+        total_area += static_cast<long long>( bitmap.width + padding ) * ( bitmap.height + padding );
+    }
+    // grow the height first, so the atlas is either square or twice as high as it is wide
+    auto width  = 64;
+    auto height = 64;
+    const auto grow = [ & ]() { if ( height == width ) { height *= 2; } else { width *= 2; } };
+    while ( static_cast<long long>( width ) * height < total_area ) { grow(); }
+
+    auto atlas = GlyphAtlas { };
+    while ( true )
+    {
+        auto packer = ShelfPacker { width, height, padding };
+        atlas.rects.assign( bitmaps.size(), AtlasRect { } );
+
+        const auto all_packed = std::all_of( std::begin( order ), std::end( order ), [ & ]( const std::size_t bitmap_index )
+        {
+            const auto& bitmap = bitmaps[ bitmap_index ];
+            if ( bitmap.width == 0 || bitmap.height == 0 ) { return true; }
+
+            const auto rect = packer.pack( bitmap.width, bitmap.height );
+            if ( rect ) { atlas.rects[ bitmap_index ] = *rect; }
+            return rect.has_value();
+        } );
+
+        if ( all_packed )
+        {
+            atlas.occupancy = packer.get_occupancy();
+            break;
+        }
+        grow();
+    }
+
+    // copy the bitmaps into the atlas
+    auto pixels = std::vector<uint8_t>( static_cast<std::size_t>( width ) * height, 0 );
+    atlas.uv_rects.reserve( bitmaps.size() );
+    for ( std::size_t bitmap_index = 0; bitmap_index < bitmaps.size(); ++bitmap_index )
+    {
+        const auto& bitmap  = bitmaps[ bitmap_index ];
+        const auto& rect    = atlas.rects[ bitmap_index ];
+        CHECK( bitmap.width == 0 || bitmap.n_channels == 1, "Glyph bitmaps should have a single channel." );
+
+        for ( int row = 0; row < rect.height; ++row )
+        {
+            std::memcpy
+            (
+                pixels.data() + static_cast<std::size_t>( rect.y + row ) * width + rect.x,
+                bitmap.pixels.get() + static_cast<std::size_t>( row ) * bitmap.width,
+                static_cast<std::size_t>( bitmap.width )
+            );
+        }
+
+        const auto atlas_width  = static_cast<float>( width );
+        const auto atlas_height = static_cast<float>( height );
+        atlas.uv_rects.emplace_back( UvRect
+        {
+            rect.x / atlas_width,
+            rect.y / atlas_height,
+            ( rect.x + rect.width  ) / atlas_width,
+            ( rect.y + rect.height ) / atlas_height
+        } );
+    }
+
+    atlas.image = load::make_image( std::move( pixels ), width, height, 1 );
+    return atlas;
+}
+
+} // namespace content
+} // namespace shake
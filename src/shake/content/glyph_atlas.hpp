@@ -0,0 +1,88 @@
+#ifndef GLYPH_ATLAS_HPP
+#define GLYPH_ATLAS_HPP
+
+#include <optional>
+#include <vector>
+
+#include "shake/content/load_image.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A rectangle in pixels
+struct AtlasRect
+{
+    int x       { };
+    int y       { };
+    int width   { };
+    int height  { };
+};
+
+//----------------------------------------------------------------
+// A rectangle in texture coordinates
+struct UvRect
+{
+    float u_min { };
+    float v_min { };
+    float u_max { };
+    float v_max { };
+};
+
+//----------------------------------------------------------------
+// Packs rectangles into rows, called shelves, that are as high as the highest rectangle in them.
+// Packs well for rectangles of similar height, such as the glyphs of a font,
+// especially if they are packed from high to low.
+class ShelfPacker
+{
+public:
+    ShelfPacker( const int width, const int height, const int padding );
+
+    //----------------------------------------------------------------
+    // Returns where the rectangle was placed, or nothing if it doesn't fit
+    std::optional<AtlasRect> pack( const int width, const int height );
+
+    //----------------------------------------------------------------
+    // The fraction of the atlas that is covered by packed rectangles
+    float get_occupancy() const;
+
+    inline int get_width()  const { return m_width;  }
+    inline int get_height() const { return m_height; }
+
+private:
+    struct Shelf
+    {
+        int y       { };
+        int height  { };
+        int x       { };
+    };
+
+private:
+    int                 m_width         { };
+    int                 m_height        { };
+    int                 m_padding       { };
+    int                 m_top           { 0 };
+    std::vector<Shelf>  m_shelves       { };
+    long long           m_packed_area   { 0 };
+};
+
+//----------------------------------------------------------------
+// Single channel images packed into one image
+struct GlyphAtlas
+{
+    load::Image             image       { };
+    std::vector<AtlasRect>  rects       { };
+    std::vector<UvRect>     uv_rects    { };
+    float                   occupancy   { };
+};
+
+//----------------------------------------------------------------
+// Packs the bitmaps, given as single channel images, into the smallest power of two atlas
+// that holds them, which is at most twice as high as it is wide. Rects are returned in the order of the bitmaps.
+// Empty bitmaps get an empty rect.
+GlyphAtlas pack_glyph_atlas( const std::vector<load::Image>& bitmaps, const int padding = 1 );
+
+} // namespace content
+} // namespace shake
+
+#endif // GLYPH_ATLAS_HPP
@@ -1,14 +1,13 @@
 #include "load_cube_map.hpp"
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 #include <array>
 #include <string>
 #include <vector>
 
 #include "shake/core/std/map.hpp"
+#include "shake/content/compiled_descriptor.hpp"
 #include "shake/content/content_manager.hpp"
+#include "shake/content/load_json.hpp"
 #include "shake/io/file_json.hpp"
 #include "shake/graphics/material/texture_parameters.hpp"
 
@@ -20,54 +19,86 @@ namespace { // anonymous
 
 } // namespace anonymous
 
-std::shared_ptr<graphics::CubeMap> load_cube_map( shake::content::ContentManager* content_manager, const io::Path& path )
+//----------------------------------------------------------------
+// Cube map files are either json, or descriptors compiled from it
+CubeMapData decode_cube_map( shake::content::ContentManager* content_manager, const io::Path& path )
 {
-    const auto json = io::file::json::read( path );
-
-    const auto cube_face_keys = std::vector<std::string> { "right", "left", "top", "bottom", "front", "back" };
-
-    const auto image_format_str         = io::file::json::read_as<std::string>  ( json, { "image_format"        } );
-    const auto texture_format_str       = io::file::json::read_as<std::string>  ( json, { "texture_format"      } );
-    const auto interpolation_mode_str   = io::file::json::read_as<std::string>  ( json, { "interpolation_mode"  } );
-    const auto generate_mipmaps         = io::file::json::read_as<bool>         ( json, { "generate_mip_maps"   } );
+    const auto bytes = content_manager->read_scratch_content( path );
 
     // get data from file in memory
     int bytes_per_pixel_forced  { 3 };
-    auto image_data = graphics::CubeMap::ImageData { };
-    auto bytes_per_pixel_values = std::array<int, graphics::CubeMap::n_cube_faces> { };
+    auto cube_map_data = CubeMapData { };
+
+    auto cube_face_texture_paths = std::vector<io::Path> { };
+    if ( CompiledDescriptor::is_compiled_descriptor( bytes ) )
+    {
+        const auto compiled_descriptor  = CompiledDescriptor { bytes, descriptor_format::Kind::CubeMap };
+        const auto descriptor           = compiled_descriptor.get_descriptor<descriptor_format::CubeMapDescriptor>();
+        cube_map_data.texture_format    = static_cast<graphics::gl::TextureFormat>( descriptor.texture_format );
+        cube_map_data.filter            = static_cast<graphics::gl::Filter>( descriptor.filter );
+        for ( const auto& face_path : descriptor.face_paths )
+        {
+            cube_face_texture_paths.emplace_back( compiled_descriptor.get_path( face_path ) );
+        }
+    }
+    else
+    {
+        const auto json = parse_json( bytes );
+
+        const auto cube_face_keys = std::vector<std::string> { "right", "left", "top", "bottom", "front", "back" };
+
+        const auto image_format_str         = io::file::json::read_as<std::string>  ( json, { "image_format"        } );
+        const auto texture_format_str       = io::file::json::read_as<std::string>  ( json, { "texture_format"      } );
+        const auto interpolation_mode_str   = io::file::json::read_as<std::string>  ( json, { "interpolation_mode"  } );
+        const auto generate_mipmaps         = io::file::json::read_as<bool>         ( json, { "generate_mip_maps"   } );
+
+        cube_map_data.texture_format    = graphics::to_texture_format( texture_format_str );
+        cube_map_data.filter            = graphics::to_filter( interpolation_mode_str );
+        for ( const auto& cube_face_key : cube_face_keys )
+        {
+            cube_face_texture_paths.emplace_back( io::file::json::read_as<std::string>( json, { cube_face_key } ) );
+        }
+    }
 
+    // the faces are independent images, so decode them in parallel
+    content_manager->parallel_for( graphics::CubeMap::n_cube_faces, [ & ]( const std::size_t cube_face_index )
+    {
+        const auto cube_face_texture_full_path = content_manager->get_full_path( cube_face_texture_paths[ cube_face_index ] );
+        cube_map_data.faces[ cube_face_index ] = decode_image( content_manager->read_scratch_content( cube_face_texture_full_path ), bytes_per_pixel_forced, content_manager->get_derived_data_cache() );
+    } );
+
+    return cube_map_data;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<graphics::CubeMap> upload_cube_map( shake::content::ContentManager* content_manager, const CubeMapData& cube_map_data )
+{
+    auto image_data = graphics::CubeMap::ImageData { };
     for ( std::size_t cube_face_index = 0; cube_face_index < graphics::CubeMap::n_cube_faces; ++cube_face_index )
     {
-        const auto cube_face_texture_path = io::Path( io::file::json::read_as<std::string>( json, { cube_face_keys[ cube_face_index ] } ) );
-        const auto cube_face_texture_full_path = content_manager->get_full_path( cube_face_texture_path );
-
-        auto& image_info = image_data[ cube_face_index ];
-
-        image_info.ptr = static_cast<uint8_t*>( stbi_load
-        (
-            cube_face_texture_full_path.c_str(),
-            &image_info.width,
-            &image_info.height,
-            &bytes_per_pixel_values [ cube_face_index ],
-            bytes_per_pixel_forced
-        ) );
+        const auto& face        = cube_map_data.faces[ cube_face_index ];
+        auto& image_info        = image_data[ cube_face_index ];
+        // the graphics api takes mutable pointers, but only reads from them
+        image_info.ptr          = const_cast<uint8_t*>( face.pixels.get() );
+        image_info.width        = face.width;
+        image_info.height       = face.height;
+        content_manager->report_content_size( face.get_n_bytes() );
     }
 
-    // load texture on gpu
-    const auto texture = std::make_shared<graphics::CubeMap>
+    // load texture on gpu,
+    // the cpu memory is freed when the last reference to the faces is dropped
+    return std::make_shared<graphics::CubeMap>
     (
         image_data,
-        graphics::to_texture_format( texture_format_str ),
-        graphics::to_filter( interpolation_mode_str )
+        cube_map_data.texture_format,
+        cube_map_data.filter
     );
+}
 
-    // clear memory from cpu
-    for ( const auto& image_info : image_data )
-    {
-        stbi_image_free( image_info.ptr );
-    }
-
-    return texture;
+//----------------------------------------------------------------
+std::shared_ptr<graphics::CubeMap> load_cube_map( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_cube_map( content_manager, decode_cube_map( content_manager, path ) );
 }
 
 } // namespace load
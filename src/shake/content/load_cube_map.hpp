@@ -1,11 +1,14 @@
 #ifndef LOAD_CUBE_MAP_HPP
 #define LOAD_CUBE_MAP_HPP
 
+#include <array>
 #include <memory>
 
 #include "shake/graphics/material/cube_map.hpp"
 #include "shake/io/path.hpp"
 
+#include "shake/content/load_image.hpp"
+
 namespace shake {
 namespace content {
 
@@ -13,6 +16,17 @@ class ContentManager;
 
 namespace load {
 
+//----------------------------------------------------------------
+struct CubeMapData
+{
+    std::array<Image, graphics::CubeMap::n_cube_faces>  faces           { };
+    graphics::gl::TextureFormat                         texture_format  { };
+    graphics::gl::Filter                                filter          { };
+};
+
+CubeMapData                         decode_cube_map ( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<graphics::CubeMap>  upload_cube_map ( shake::content::ContentManager* content_manager, const CubeMapData& cube_map_data );
+
 std::shared_ptr<graphics::CubeMap> load_cube_map( shake::content::ContentManager* content_manager, const io::Path& path );
 
 } // namespace load
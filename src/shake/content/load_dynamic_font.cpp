@@ -0,0 +1,75 @@
+#include "load_dynamic_font.hpp"
+
+#include <array>
+#include <string>
+
+#include "shake/content/compiled_descriptor.hpp"
+#include "shake/content/content_manager.hpp"
+#include "shake/content/load_json.hpp"
+
+#include "shake/io/file_json.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+//----------------------------------------------------------------
+// Uses the same description as a regular font, either json or compiled,
+// optionally with the number of glyphs that fit on a page
+std::shared_ptr<DynamicFont> decode_dynamic_font( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto bytes = content_manager->read_scratch_content( path );
+
+    auto face_paths             = std::array<io::Path, n_faces_per_font> { };
+    auto max_n_glyphs_per_page  = DynamicFont::default_max_n_glyphs_per_page;
+    if ( CompiledDescriptor::is_compiled_descriptor( bytes ) )
+    {
+        const auto compiled_descriptor  = CompiledDescriptor { bytes, descriptor_format::Kind::Font };
+        const auto descriptor           = compiled_descriptor.get_descriptor<descriptor_format::FontDescriptor>();
+        for ( std::size_t face_index = 0; face_index < n_faces_per_font; ++face_index )
+        {
+            face_paths[ face_index ] = compiled_descriptor.get_path( descriptor.face_paths[ face_index ] );
+        }
+        if ( descriptor.max_n_glyphs_per_page != 0 ) { max_n_glyphs_per_page = descriptor.max_n_glyphs_per_page; }
+    }
+    else
+    {
+        const auto content = parse_json( bytes );
+
+        const auto face_keys = std::array<const char*, n_faces_per_font> { "default", "itallic", "bold", "bold_itallic" };
+        for ( std::size_t face_index = 0; face_index < n_faces_per_font; ++face_index )
+        {
+            face_paths[ face_index ] = io::Path { io::file::json::read_as<std::string>( content, { face_keys[ face_index ] } ) };
+        }
+
+        if ( io::file::json::has_key( content, "max_n_glyphs_per_page" ) )
+        {
+            max_n_glyphs_per_page = static_cast<std::size_t>( io::file::json::read_as<int>( content, { "max_n_glyphs_per_page" } ) );
+        }
+    }
+
+    // the faces read from the bytes for as long as the font exists
+    auto face_bytes = std::array<ContentBytes, n_faces_per_font> { };
+    for ( std::size_t face_index = 0; face_index < n_faces_per_font; ++face_index )
+    {
+        face_bytes[ face_index ] = content_manager->read_content( content_manager->get_full_path( face_paths[ face_index ] ) );
+    }
+
+    return std::make_shared<DynamicFont>( std::move( face_bytes ), max_n_glyphs_per_page );
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<DynamicFont> upload_dynamic_font( shake::content::ContentManager*, const std::shared_ptr<DynamicFont>& dynamic_font )
+{
+    return dynamic_font;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<DynamicFont> load_dynamic_font( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_dynamic_font( content_manager, decode_dynamic_font( content_manager, path ) );
+}
+
+} // namespace load
+} // namespace content
+} // namespace shake
@@ -0,0 +1,28 @@
+#ifndef LOAD_DYNAMIC_FONT_HPP
+#define LOAD_DYNAMIC_FONT_HPP
+
+#include <memory>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/dynamic_font.hpp"
+
+namespace shake {
+namespace content {
+
+class ContentManager;
+
+namespace load {
+
+// A dynamic font does not depend on the graphics context until it is used,
+// so it is constructed entirely by the decoder.
+std::shared_ptr<DynamicFont> decode_dynamic_font( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<DynamicFont> upload_dynamic_font( shake::content::ContentManager* content_manager, const std::shared_ptr<DynamicFont>& dynamic_font );
+
+std::shared_ptr<DynamicFont> load_dynamic_font( shake::content::ContentManager* content_manager, const io::Path& path );
+
+} // namespace load
+} // namespace content
+} // namespace shake
+
+#endif // LOAD_DYNAMIC_FONT_HPP
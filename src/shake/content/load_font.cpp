@@ -1,14 +1,25 @@
 #include "load_font.hpp"
 
+#include <array>
+#include <cmath>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 #include "shake/core/contracts/contracts.hpp"
+#include "shake/core/log.hpp"
 #include "shake/core/math/math.hpp"
 
+#include "shake/content/compiled_descriptor.hpp"
+#include "shake/content/content_id.hpp"
 #include "shake/content/content_manager.hpp"
+#include "shake/content/load_json.hpp"
+#include "shake/content/signed_distance_field.hpp"
 
 #include "shake/io/file.hpp"
 #include "shake/io/file_json.hpp"
@@ -29,95 +40,411 @@ namespace { // anonymous
 
 FT_Library ft { };
 
-graphics::Font::CharacterMap load_character_map( shake::content::ContentManager* content_manager, const io::Path& path )
+// Faces can be used from different threads,
+// but creating and destroying them modifies the shared library
+std::mutex ft_library_mutex { };
+
+constexpr int default_pixel_size       = 64;
+constexpr int default_sdf_pixel_size   = 32;
+constexpr int default_sdf_spread       = 4;
+
+// Signed distance fields are made from glyphs rasterized at a higher resolution,
+// so the edges are known with sub pixel precision
+constexpr int sdf_supersampling = 4;
+
+// Increment when the generated glyphs change, to invalidate cached fonts
+constexpr uint32_t font_cache_version = 2;
+
+//----------------------------------------------------------------
+GlyphBitmaps rasterize_glyphs( const ContentBytes& bytes, const int pixel_size )
 {
-    const io::Path full_path { content_manager->get_full_path( path ) };
+    // FreeType reads from the bytes for as long as the face is open
+    const auto face = open_font_face( bytes );
 
-    FT_Face face { };
-    CHECK_EQ( FT_New_Face( ft, full_path.c_str(), 0, &face ), 0, "Could not load font." );
+    FT_Set_Pixel_Sizes( face, 0, static_cast<FT_UInt>( pixel_size ) );
+
+    auto glyph_bitmaps = GlyphBitmaps { };
+    for ( uint8_t c = 0; c < n_glyphs_per_face; c++)
+    {
+        glyph_bitmaps[ c ] = rasterize_glyph( face, c );
+    }
 
-    FT_Set_Pixel_Sizes( face, 0, 64 );
+    close_font_face( face );
+    return glyph_bitmaps;
+}
 
-    graphics::gl::pixel_store( graphics::gl::PixelStorageMode::UnpackAlignment, graphics::gl::Size { 1 } );
+//----------------------------------------------------------------
+// Replaces the supersampled glyphs by their signed distance fields.
+// The fields are padded by the spread, which moves their bearing.
+void make_signed_distance_fields( shake::content::ContentManager* content_manager, FontData& font_data, const int spread )
+{
+    const auto rounded_divide = []( const int value ) { return static_cast<int>( std::lround( static_cast<float>( value ) / sdf_supersampling ) ); };
 
-    graphics::Font::CharacterMap character_map { };
+    content_manager->parallel_for( n_faces_per_font * n_glyphs_per_face, [ & ]( const std::size_t glyph_index )
+    {
+        auto& glyph_bitmap = font_data.faces[ glyph_index / n_glyphs_per_face ][ glyph_index % n_glyphs_per_face ];
+        glyph_bitmap.advance = glm::ivec2 { rounded_divide( glyph_bitmap.advance.x ), rounded_divide( glyph_bitmap.advance.y ) };
+
+        // glyphs without pixels, such as spaces, only advance
+        if ( glyph_bitmap.image.width == 0 || glyph_bitmap.image.height == 0 ) { return; }
 
-    const auto program = content_manager->get_or_load<graphics::Program>( io::Path { "shaders/default_text_shader.glsl" } );
-    const auto material = std::make_shared<graphics::Material>( program );
+        glyph_bitmap.image = make_signed_distance_field( glyph_bitmap.image, spread, sdf_supersampling );
+        glyph_bitmap.bearing = glm::ivec2
+        {
+            rounded_divide( glyph_bitmap.bearing.x ) - spread,
+            rounded_divide( glyph_bitmap.bearing.y ) + spread
+        };
+    } );
+}
 
-    for ( uint8_t c = 0; c < 128; c++)
+//----------------------------------------------------------------
+// Stores the glyph metrics and the packed atlas, the glyphs no longer hold pixels
+std::vector<uint8_t> serialize_font_data( const FontData& font_data )
+{
+    auto bytes = std::vector<uint8_t> { };
+    write_pod( bytes, static_cast<int32_t>( font_data.rendering ) );
+    write_pod( bytes, static_cast<int32_t>( font_data.pixel_size ) );
+    for ( const auto& glyph_bitmaps : font_data.faces )
     {
-        // Load character glyph
-        CHECK_EQ( FT_Load_Char( face, c, FT_LOAD_RENDER ), 0, "Could not load glyph." );
+        for ( const auto& glyph_bitmap : glyph_bitmaps )
+        {
+            const auto metrics = std::array<int32_t, 6>
+            {
+                glyph_bitmap.image.width,
+                glyph_bitmap.image.height,
+                glyph_bitmap.bearing.x,
+                glyph_bitmap.bearing.y,
+                glyph_bitmap.advance.x,
+                glyph_bitmap.advance.y
+            };
+            write_pod( bytes, metrics );
+        }
+    }
 
-        // Generate texture
-        const auto texture = std::make_shared<graphics::Texture>
-        (
-            face->glyph->bitmap.buffer,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            graphics::gl::TextureFormat::R,
-            graphics::gl::Filter::Linear
-        );
+    const auto& atlas = font_data.atlas;
+    write_pod( bytes, atlas.occupancy );
+    for ( std::size_t glyph_index = 0; glyph_index < atlas.rects.size(); ++glyph_index )
+    {
+        write_pod( bytes, atlas.rects[ glyph_index ] );
+        write_pod( bytes, atlas.uv_rects[ glyph_index ] );
+    }
+    load::serialize_image( bytes, atlas.image );
+    return bytes;
+}
 
-        const auto sprite = std::make_shared<graphics::Sprite>
-        (
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            texture
-        );
+//----------------------------------------------------------------
+// Returns nothing if the bytes are not as expected
+std::optional<FontData> deserialize_font_data( const ContentBytes& bytes )
+{
+    auto position = std::size_t { 0 };
 
-        const auto geometry = std::make_shared<graphics::Geometry2D>( graphics::make_rectangle_2D( face->glyph->bitmap.width, face->glyph->bitmap.rows ) );
-        const auto render_pack = graphics::RenderPack2D { geometry,  };
+    int32_t rendering   { };
+    int32_t pixel_size  { };
+    if ( !read_pod( bytes, position, rendering ) || !read_pod( bytes, position, pixel_size ) ) { return std::nullopt; }
 
-        //render_pack.material->set_uniform( "u_sampler2", graphics::UniformTexture { texture, to_texture_unit_index( graphics::gl::NamedTextureUnit::Albedo ) } );
+    auto font_data = FontData { };
+    font_data.rendering     = static_cast<FontRendering>( rendering );
+    font_data.pixel_size    = pixel_size;
+    for ( auto& glyph_bitmaps : font_data.faces )
+    {
+        for ( auto& glyph_bitmap : glyph_bitmaps )
+        {
+            auto metrics = std::array<int32_t, 6> { };
+            if ( !read_pod( bytes, position, metrics ) ) { return std::nullopt; }
+            glyph_bitmap.image.width        = metrics[ 0 ];
+            glyph_bitmap.image.height       = metrics[ 1 ];
+            glyph_bitmap.image.n_channels   = 1;
+            glyph_bitmap.bearing            = glm::ivec2 { metrics[ 2 ], metrics[ 3 ] };
+            glyph_bitmap.advance            = glm::ivec2 { metrics[ 4 ], metrics[ 5 ] };
+        }
+    }
+
+    auto& atlas = font_data.atlas;
+    if ( !read_pod( bytes, position, atlas.occupancy ) ) { return std::nullopt; }
+
+    atlas.rects.resize      ( n_faces_per_font * n_glyphs_per_face );
+    atlas.uv_rects.resize   ( n_faces_per_font * n_glyphs_per_face );
+    for ( std::size_t glyph_index = 0; glyph_index < atlas.rects.size(); ++glyph_index )
+    {
+        if ( !read_pod( bytes, position, atlas.rects[ glyph_index ] ) || !read_pod( bytes, position, atlas.uv_rects[ glyph_index ] ) ) { return std::nullopt; }
+    }
+
+    auto atlas_image = load::deserialize_image( bytes, position );
+    if ( !atlas_image ) { return std::nullopt; }
+    atlas.image = std::move( *atlas_image );
+
+    return font_data;
+}
+
+//----------------------------------------------------------------
+// A rectangle like graphics::make_rectangle_2D makes,
+// with its texture coordinates mapped onto the rect of the glyph in the atlas.
+// Vertices are laid out as position x, y followed by texture coordinates u, v.
+std::vector<float> make_glyph_rectangle_2D( const int width, const int height, const UvRect& uv_rect )
+{
+    constexpr std::size_t n_floats_per_vertex = 4;
+
+    auto vertices = graphics::make_rectangle_2D( width, height );
+    for ( std::size_t vertex_offset = 0; vertex_offset + n_floats_per_vertex <= vertices.size(); vertex_offset += n_floats_per_vertex )
+    {
+        auto& u = vertices[ vertex_offset + 2 ];
+        auto& v = vertices[ vertex_offset + 3 ];
+        u = uv_rect.u_min + u * ( uv_rect.u_max - uv_rect.u_min );
+        v = uv_rect.v_min + v * ( uv_rect.v_max - uv_rect.v_min );
+    }
+    return vertices;
+}
+
+//----------------------------------------------------------------
+graphics::Font::CharacterMap make_character_map( const FontData& font_data, const std::size_t face_index )
+{
+    graphics::Font::CharacterMap character_map { };
+
+    for ( uint8_t c = 0; c < n_glyphs_per_face; c++)
+    {
+        const auto& glyph_bitmap    = font_data.faces[ face_index ][ c ];
+        const auto& uv_rect         = font_data.atlas.uv_rects[ face_index * n_glyphs_per_face + c ];
+        const auto  width           = glyph_bitmap.image.width;
+        const auto  height          = glyph_bitmap.image.height;
+
+        // all glyphs share the atlas texture, and only differ in their texture coordinates
+        const auto geometry = std::make_shared<graphics::Geometry2D>( make_glyph_rectangle_2D( width, height, uv_rect ) );
+        const auto render_pack = graphics::RenderPack2D { geometry,  };
 
         // Now store character for later use
         graphics::Font::Character character
         {
             render_pack,
-            glm::vec2 { texture->get_width(), texture->get_height() },
-            glm::ivec2 { face->glyph->bitmap_left, face->glyph->bitmap_top },
-            // advance is stored in units that are 1/64th of a pixel
-            // bitshift by 6 since 2^6 = 64
-            glm::ivec2( face->glyph->advance.x >> 6, face->glyph->advance.y >> 6 )
+            glm::vec2 { width, height },
+            glyph_bitmap.bearing,
+            glyph_bitmap.advance
         };
 
         character_map.insert( { c, character } );
     }
 
-    graphics::gl::pixel_store( graphics::gl::PixelStorageMode::UnpackAlignment, graphics::gl::Size { 4 } ); // Set back to initial value
+    return character_map;
+}
 
-    FT_Done_Face( face );
+//----------------------------------------------------------------
+// A font together with the atlas texture its glyphs are drawn from.
+// Render packs can't take a texture uniform yet, so the atlas is kept alive by the font instead,
+// by handing out the font through a pointer that shares ownership of both.
+struct AtlasFont
+{
+    std::shared_ptr<graphics::Texture>  atlas_texture;
+    graphics::Font                      font;
+};
 
-    return character_map;
+//----------------------------------------------------------------
+FontDescription read_compiled_font_description( const ContentBytes& bytes )
+{
+    const auto compiled_descriptor  = CompiledDescriptor { bytes, descriptor_format::Kind::Font };
+    const auto descriptor           = compiled_descriptor.get_descriptor<descriptor_format::FontDescriptor>();
+
+    auto font_description = FontDescription { };
+    for ( std::size_t face_index = 0; face_index < n_faces_per_font; ++face_index )
+    {
+        font_description.face_paths[ face_index ] = compiled_descriptor.get_path( descriptor.face_paths[ face_index ] );
+    }
+    font_description.rendering  = static_cast<FontRendering>( descriptor.rendering );
+    font_description.pixel_size = descriptor.pixel_size;
+    font_description.sdf_spread = descriptor.sdf_spread;
+    return font_description;
 }
 
 } // namespace anonymous
 
+//----------------------------------------------------------------
+FT_Face open_font_face( const ContentBytes& bytes )
+{
+    FT_Face face { };
+    const auto lock = std::lock_guard<std::mutex> { ft_library_mutex };
+    CHECK_EQ( FT_New_Memory_Face( ft, bytes.data(), static_cast<FT_Long>( bytes.size() ), 0, &face ), 0, "Could not load font." );
+    return face;
+}
+
+//----------------------------------------------------------------
+void close_font_face( FT_Face face )
+{
+    const auto lock = std::lock_guard<std::mutex> { ft_library_mutex };
+    FT_Done_Face( face );
+}
+
+//----------------------------------------------------------------
+GlyphBitmap rasterize_glyph( FT_Face face, const char32_t codepoint )
+{
+    // Load character glyph
+    CHECK_EQ( FT_Load_Char( face, codepoint, FT_LOAD_RENDER ), 0, "Could not load glyph." );
+
+    const auto& bitmap = face->glyph->bitmap;
+    auto glyph_bitmap = GlyphBitmap { };
+
+    // copy row by row, the rows of a FreeType bitmap can be padded
+    auto pixels = std::vector<uint8_t>( bitmap.width * bitmap.rows );
+    for ( unsigned int row = 0; row < bitmap.rows; ++row )
+    {
+        std::copy
+        (
+            bitmap.buffer + row * bitmap.pitch,
+            bitmap.buffer + row * bitmap.pitch + bitmap.width,
+            pixels.begin() + row * bitmap.width
+        );
+    }
+    glyph_bitmap.image = make_image( std::move( pixels ), static_cast<int>( bitmap.width ), static_cast<int>( bitmap.rows ), 1 );
+
+    glyph_bitmap.bearing = glm::ivec2 { face->glyph->bitmap_left, face->glyph->bitmap_top };
+    // advance is stored in units that are 1/64th of a pixel
+    // bitshift by 6 since 2^6 = 64
+    glyph_bitmap.advance = glm::ivec2( face->glyph->advance.x >> 6, face->glyph->advance.y >> 6 );
+
+    return glyph_bitmap;
+}
+
+//----------------------------------------------------------------
 void init_font_loader()
 {
     CHECK_EQ( FT_Init_FreeType( &ft ), 0, "Could not init FreeType library." );
 }
 
-std::shared_ptr<graphics::Font> load_font( shake::content::ContentManager* content_manager, const io::Path& path )
+//----------------------------------------------------------------
+FontDescription parse_font_description( const json11::Json& json )
 {
-    const auto content = io::file::json::read( path );
+    auto font_description = FontDescription { };
+    font_description.rendering = io::file::json::has_key( json, "rendering" ) && io::file::json::read_as<std::string>( json, { "rendering" } ) == "sdf"
+        ? FontRendering::SignedDistanceField
+        : FontRendering::Bitmap;
+    const auto is_sdf = font_description.rendering == FontRendering::SignedDistanceField;
+
+    font_description.pixel_size = io::file::json::has_key( json, "pixel_size" )
+        ? io::file::json::read_as<int>( json, { "pixel_size" } )
+        : ( is_sdf ? default_sdf_pixel_size : default_pixel_size );
+    font_description.sdf_spread = io::file::json::has_key( json, "sdf_spread" )
+        ? io::file::json::read_as<int>( json, { "sdf_spread" } )
+        : default_sdf_spread;
+
+    const auto face_keys = std::array<const char*, n_faces_per_font> { "default", "itallic", "bold", "bold_itallic" };
+    for ( std::size_t face_index = 0; face_index < n_faces_per_font; ++face_index )
+    {
+        font_description.face_paths[ face_index ] = io::Path { io::file::json::read_as<std::string>( json, { face_keys[ face_index ] } ) };
+    }
 
-    const auto font_default_path        = io::Path{ io::file::json::read_as<std::string>( content, { "default"      } ) };
-    const auto font_itallic_path        = io::Path{ io::file::json::read_as<std::string>( content, { "itallic"      } ) };
-    const auto font_bold_path           = io::Path{ io::file::json::read_as<std::string>( content, { "bold"         } ) };
-    const auto font_bold_itallic_path   = io::Path{ io::file::json::read_as<std::string>( content, { "bold_itallic" } ) };
+    return font_description;
+}
 
-    return std::make_shared<graphics::Font>
+//----------------------------------------------------------------
+// Font files are either json, or descriptors compiled from it
+FontData decode_font( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto descriptor_bytes = content_manager->read_scratch_content( path );
+    const auto font_description = CompiledDescriptor::is_compiled_descriptor( descriptor_bytes )
+        ? read_compiled_font_description( descriptor_bytes )
+        : parse_font_description( parse_json( descriptor_bytes ) );
+
+    const auto rendering    = font_description.rendering;
+    const auto is_sdf       = rendering == FontRendering::SignedDistanceField;
+    const auto pixel_size   = font_description.pixel_size;
+    const auto sdf_spread   = font_description.sdf_spread;
+
+    auto face_bytes = std::array<ContentBytes, n_faces_per_font> { };
+    for ( std::size_t face_index = 0; face_index < n_faces_per_font; ++face_index )
+    {
+        face_bytes[ face_index ] = content_manager->read_scratch_content( content_manager->get_full_path( font_description.face_paths[ face_index ] ) );
+    }
+
+    // rasterizing glyphs, and generating distance fields from them, is slow,
+    // so fonts are cached by everything they are generated from
+    auto source_hash = hash_string( reinterpret_cast<const char*>( &font_cache_version ), sizeof( font_cache_version ) );
+    source_hash = hash_bytes( descriptor_bytes, source_hash );
+    for ( const auto& bytes : face_bytes )
+    {
+        source_hash = hash_bytes( bytes, source_hash );
+    }
+
+    const auto rasterize_font = [ & ]()
+    {
+        // faces are rasterized independently, so do so in parallel
+        auto font_data = FontData { };
+        font_data.rendering     = rendering;
+        font_data.pixel_size    = pixel_size;
+        const auto rasterized_pixel_size = is_sdf ? pixel_size * sdf_supersampling : pixel_size;
+        content_manager->parallel_for( n_faces_per_font, [ & ]( const std::size_t face_index )
+        {
+            font_data.faces[ face_index ] = rasterize_glyphs( face_bytes[ face_index ], rasterized_pixel_size );
+        } );
+
+        if ( is_sdf )
+        {
+            make_signed_distance_fields( content_manager, font_data, sdf_spread );
+        }
+
+        auto glyph_images = std::vector<Image> { };
+        glyph_images.reserve( n_faces_per_font * n_glyphs_per_face );
+        for ( auto& glyph_bitmaps : font_data.faces )
+        {
+            for ( auto& glyph_bitmap : glyph_bitmaps )
+            {
+                glyph_images.emplace_back( glyph_bitmap.image );
+                // the atlas holds the pixels from now on
+                glyph_bitmap.image.pixels.reset();
+            }
+        }
+
+        font_data.atlas = pack_glyph_atlas( glyph_images );
+        LOG
+        (
+            "Packed glyphs of " + path.get_string() + " into a "
+            + std::to_string( font_data.atlas.image.width ) + "x" + std::to_string( font_data.atlas.image.height )
+            + " atlas, " + std::to_string( static_cast<int>( font_data.atlas.occupancy * 100.f ) ) + "% occupied."
+        );
+        return font_data;
+    };
+
+    return content_manager->get_derived_data_cache().get_or_derive<FontData>( "font", source_hash, rasterize_font, serialize_font_data, deserialize_font_data );
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<graphics::Font> upload_font( shake::content::ContentManager* content_manager, const FontData& font_data )
+{
+    content_manager->report_content_size( font_data.atlas.image.get_n_bytes() );
+
+    // the atlas has a power of two width, so its rows meet the default unpack alignment
+    const auto atlas_texture = std::make_shared<graphics::Texture>
     (
-        load_character_map( content_manager, font_default_path ),
-        load_character_map( content_manager, font_itallic_path ),
-        load_character_map( content_manager, font_bold_path ),
-        load_character_map( content_manager, font_bold_itallic_path )
+        const_cast<uint8_t*>( font_data.atlas.image.pixels.get() ),
+        font_data.atlas.image.width,
+        font_data.atlas.image.height,
+        graphics::gl::TextureFormat::R,
+        graphics::gl::Filter::Linear
     );
+
+    // constructed in place, as fonts need not be movable
+    const auto atlas_font = std::shared_ptr<AtlasFont>
+    {
+        new AtlasFont
+        {
+            atlas_texture,
+            graphics::Font
+            (
+                make_character_map( font_data, 0 ),
+                make_character_map( font_data, 1 ),
+                make_character_map( font_data, 2 ),
+                make_character_map( font_data, 3 )
+            )
+        }
+    };
+
+    // the font points into the atlas font, and keeps all of it alive
+    return std::shared_ptr<graphics::Font> { atlas_font, &atlas_font->font };
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<graphics::Font> load_font( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_font( content_manager, decode_font( content_manager, path ) );
 }
 
+//----------------------------------------------------------------
 void destroy_font_loader()
 {
     FT_Done_FreeType( ft );
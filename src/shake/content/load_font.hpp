@@ -1,11 +1,23 @@
 #ifndef LOAD_FONT_HPP
 #define LOAD_FONT_HPP
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "shake/core/math/math.hpp"
 #include "shake/graphics/assets/font.hpp"
+#include "shake/io/file_json.hpp"
 #include "shake/io/path.hpp"
 
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/glyph_atlas.hpp"
+#include "shake/content/load_image.hpp"
+
 namespace shake {
 namespace content {
 
@@ -13,8 +25,74 @@ class ContentManager;
 
 namespace load {
 
+//----------------------------------------------------------------
+// A rasterized glyph in cpu memory, one byte per pixel
+struct GlyphBitmap
+{
+    Image       image   { };
+    glm::ivec2  bearing { };
+    glm::ivec2  advance { };
+};
+
+constexpr std::size_t n_glyphs_per_face = 128;
+using GlyphBitmaps = std::array<GlyphBitmap, n_glyphs_per_face>;
+
+// The default, itallic, bold and bold itallic faces, in that order
+constexpr std::size_t n_faces_per_font = 4;
+
+//----------------------------------------------------------------
+// Signed distance field glyphs store the distance to their outline instead of coverage,
+// so a single atlas can be rendered sharply at any size, using a shader that thresholds the distance.
+enum class FontRendering : int32_t
+{
+    Bitmap,
+    SignedDistanceField
+};
+
+//----------------------------------------------------------------
+// The glyphs of all faces are packed into a single atlas,
+// the rect of a glyph is at index face_index * n_glyphs_per_face + character.
+// Glyph bitmaps only keep their size once they are packed.
+struct FontData
+{
+    FontRendering                               rendering   { FontRendering::Bitmap };
+    int                                         pixel_size  { };
+    std::array<GlyphBitmaps, n_faces_per_font>  faces       { };
+    GlyphAtlas                                  atlas       { };
+};
+
+//----------------------------------------------------------------
+// A parsed font file, with defaults filled in for what it leaves out
+struct FontDescription
+{
+    std::array<io::Path, n_faces_per_font>  face_paths  { };
+    FontRendering                           rendering   { FontRendering::Bitmap };
+    int                                     pixel_size  { };
+    int                                     sdf_spread  { };
+};
+
+//----------------------------------------------------------------
+// The json lists the font files of the four faces,
+// and optionally a pixel size and a "rendering" of either "bitmap" or "sdf".
+// Signed distance field fonts also take an "sdf_spread",
+// the largest distance in pixels that the field can represent.
+FontDescription parse_font_description( const json11::Json& json );
+
 void init_font_loader();
 
+//----------------------------------------------------------------
+// Faces read from the font file bytes, which should outlive them.
+// Opening and closing faces is thread safe, using a single face from multiple threads is not.
+FT_Face open_font_face  ( const ContentBytes& bytes );
+void    close_font_face ( FT_Face face );
+
+//----------------------------------------------------------------
+// Rasterizes a glyph at the pixel size that is set on the face
+GlyphBitmap rasterize_glyph( FT_Face face, const char32_t codepoint );
+
+FontData                        decode_font ( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<graphics::Font> upload_font ( shake::content::ContentManager* content_manager, const FontData& font_data );
+
 std::shared_ptr<graphics::Font> load_font( shake::content::ContentManager* content_manager, const io::Path& path );
 
 void destroy_font_loader();
@@ -0,0 +1,155 @@
+#include "load_image.hpp"
+
+#include <algorithm>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+namespace { // anonymous
+
+// Increment when decoded images change, to invalidate cached images
+constexpr uint32_t image_cache_version = 1;
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+Image decode_image( const ContentBytes& bytes, const int n_channels )
+{
+    auto image = Image { };
+    int n_channels_in_file { };
+
+    // stbi_load_from_memory is reentrant, so this is safe to call from worker threads
+    const auto stb_image_ptr = static_cast<uint8_t*>( stbi_load_from_memory
+    (
+        bytes.data(),
+        static_cast<int>( bytes.size() ),
+        &image.width,
+        &image.height,
+        &n_channels_in_file,
+        n_channels
+    ) );
+    CHECK( stb_image_ptr != nullptr, std::string { "Could not decode image: " } + stbi_failure_reason() );
+
+    image.pixels        = std::shared_ptr<const uint8_t>( stb_image_ptr, []( const uint8_t* ptr ) { stbi_image_free( const_cast<uint8_t*>( ptr ) ); } );
+    image.n_channels    = n_channels != 0 ? n_channels : n_channels_in_file;
+    return image;
+}
+
+//----------------------------------------------------------------
+Image decode_image( const ContentBytes& bytes, const int n_channels, DerivedDataCache& derived_data_cache )
+{
+    auto key = hash_string( reinterpret_cast<const char*>( &image_cache_version ), sizeof( image_cache_version ) );
+    key = hash_string( reinterpret_cast<const char*>( &n_channels ), sizeof( n_channels ), key );
+    key = hash_bytes( bytes, key );
+
+    return derived_data_cache.get_or_derive<Image>
+    (
+        "image",
+        key,
+        [ & ]() { return decode_image( bytes, n_channels ); },
+        []( const Image& image )
+        {
+            auto image_bytes = std::vector<uint8_t> { };
+            serialize_image( image_bytes, image );
+            return image_bytes;
+        },
+        []( const ContentBytes& image_bytes )
+        {
+            auto position = std::size_t { 0 };
+            return deserialize_image( image_bytes, position );
+        }
+    );
+}
+
+//----------------------------------------------------------------
+void serialize_image( std::vector<uint8_t>& bytes, const Image& image )
+{
+    write_pod( bytes, static_cast<int32_t>( image.width      ) );
+    write_pod( bytes, static_cast<int32_t>( image.height     ) );
+    write_pod( bytes, static_cast<int32_t>( image.n_channels ) );
+    bytes.insert( bytes.end(), image.pixels.get(), image.pixels.get() + image.get_n_bytes() );
+}
+
+//----------------------------------------------------------------
+std::optional<Image> deserialize_image( const ContentBytes& bytes, std::size_t& position )
+{
+    int32_t width       { };
+    int32_t height      { };
+    int32_t n_channels  { };
+    if ( !read_pod( bytes, position, width ) || !read_pod( bytes, position, height ) || !read_pod( bytes, position, n_channels ) ) { return std::nullopt; }
+    if ( width < 0 || height < 0 || n_channels < 0 ) { return std::nullopt; }
+
+    auto image = Image { { }, width, height, n_channels };
+    if ( position + image.get_n_bytes() > bytes.size() ) { return std::nullopt; }
+
+    image.pixels = bytes.get_sub_bytes( position, image.get_n_bytes() ).share_data();
+    position += image.get_n_bytes();
+    return image;
+}
+
+//----------------------------------------------------------------
+Image make_image( std::vector<uint8_t> pixels, const int width, const int height, const int n_channels )
+{
+    CHECK_EQ( pixels.size(), static_cast<std::size_t>( width * height * n_channels ), "Unexpected number of pixels." );
+
+    // alias the pixels with the vector that owns them
+    const auto owner = std::make_shared<std::vector<uint8_t>>( std::move( pixels ) );
+    return Image
+    {
+        std::shared_ptr<const uint8_t>( owner, owner->data() ),
+        width,
+        height,
+        n_channels
+    };
+}
+
+//----------------------------------------------------------------
+Image downsample_image( const Image& image )
+{
+    const auto width    = std::max( image.width  / 2, 1 );
+    const auto height   = std::max( image.height / 2, 1 );
+    const auto n_channels = image.n_channels;
+
+    auto pixels = std::vector<uint8_t>( static_cast<std::size_t>( width ) * height * n_channels );
+
+    for ( int y = 0; y < height; ++y )
+    {
+        // odd source dimensions fold their last row or column into the last block
+        const auto y_begin  = y * 2;
+        const auto y_end    = ( y == height - 1 ) ? image.height : y_begin + 2;
+
+        for ( int x = 0; x < width; ++x )
+        {
+            const auto x_begin  = x * 2;
+            const auto x_end    = ( x == width - 1 ) ? image.width : x_begin + 2;
+            const auto n_source_pixels = static_cast<unsigned int>( ( y_end - y_begin ) * ( x_end - x_begin ) );
+
+            for ( int channel = 0; channel < n_channels; ++channel )
+            {
+                unsigned int sum { 0 };
+                for ( int source_y = y_begin; source_y < y_end; ++source_y )
+                {
+                    for ( int source_x = x_begin; source_x < x_end; ++source_x )
+                    {
+                        sum += image.pixels.get()[ ( static_cast<std::size_t>( source_y ) * image.width + source_x ) * n_channels + channel ];
+                    }
+                }
+                // round to nearest
+                pixels[ ( static_cast<std::size_t>( y ) * width + x ) * n_channels + channel ] = static_cast<uint8_t>( ( sum + n_source_pixels / 2 ) / n_source_pixels );
+            }
+        }
+    }
+
+    return make_image( std::move( pixels ), width, height, n_channels );
+}
+
+} // namespace load
+} // namespace content
+} // namespace shake
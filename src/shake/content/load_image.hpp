@@ -0,0 +1,57 @@
+#ifndef LOAD_IMAGE_HPP
+#define LOAD_IMAGE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/derived_data_cache.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+//----------------------------------------------------------------
+// Decoded pixels in cpu memory.
+// The pixels are shared, so an image can be handed from a worker thread
+// to the thread that uploads it, without copying.
+struct Image
+{
+    std::shared_ptr<const uint8_t>  pixels      { };
+    int                             width       { };
+    int                             height      { };
+    int                             n_channels  { };
+
+    inline std::size_t get_n_bytes() const { return static_cast<std::size_t>( width ) * height * n_channels; }
+};
+
+//----------------------------------------------------------------
+// Decodes a png, jpg or other image file supported by stb_image
+Image decode_image( const ContentBytes& bytes, const int n_channels );
+
+//----------------------------------------------------------------
+// Decodes an image only if it is not found in the derived data cache,
+// and stores it there otherwise
+Image decode_image( const ContentBytes& bytes, const int n_channels, DerivedDataCache& derived_data_cache );
+
+//----------------------------------------------------------------
+// Images are serialized as their dimensions followed by their pixels.
+// Deserialized images point into the bytes, instead of copying the pixels.
+void                    serialize_image     ( std::vector<uint8_t>& bytes, const Image& image );
+std::optional<Image>    deserialize_image   ( const ContentBytes& bytes, std::size_t& position );
+
+//----------------------------------------------------------------
+Image make_image( std::vector<uint8_t> pixels, const int width, const int height, const int n_channels );
+
+//----------------------------------------------------------------
+// Halves both dimensions, rounding down to at least one pixel, by averaging blocks of pixels.
+// Used to generate mip maps.
+Image downsample_image( const Image& image );
+
+} // namespace load
+} // namespace content
+} // namespace shake
+
+#endif // LOAD_IMAGE_HPP
@@ -0,0 +1,30 @@
+#include "load_json.hpp"
+
+#include <string>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/content/content_manager.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+//----------------------------------------------------------------
+json11::Json read_json( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return parse_json( content_manager->read_scratch_content( path ) );
+}
+
+//----------------------------------------------------------------
+json11::Json parse_json( const ContentBytes& bytes )
+{
+    auto error = std::string { };
+    const auto json = json11::Json::parse( std::string { bytes.as_string_view() }, error );
+    CHECK( error.empty(), "Could not parse json: " + error );
+    return json;
+}
+
+} // namespace load
+} // namespace content
+} // namespace shake
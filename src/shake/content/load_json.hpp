@@ -0,0 +1,27 @@
+#ifndef LOAD_JSON_HPP
+#define LOAD_JSON_HPP
+
+#include "shake/io/file_json.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_bytes.hpp"
+
+namespace shake {
+namespace content {
+
+class ContentManager;
+
+namespace load {
+
+//----------------------------------------------------------------
+// Like io::file::json::read, but reads through the content manager,
+// so json files can also be read from hosted archives
+json11::Json read_json( shake::content::ContentManager* content_manager, const io::Path& path );
+
+json11::Json parse_json( const ContentBytes& bytes );
+
+} // namespace load
+} // namespace content
+} // namespace shake
+
+#endif // LOAD_JSON_HPP
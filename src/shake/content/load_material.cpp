@@ -4,7 +4,10 @@
 
 #include "shake/io/file_json.hpp"
 
+#include "shake/content/compiled_descriptor.hpp"
 #include "shake/content/content_manager.hpp"
+#include "shake/content/cooked_texture_format.hpp"
+#include "shake/content/load_json.hpp"
 //#include "shake/graphics/geometry/voxel_grid.hpp"
 #include "shake/graphics/gl/gl_enum.hpp"
 
@@ -12,15 +15,39 @@ namespace shake {
 namespace content {
 namespace load {
 
+namespace { // anonymous
+
 //----------------------------------------------------------------
-std::shared_ptr<graphics::Material> load_material( shake::content::ContentManager* content_manager, const io::Path& path )
+MaterialDescription read_compiled_material_description( const ContentBytes& bytes )
 {
-    const auto json_content = io::file::json::read( path );
+    const auto compiled_descriptor  = CompiledDescriptor { bytes, descriptor_format::Kind::Material };
+    const auto descriptor           = compiled_descriptor.get_descriptor<descriptor_format::MaterialDescriptor>();
 
-    const auto shader_path = io::Path{ io::file::json::read_as<std::string>( json_content, "shader" ) };
-    const auto shader = content_manager->get_or_load<graphics::Program>( shader_path );
+    auto material_description = MaterialDescription { };
+    material_description.shader_path = compiled_descriptor.get_path( descriptor.shader_path );
 
-    auto material = std::make_shared<graphics::Material>( shader );
+    // texture paths were checked when the descriptor was compiled
+    const auto uniforms = compiled_descriptor.get_array<descriptor_format::UniformDescriptor>( descriptor.uniforms_offset, descriptor.n_uniforms );
+    material_description.uniforms.reserve( uniforms.size() );
+    for ( const auto& uniform : uniforms )
+    {
+        material_description.uniforms.emplace_back( MaterialDescription::UniformDescription
+        {
+            static_cast<MaterialDescription::UniformType>( uniform.type ),
+            compiled_descriptor.get_path( uniform.path )
+        } );
+    }
+
+    return material_description;
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+MaterialDescription parse_material_description( const json11::Json& json_content )
+{
+    auto material_description = MaterialDescription { };
+    material_description.shader_path = io::Path{ io::file::json::read_as<std::string>( json_content, "shader" ) };
 
     if ( io::file::json::has_key( json_content, "uniforms" ) )
     {
@@ -39,11 +66,9 @@ std::shared_ptr<graphics::Material> load_material( shake::content::ContentManage
                 //    material->set_uniform( "u_sampler2", std::make_unique<graphics::UniformTexture>( voxel_model->get_palette(), texture_unit_index ) );
                 //}
                 //else 
-                if ( file_extension == ".json" )
+                if ( file_extension == ".json" || file_extension == cooked_texture_format::file_extension )
                 {
-                    const auto texture = content_manager->get_or_load<graphics::Texture>( texture_path );
-                    const auto texture_unit_index = to_texture_unit_index( graphics::gl::NamedTextureUnit::Albedo );
-                    //material->set_uniform( "u_sampler2", graphics::UniformTexture { texture, texture_unit_index } );
+                    material_description.uniforms.emplace_back( MaterialDescription::UniformDescription { MaterialDescription::UniformType::Texture, texture_path } );
                 }
                 else
                 {
@@ -53,16 +78,86 @@ std::shared_ptr<graphics::Material> load_material( shake::content::ContentManage
 
             else if ( uniform_json[ "type" ] == "cube_map" )
             {
-                const auto cube_map = content_manager->get_or_load<graphics::CubeMap>( io::Path{ io::file::json::read_as<std::string>( uniform_json, "path" ) } );
-                const auto texture_unit_index = to_texture_unit_index( graphics::gl::NamedTextureUnit::Skybox );
-                //material->set_uniform( "u_sampler_cube", graphics::UniformCubeMap { cube_map, texture_unit_index } );
+                const auto cube_map_path = io::Path{ io::file::json::read_as<std::string>( uniform_json, "path" ) };
+                material_description.uniforms.emplace_back( MaterialDescription::UniformDescription { MaterialDescription::UniformType::CubeMap, cube_map_path } );
             }
         }
     }
 
+    return material_description;
+}
+
+//----------------------------------------------------------------
+MaterialDescription decode_material_description( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto bytes = content_manager->read_scratch_content( path );
+    return CompiledDescriptor::is_compiled_descriptor( bytes )
+        ? read_compiled_material_description( bytes )
+        : parse_material_description( parse_json( bytes ) );
+}
+
+//----------------------------------------------------------------
+MaterialData decode_material( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    auto material_data = MaterialData { decode_material_description( content_manager, path ), { } };
+    material_data.uniforms.reserve( material_data.description.uniforms.size() );
+
+    // reading and decoding images happens here, on the worker thread of an asynchronous load
+    for ( const auto& uniform_description : material_data.description.uniforms )
+    {
+        auto uniform_data = MaterialData::UniformData { uniform_description.type, { }, { } };
+        switch ( uniform_description.type )
+        {
+        case MaterialDescription::UniformType::Texture:
+            uniform_data.upload_texture = content_manager->decode_dependency<graphics::Texture>( uniform_description.path );
+            break;
+        case MaterialDescription::UniformType::CubeMap:
+            uniform_data.upload_cube_map = content_manager->decode_dependency<graphics::CubeMap>( uniform_description.path );
+            break;
+        }
+        material_data.uniforms.emplace_back( std::move( uniform_data ) );
+    }
+
+    return material_data;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<graphics::Material> upload_material( shake::content::ContentManager* content_manager, const MaterialData& material_data )
+{
+    const auto shader = content_manager->get_or_load<graphics::Program>( material_data.description.shader_path );
+
+    auto material = std::make_shared<graphics::Material>( shader );
+
+    for ( const auto& uniform_data : material_data.uniforms )
+    {
+        switch ( uniform_data.type )
+        {
+        case MaterialDescription::UniformType::Texture:
+        {
+            const auto texture = uniform_data.upload_texture();
+            const auto texture_unit_index = to_texture_unit_index( graphics::gl::NamedTextureUnit::Albedo );
+            //material->set_uniform( "u_sampler2", graphics::UniformTexture { texture, texture_unit_index } );
+            break;
+        }
+        case MaterialDescription::UniformType::CubeMap:
+        {
+            const auto cube_map = uniform_data.upload_cube_map();
+            const auto texture_unit_index = to_texture_unit_index( graphics::gl::NamedTextureUnit::Skybox );
+            //material->set_uniform( "u_sampler_cube", graphics::UniformCubeMap { cube_map, texture_unit_index } );
+            break;
+        }
+        }
+    }
+
     return material;
 }
 
+//----------------------------------------------------------------
+std::shared_ptr<graphics::Material> load_material( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_material( content_manager, decode_material( content_manager, path ) );
+}
+
 } // namespace load
 } // namespace content
 } // namespace shake
@@ -1,8 +1,11 @@
 #ifndef LOAD_MATERIAL_HPP
 #define LOAD_MATERIAL_HPP
 
+#include <functional>
 #include <memory>
+#include <vector>
 
+#include "shake/io/file_json.hpp"
 #include "shake/io/path.hpp"
 #include "shake/graphics/material/material.hpp"
 
@@ -13,6 +16,52 @@ class ContentManager;
 
 namespace load {
 
+//----------------------------------------------------------------
+// A parsed material file, with the paths of the content it refers to
+struct MaterialDescription
+{
+    enum class UniformType
+    {
+        Texture,
+        CubeMap
+    };
+
+    struct UniformDescription
+    {
+        UniformType type    { };
+        io::Path    path    { };
+    };
+
+    io::Path                        shader_path { };
+    std::vector<UniformDescription> uniforms    { };
+};
+
+//----------------------------------------------------------------
+// A material, with the textures and cube maps it refers to decoded as well, unless they were cached already,
+// so uploading it only creates graphics objects.
+// The program is still loaded on upload, because programs can only be compiled on the graphics thread.
+struct MaterialData
+{
+    struct UniformData
+    {
+        MaterialDescription::UniformType                    type            { };
+        std::function<std::shared_ptr<graphics::Texture>()> upload_texture  { };
+        std::function<std::shared_ptr<graphics::CubeMap>()> upload_cube_map { };
+    };
+
+    MaterialDescription         description { };
+    std::vector<UniformData>    uniforms    { };
+};
+
+//----------------------------------------------------------------
+// Material files are either json, or descriptors compiled from it by compile_descriptors()
+MaterialDescription                 parse_material_description  ( const json11::Json& json );
+// Only reads the material file, without decoding the content it refers to
+MaterialDescription                 decode_material_description ( shake::content::ContentManager* content_manager, const io::Path& path );
+
+MaterialData                        decode_material ( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<graphics::Material> upload_material ( shake::content::ContentManager* content_manager, const MaterialData& material_data );
+
 std::shared_ptr<graphics::Material> load_material( shake::content::ContentManager* content_manager, const io::Path& path);
 
 } // namespace load
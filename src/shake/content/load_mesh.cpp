@@ -1,23 +1,260 @@
 #include "load_mesh.hpp"
 
-#include "shake/content/content_manager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
 
-#include "shake/core/math/math.hpp"
+#include "shake/core/contracts/contracts.hpp"
 
-#include "shake/io/file_json.hpp"
+#include "shake/content/content_manager.hpp"
+#include "shake/content/mesh_format.hpp"
 
 namespace shake {
 namespace content {
 namespace load {
 
-////----------------------------------------------------------------
-//std::shared_ptr<shake::graphics::Mesh> load_mesh(const io::Path& path)
-//{
-//    const auto content  = io::file::json::read( path );
-//    const auto vertices = io::file::json::read_as<std::vector<float>>( content, {"vertices"} );
-//    const auto indices  = math::integer_sequence<uint32_t>( vertices.size() / 6 ); // 8 floats per vertex
-//    return std::make_shared<graphics::Mesh>( vertices, indices );
-//}
+namespace { // anonymous
+
+//----------------------------------------------------------------
+float dequantize_unorm16( const uint16_t value, const float min, const float max )
+{
+    return min + ( max - min ) * ( static_cast<float>( value ) / 65535.f );
+}
+
+//----------------------------------------------------------------
+// Unfolds the lower half of the octahedron, and projects it back onto the unit sphere
+glm::vec3 decode_octahedron( const int16_t encoded_x, const int16_t encoded_y )
+{
+    const auto sign = []( const float value ) { return value < 0.f ? -1.f : 1.f; };
+
+    auto x = std::max( static_cast<float>( encoded_x ) / 32767.f, -1.f );
+    auto y = std::max( static_cast<float>( encoded_y ) / 32767.f, -1.f );
+    const auto z = 1.f - std::abs( x ) - std::abs( y );
+    if ( z < 0.f )
+    {
+        const auto unfolded_x = ( 1.f - std::abs( y ) ) * sign( x );
+        const auto unfolded_y = ( 1.f - std::abs( x ) ) * sign( y );
+        x = unfolded_x;
+        y = unfolded_y;
+    }
+    const auto normal = glm::vec3 { x, y, z };
+    return normal * ( 1.f / glm::length( normal ) );
+}
+
+//----------------------------------------------------------------
+// The start of a stream, checked to lie within the bytes.
+// The bytes of a loose file or an archive might not be suitably aligned, so values are copied out of them.
+template<typename T>
+const uint8_t* get_stream( const ContentBytes& bytes, const uint64_t offset, const std::size_t n_values )
+{
+    CHECK_LE( offset + n_values * sizeof( T ), bytes.size(), "Cooked mesh is truncated." );
+    return bytes.data() + offset;
+}
+
+//----------------------------------------------------------------
+struct MeshHeader
+{
+    mesh_format::Header             header  { };
+    std::vector<mesh_format::Lod>   lods    { };
+};
+
+MeshHeader read_mesh_header( const ContentBytes& bytes )
+{
+    auto mesh_header = MeshHeader { };
+    auto& header = mesh_header.header;
+    std::memcpy( &header, get_stream<mesh_format::Header>( bytes, 0, 1 ), sizeof( header ) );
+    CHECK_EQ( header.magic,     mesh_format::magic,   "Header of cooked mesh is not as expected." );
+    CHECK_EQ( header.version,   mesh_format::version, "Cooked mesh has an unsupported version, recook it." );
+    CHECK( header.index_size == sizeof( uint16_t ) || header.index_size == sizeof( uint32_t ), "Cooked mesh has an unsupported index size." );
+    CHECK( header.n_lods > 0 && header.n_lods <= mesh_format::max_n_lods, "Cooked mesh has an unsupported number of levels of detail." );
+
+    mesh_header.lods.resize( header.n_lods );
+    std::memcpy( mesh_header.lods.data(), get_stream<mesh_format::Lod>( bytes, sizeof( header ), header.n_lods ), header.n_lods * sizeof( mesh_format::Lod ) );
+    CHECK_EQ( mesh_header.lods.front().n_vertices, header.n_vertices, "Full detail level of cooked mesh should use all vertices." );
+    for ( std::size_t lod_index = 1; lod_index < mesh_header.lods.size(); ++lod_index )
+    {
+        CHECK_LE( mesh_header.lods[ lod_index ].n_vertices, mesh_header.lods[ lod_index - 1 ].n_vertices, "Coarser levels of cooked mesh should use fewer vertices." );
+    }
+    return mesh_header;
+}
+
+//----------------------------------------------------------------
+// Reads the vertices a level of detail adds to those of the coarser levels
+void read_lod_vertices( const ContentBytes& bytes, const mesh_format::Header& header, const mesh_format::Lod& lod, const std::size_t first_vertex, Mesh& mesh )
+{
+    const auto n_vertices   = lod.n_vertices - first_vertex;
+    const auto is_quantized = static_cast<mesh_format::AttributeFormat>( header.attribute_format ) == mesh_format::AttributeFormat::Quantized;
+
+    if ( !is_quantized )
+    {
+        std::memcpy( mesh.positions.data() + first_vertex, get_stream<glm::vec3>( bytes, lod.position_offset, n_vertices ), n_vertices * sizeof( glm::vec3 ) );
+        if ( header.has_normals )   { std::memcpy( mesh.normals.data()  + first_vertex, get_stream<glm::vec3>( bytes, lod.normal_offset,   n_vertices ), n_vertices * sizeof( glm::vec3 ) ); }
+        if ( header.has_uvs )       { std::memcpy( mesh.uvs.data()      + first_vertex, get_stream<glm::vec2>( bytes, lod.uv_offset,       n_vertices ), n_vertices * sizeof( glm::vec2 ) ); }
+        return;
+    }
+
+    const auto quantized_positions = get_stream<uint16_t>( bytes, lod.position_offset, n_vertices * 4 );
+    for ( std::size_t vertex = 0; vertex < n_vertices; ++vertex )
+    {
+        uint16_t quantized_position[ 4 ];
+        std::memcpy( quantized_position, quantized_positions + vertex * sizeof( quantized_position ), sizeof( quantized_position ) );
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            mesh.positions[ first_vertex + vertex ][ axis ] = dequantize_unorm16( quantized_position[ axis ], header.position_min[ axis ], header.position_max[ axis ] );
+        }
+    }
+
+    if ( header.has_normals )
+    {
+        const auto quantized_normals = get_stream<int16_t>( bytes, lod.normal_offset, n_vertices * 2 );
+        for ( std::size_t vertex = 0; vertex < n_vertices; ++vertex )
+        {
+            int16_t quantized_normal[ 2 ];
+            std::memcpy( quantized_normal, quantized_normals + vertex * sizeof( quantized_normal ), sizeof( quantized_normal ) );
+            mesh.normals[ first_vertex + vertex ] = decode_octahedron( quantized_normal[ 0 ], quantized_normal[ 1 ] );
+        }
+    }
+
+    if ( header.has_uvs )
+    {
+        const auto quantized_uvs = get_stream<uint16_t>( bytes, lod.uv_offset, n_vertices * 2 );
+        for ( std::size_t vertex = 0; vertex < n_vertices; ++vertex )
+        {
+            uint16_t quantized_uv[ 2 ];
+            std::memcpy( quantized_uv, quantized_uvs + vertex * sizeof( quantized_uv ), sizeof( quantized_uv ) );
+            mesh.uvs[ first_vertex + vertex ].x = dequantize_unorm16( quantized_uv[ 0 ], header.uv_min[ 0 ], header.uv_max[ 0 ] );
+            mesh.uvs[ first_vertex + vertex ].y = dequantize_unorm16( quantized_uv[ 1 ], header.uv_min[ 1 ], header.uv_max[ 1 ] );
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// Reads the indices of a level of detail, widening 16 bit indices
+void read_lod_indices( const ContentBytes& bytes, const mesh_format::Header& header, const mesh_format::Lod& lod, const std::size_t first_index, Mesh& mesh )
+{
+    const auto indices = mesh.indices.data() + first_index;
+    if ( header.index_size == sizeof( uint16_t ) )
+    {
+        const auto stream = get_stream<uint16_t>( bytes, lod.index_offset, lod.n_indices );
+        for ( std::size_t index_index = 0; index_index < lod.n_indices; ++index_index )
+        {
+            uint16_t index;
+            std::memcpy( &index, stream + index_index * sizeof( index ), sizeof( index ) );
+            indices[ index_index ] = index;
+        }
+    }
+    else { std::memcpy( indices, get_stream<uint32_t>( bytes, lod.index_offset, lod.n_indices ), lod.n_indices * sizeof( uint32_t ) ); }
+
+    if ( lod.n_indices != 0 )
+    {
+        CHECK_LT( *std::max_element( indices, indices + lod.n_indices ), lod.n_vertices, "Cooked mesh refers to a missing vertex. It might be corrupted." );
+    }
+}
+
+//----------------------------------------------------------------
+// The finest level of detail within the triangle budget of a coarse mesh, or the coarsest level if none is
+std::size_t find_coarse_lod( const MeshHeader& mesh_header )
+{
+    for ( std::size_t lod_index = 0; lod_index < mesh_header.lods.size(); ++lod_index )
+    {
+        if ( mesh_header.lods[ lod_index ].n_indices / 3 <= coarse_mesh_max_n_triangles ) { return lod_index; }
+    }
+    return mesh_header.lods.size() - 1;
+}
+
+//----------------------------------------------------------------
+Mesh parse_mesh( const ContentBytes& bytes, const MeshHeader& mesh_header, const std::size_t first_lod )
+{
+    CHECK_LT( first_lod, mesh_header.lods.size(), "Cooked mesh does not have the level of detail." );
+
+    const auto n_vertices = static_cast<std::size_t>( mesh_header.lods[ first_lod ].n_vertices );
+    auto mesh = Mesh { };
+    mesh.positions.resize( n_vertices );
+    if ( mesh_header.header.has_normals )   { mesh.normals.resize( n_vertices ); }
+    if ( mesh_header.header.has_uvs )       { mesh.uvs.resize( n_vertices ); }
+
+    std::size_t n_indices { 0 };
+    for ( auto lod_index = first_lod; lod_index < mesh_header.lods.size(); ++lod_index ) { n_indices += mesh_header.lods[ lod_index ].n_indices; }
+    mesh.indices.resize( n_indices );
+
+    // levels are stored coarsest first, and kept finest first
+    auto first_index = n_indices;
+    for ( auto lod_index = mesh_header.lods.size(); lod_index-- > first_lod; )
+    {
+        const auto& lod = mesh_header.lods[ lod_index ];
+        const auto first_vertex = lod_index + 1 < mesh_header.lods.size() ? std::size_t { mesh_header.lods[ lod_index + 1 ].n_vertices } : std::size_t { 0 };
+        read_lod_vertices( bytes, mesh_header.header, lod, first_vertex, mesh );
+
+        first_index -= lod.n_indices;
+        read_lod_indices( bytes, mesh_header.header, lod, first_index, mesh );
+    }
+
+    for ( auto lod_index = first_lod; lod_index < mesh_header.lods.size(); ++lod_index )
+    {
+        const auto& lod = mesh_header.lods[ lod_index ];
+        mesh.lods.emplace_back( MeshLod { first_index, lod.n_indices, lod.n_vertices, lod.error } );
+        first_index += lod.n_indices;
+    }
+
+    return mesh;
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+Mesh parse_mesh( const ContentBytes& bytes, const std::size_t first_lod )
+{
+    return parse_mesh( bytes, read_mesh_header( bytes ), first_lod );
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<Mesh> decode_mesh( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto mesh = std::make_shared<Mesh>( parse_mesh( content_manager->read_scratch_content( path ) ) );
+    content_manager->report_content_size( mesh->get_n_bytes() );
+    return mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<Mesh> upload_mesh( shake::content::ContentManager*, const std::shared_ptr<Mesh>& mesh )
+{
+    return mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<Mesh> load_mesh( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_mesh( content_manager, decode_mesh( content_manager, path ) );
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<CoarseMesh> decode_coarse_mesh( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    // the header and level table first, to find where the coarse levels end
+    const auto max_n_header_bytes = sizeof( mesh_format::Header ) + mesh_format::max_n_lods * sizeof( mesh_format::Lod );
+    const auto mesh_header  = read_mesh_header( content_manager->read_scratch_content( path, max_n_header_bytes ) );
+    const auto first_lod    = find_coarse_lod( mesh_header );
+
+    const auto& lod = mesh_header.lods[ first_lod ];
+    const auto bytes = content_manager->read_scratch_content( path, static_cast<std::size_t>( lod.index_offset + lod.n_indices * mesh_header.header.index_size ) );
+
+    const auto coarse_mesh = std::make_shared<CoarseMesh>( CoarseMesh { parse_mesh( bytes, mesh_header, first_lod ) } );
+    content_manager->report_content_size( coarse_mesh->get_n_bytes() );
+    return coarse_mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<CoarseMesh> upload_coarse_mesh( shake::content::ContentManager*, const std::shared_ptr<CoarseMesh>& coarse_mesh )
+{
+    return coarse_mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<CoarseMesh> load_coarse_mesh( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_coarse_mesh( content_manager, decode_coarse_mesh( content_manager, path ) );
+}
 
 } // namespace load
 } // namespace content
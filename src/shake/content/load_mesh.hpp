@@ -5,13 +5,40 @@
 
 #include "shake/io/path.hpp"
 
-//#include "graphics/geometry/mesh.hpp"
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/mesh.hpp"
 
 namespace shake {
 namespace content {
+
+class ContentManager;
+
 namespace load {
 
-//std::shared_ptr<graphics::Mesh> load_mesh(const io::Path& path);
+//----------------------------------------------------------------
+// Coarse meshes load the finest level of detail with at most this many triangles, and all coarser levels,
+// or only the coarsest level if it has more
+constexpr std::size_t coarse_mesh_max_n_triangles = 2048;
+
+//----------------------------------------------------------------
+// Reads a cooked mesh (.smesh), dequantizing its attributes and widening 16 bit indices.
+// Only reads the given level of detail and the coarser ones,
+// for which the bytes only need to hold the start of the file.
+Mesh parse_mesh( const ContentBytes& bytes, const std::size_t first_lod = 0 );
+
+// Loads a cooked mesh, cook .obj files with cook_meshes() first.
+// A mesh lives in cpu memory only,
+// so it is constructed entirely by the decoder.
+std::shared_ptr<Mesh> decode_mesh( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<Mesh> upload_mesh( shake::content::ContentManager* content_manager, const std::shared_ptr<Mesh>& mesh );
+
+std::shared_ptr<Mesh> load_mesh( shake::content::ContentManager* content_manager, const io::Path& path );
+
+// Loads the coarse levels of detail of a cooked mesh, reading only the start of the file.
+std::shared_ptr<CoarseMesh> decode_coarse_mesh( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<CoarseMesh> upload_coarse_mesh( shake::content::ContentManager* content_manager, const std::shared_ptr<CoarseMesh>& coarse_mesh );
+
+std::shared_ptr<CoarseMesh> load_coarse_mesh( shake::content::ContentManager* content_manager, const io::Path& path );
 
 } // namespace load
 } // namespace content
@@ -1,5 +1,15 @@
 #include "load_program.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "shake/content/content_manager.hpp"
+#include "shake/content/derived_data_cache.hpp"
+#include "shake/content/load_json.hpp"
+
 #include "shake/io/file.hpp"
 #include "shake/io/file_json.hpp"
 
@@ -10,13 +20,201 @@ namespace shake {
 namespace content {
 namespace load {
 
+namespace { // anonymous
+
+// increment when the preprocessor or the layout of cached binaries changes
+constexpr uint32_t program_cache_version = 1;
+
+using Clock = std::chrono::steady_clock;
+
+std::mutex                                                  program_binary_functions_mutex  { };
+std::optional<ProgramBinaryFunctions>                       program_binary_functions        { };
+
+// Programs by the hash of their preprocessed source, to share equal variants
+std::mutex                                                  program_variants_mutex          { };
+std::map<uint64_t, std::weak_ptr<graphics::Program>>        program_variants                { };
+
+std::atomic<std::size_t>    n_preprocessed              { 0 };
+std::atomic<std::size_t>    n_compiled                  { 0 };
+std::atomic<std::size_t>    n_binary_cache_hits         { 0 };
+std::atomic<std::size_t>    n_variant_hits              { 0 };
+std::atomic<int64_t>        preprocess_nanoseconds      { 0 };
+std::atomic<int64_t>        compile_nanoseconds         { 0 };
+std::atomic<int64_t>        binary_load_nanoseconds     { 0 };
+
 //----------------------------------------------------------------
-std::shared_ptr< graphics::Program > load_program( shake::content::ContentManager* content_manager, const io::Path& path )
+int64_t get_nanoseconds_since( const Clock::time_point start )
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+}
+
+//----------------------------------------------------------------
+std::optional<ProgramBinaryFunctions> get_program_binary_functions()
 {
-    const auto source           = io::file::read_as_string( path );
+    const auto lock = std::lock_guard<std::mutex> { program_binary_functions_mutex };
+    return program_binary_functions;
+}
+
+//----------------------------------------------------------------
+ShaderDefines read_defines( const json11::Json& json )
+{
+    auto defines = ShaderDefines { };
+    for ( const auto& [ name, value ] : json.object_items() )
+    {
+        // numbers and booleans are written as they are in the json
+        defines.emplace( name, value.is_string() ? value.string_value() : value.dump() );
+    }
+    return defines;
+}
+
+//----------------------------------------------------------------
+std::vector<uint8_t> serialize_program_binary( const ProgramBinary& binary )
+{
+    auto bytes = std::vector<uint8_t> { };
+    bytes.reserve( sizeof( uint32_t ) + sizeof( uint64_t ) + binary.data.size() );
+    write_pod( bytes, binary.format );
+    write_pod( bytes, static_cast<uint64_t>( binary.data.size() ) );
+    bytes.insert( bytes.end(), binary.data.begin(), binary.data.end() );
+    return bytes;
+}
+
+//----------------------------------------------------------------
+std::optional<ProgramBinary> deserialize_program_binary( const ContentBytes& bytes )
+{
+    auto binary     = ProgramBinary { };
+    auto position   = std::size_t { 0 };
+    auto n_bytes    = uint64_t { };
+    if ( !read_pod( bytes, position, binary.format ) )  { return std::nullopt; }
+    if ( !read_pod( bytes, position, n_bytes ) )        { return std::nullopt; }
+    if ( position + n_bytes != bytes.size() )           { return std::nullopt; }
+
+    binary.data.assign( bytes.data() + position, bytes.data() + position + n_bytes );
+    return binary;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<graphics::Program> compile_program( const std::string& source )
+{
+    const auto start            = Clock::now();
     const auto vertex_shader    = graphics::make_shader( graphics::gl::ShaderType::Vertex,   source );
     const auto fragment_shader  = graphics::make_shader( graphics::gl::ShaderType::Fragment, source );
-    return std::make_shared< graphics::Program > ( graphics::make_program( vertex_shader, fragment_shader ) );
+    const auto program          = std::make_shared< graphics::Program > ( graphics::make_program( vertex_shader, fragment_shader ) );
+
+    compile_nanoseconds += get_nanoseconds_since( start );
+    ++n_compiled;
+    return program;
+}
+
+//----------------------------------------------------------------
+// Loads the program from a cached binary if possible,
+// and otherwise compiles it, and caches its binary for next time
+std::shared_ptr<graphics::Program> make_program( ContentManager* content_manager, const PreprocessedShader& shader )
+{
+    const auto functions = get_program_binary_functions();
+    auto& derived_data_cache = content_manager->get_derived_data_cache();
+    if ( !functions || !derived_data_cache.is_enabled() ) { return compile_program( shader.source ); }
+
+    // binaries are only valid for the driver that created them
+    auto key = hash_string( reinterpret_cast<const char*>( &program_cache_version ), sizeof( program_cache_version ) );
+    key = hash_string( functions->driver_id.data(), functions->driver_id.size(), key );
+    key = hash_string( reinterpret_cast<const char*>( &shader.hash ), sizeof( shader.hash ), key );
+
+    const auto start = Clock::now();
+    if ( const auto bytes = derived_data_cache.find( "program", key ) )
+    {
+        if ( const auto binary = deserialize_program_binary( *bytes ) )
+        {
+            if ( auto program = functions->make_program( *binary ) )
+            {
+                binary_load_nanoseconds += get_nanoseconds_since( start );
+                ++n_binary_cache_hits;
+                return program;
+            }
+        }
+        LOG( "Cached program binary was rejected, compiling the program instead." );
+    }
+
+    const auto compile_start = Clock::now();
+    auto program = compile_program( shader.source );
+    const auto compile_duration = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - compile_start );
+    if ( const auto binary = functions->get_binary( *program ) )
+    {
+        derived_data_cache.store( "program", key, serialize_program_binary( *binary ), compile_duration );
+    }
+    return program;
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+void set_program_binary_functions( const std::optional<ProgramBinaryFunctions>& functions )
+{
+    const auto lock = std::lock_guard<std::mutex> { program_binary_functions_mutex };
+    program_binary_functions = functions;
+}
+
+//----------------------------------------------------------------
+ProgramLoadStatistics get_program_load_statistics()
+{
+    auto statistics = ProgramLoadStatistics { };
+    statistics.n_preprocessed       = n_preprocessed;
+    statistics.n_compiled           = n_compiled;
+    statistics.n_binary_cache_hits  = n_binary_cache_hits;
+    statistics.n_variant_hits       = n_variant_hits;
+    statistics.preprocess_seconds   = preprocess_nanoseconds    * 1e-9;
+    statistics.compile_seconds      = compile_nanoseconds       * 1e-9;
+    statistics.binary_load_seconds  = binary_load_nanoseconds   * 1e-9;
+    return statistics;
+}
+
+//----------------------------------------------------------------
+PreprocessedShader preprocess_program( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto start = Clock::now();
+
+    auto source     = ContentBytes { };
+    auto defines    = ShaderDefines { };
+    if ( path.get_file_extension() == ".json" )
+    {
+        const auto json = read_json( content_manager, path );
+        source = content_manager->read_scratch_content( content_manager->get_full_path( io::Path { io::file::json::read_as<std::string>( json, { "source" } ) } ) );
+        if ( io::file::json::has_key( json, "defines" ) ) { defines = read_defines( json[ "defines" ] ); }
+    }
+    else
+    {
+        source = content_manager->read_scratch_content( path );
+    }
+
+    const auto read_include = [ content_manager ]( const io::Path& include_path )
+    {
+        return std::string { content_manager->read_scratch_content( content_manager->get_full_path( include_path ) ).as_string_view() };
+    };
+    auto shader = preprocess_shader( source.as_string_view(), defines, read_include );
+
+    preprocess_nanoseconds += get_nanoseconds_since( start );
+    ++n_preprocessed;
+    return shader;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr< graphics::Program > load_program( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto shader = preprocess_program( content_manager, path );
+
+    {
+        const auto lock = std::lock_guard<std::mutex> { program_variants_mutex };
+        if ( const auto program = program_variants[ shader.hash ].lock() )
+        {
+            ++n_variant_hits;
+            return program;
+        }
+    }
+
+    const auto program = make_program( content_manager, shader );
+
+    const auto lock = std::lock_guard<std::mutex> { program_variants_mutex };
+    program_variants[ shader.hash ] = program;
+    return program;
 }
 
 } // namespace load
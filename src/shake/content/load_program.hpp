@@ -1,11 +1,18 @@
 #ifndef LOAD_PROGRAM_HPP
 #define LOAD_PROGRAM_HPP
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "shake/io/path.hpp"
 #include "shake/graphics/material/program.hpp"
 
+#include "shake/content/shader_preprocessor.hpp"
+
 namespace shake {
 namespace content {
 
@@ -13,6 +20,65 @@ class ContentManager;
 
 namespace load {
 
+//----------------------------------------------------------------
+// A linked program in the format of the driver, as returned by glGetProgramBinary
+struct ProgramBinary
+{
+    uint32_t                format  { };
+    std::vector<uint8_t>    data    { };
+};
+
+//----------------------------------------------------------------
+// Program binaries only work with the driver that created them, and not all drivers support them,
+// so the graphics side provides these functions to enable the program binary cache.
+struct ProgramBinaryFunctions
+{
+    // identifies the driver, such as by its vendor, renderer and version,
+    // so binaries of another driver are not even tried
+    std::string driver_id;
+    // returns nothing if the driver can't provide a binary of the program
+    std::function<std::optional<ProgramBinary>( const graphics::Program& )>     get_binary;
+    // returns nullptr if the driver rejects the binary, in which case the program is compiled
+    std::function<std::shared_ptr<graphics::Program>( const ProgramBinary& )>   make_program;
+};
+
+//----------------------------------------------------------------
+// Binaries are stored in the derived data cache of the content manager,
+// so nothing is cached unless it has a cache directory as well.
+// Pass nothing to disable the cache.
+void set_program_binary_functions( const std::optional<ProgramBinaryFunctions>& functions );
+
+//----------------------------------------------------------------
+struct ProgramLoadStatistics
+{
+    std::size_t n_preprocessed          { };
+    std::size_t n_compiled              { };
+    std::size_t n_binary_cache_hits     { };
+    // programs with the same source as a program that was loaded from another path
+    std::size_t n_variant_hits          { };
+    double      preprocess_seconds      { };
+    double      compile_seconds         { };
+    double      binary_load_seconds     { };
+};
+
+ProgramLoadStatistics get_program_load_statistics();
+
+//----------------------------------------------------------------
+// Programs are loaded from a .glsl file, that contains both the vertex and fragment shader,
+// or from a json file that selects a variant of one by the macros to define:
+//
+//     {
+//         "source":   "shaders/lit.glsl",
+//         "defines":  { "SKINNED": "1", "MAX_LIGHTS": "8" }
+//     }
+//
+// Includes are read through the content manager, so changing them reloads the program.
+// Does not need a graphics context.
+PreprocessedShader preprocess_program( shake::content::ContentManager* content_manager, const io::Path& path );
+
+//----------------------------------------------------------------
+// Programs with equal preprocessed sources are shared,
+// and loaded from a program binary if one was cached for their source.
 std::shared_ptr< graphics::Program > load_program( shake::content::ContentManager* content_manager, const io::Path& path );
 
 } // namespace load
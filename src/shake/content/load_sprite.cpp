@@ -1,7 +1,9 @@
 #include "load_sprite.hpp"
 
 #include "shake/io/file_json.hpp"
+#include "shake/content/compiled_descriptor.hpp"
 #include "shake/content/content_manager.hpp"
+#include "shake/content/load_json.hpp"
 #include "shake/graphics/material/texture.hpp"
 
 namespace shake {
@@ -11,7 +13,18 @@ namespace load {
 //----------------------------------------------------------------
 std::unique_ptr<graphics::Sprite> load_sprite ( shake::content::ContentManager* content_manager, const io::Path& path )
 {
-    const auto content      = io::file::json::read( path );
+    const auto bytes = content_manager->read_scratch_content( path );
+
+    // sprite files are either json, or descriptors compiled from it
+    if ( CompiledDescriptor::is_compiled_descriptor( bytes ) )
+    {
+        const auto compiled_descriptor  = CompiledDescriptor { bytes, descriptor_format::Kind::Sprite };
+        const auto descriptor           = compiled_descriptor.get_descriptor<descriptor_format::SpriteDescriptor>();
+        const auto texture              = content_manager->get_or_load<graphics::Texture>( compiled_descriptor.get_path( descriptor.texture_path ) );
+        return std::make_unique<graphics::Sprite> ( descriptor.width, descriptor.height, texture );
+    }
+
+    const auto content      = parse_json( bytes );
 
     const auto texture_path = io::file::json::read_as<std::string>( content, { "texture" } );
     const auto texture      = content_manager->get_or_load<graphics::Texture>( io::Path{ texture_path } );
@@ -2,10 +2,13 @@
 #define LOAD_TEXTURE_HPP
 
 #include <memory>
+#include <vector>
 
 #include "shake/io/path.hpp"
 #include "shake/graphics/material/texture.hpp"
 
+#include "shake/content/load_image.hpp"
+
 namespace shake {
 namespace content {
 
@@ -13,6 +16,25 @@ class ContentManager;
 
 namespace load {
 
+//----------------------------------------------------------------
+// Everything needed to create a texture,
+// produced on a worker thread and uploaded on the graphics thread.
+struct TextureData
+{
+    Image                       image           { };
+    graphics::gl::TextureFormat texture_format  { };
+    graphics::gl::Filter        filter          { };
+    // mip levels below the full size image, only present for cooked textures
+    std::vector<Image>          mip_maps        { };
+};
+
+//----------------------------------------------------------------
+// The number of channels images should be decoded with, to be uploaded in the texture format
+int to_n_channels( const graphics::gl::TextureFormat texture_format );
+
+TextureData                         decode_texture  ( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<graphics::Texture>  upload_texture  ( shake::content::ContentManager* content_manager, const TextureData& texture_data );
+
 std::shared_ptr<graphics::Texture> load_texture ( shake::content::ContentManager* content_manager, const io::Path& path );
 
 } // namespace load
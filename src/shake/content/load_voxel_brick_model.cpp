@@ -0,0 +1,44 @@
+#include "load_voxel_brick_model.hpp"
+
+#include "shake/content/content_manager.hpp"
+#include "shake/content/load_voxel_model.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelBrickModel> decode_voxel_brick_model( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto bytes = content_manager->read_scratch_content( path );
+    const auto voxel_model = parse_voxel_model( bytes );
+
+    auto voxel_brick_model = std::make_shared<VoxelBrickModel>();
+    voxel_brick_model->palette = voxel_model.palette;
+    voxel_brick_model->chunks.resize( voxel_model.chunks.size() );
+
+    // the chunks are independent, so build their brick maps in parallel
+    content_manager->parallel_for( voxel_model.chunks.size(), [ & ]( const std::size_t chunk_index )
+    {
+        voxel_brick_model->chunks[ chunk_index ] = VoxelBrickMap( voxel_model.chunks[ chunk_index ] );
+    } );
+
+    for ( const auto& chunk : voxel_brick_model->chunks ) { content_manager->report_content_size( chunk.get_n_bytes() ); }
+    return voxel_brick_model;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelBrickModel> upload_voxel_brick_model( shake::content::ContentManager*, const std::shared_ptr<VoxelBrickModel>& voxel_brick_model )
+{
+    return voxel_brick_model;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelBrickModel> load_voxel_brick_model( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_voxel_brick_model( content_manager, decode_voxel_brick_model( content_manager, path ) );
+}
+
+} // namespace load
+} // namespace content
+} // namespace shake
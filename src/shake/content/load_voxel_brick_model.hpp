@@ -0,0 +1,30 @@
+#ifndef LOAD_VOXEL_BRICK_MODEL_HPP
+#define LOAD_VOXEL_BRICK_MODEL_HPP
+
+#include <memory>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/voxel_brick_map.hpp"
+
+namespace shake {
+namespace content {
+
+class ContentManager;
+
+namespace load {
+
+// Loads a .vox file as brick maps, for spatial queries such as raycasts, 
+// instead of as a list of voxels.
+// A voxel brick model lives in cpu memory only,
+// so it is constructed entirely by the decoder.
+std::shared_ptr<VoxelBrickModel> decode_voxel_brick_model( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<VoxelBrickModel> upload_voxel_brick_model( shake::content::ContentManager* content_manager, const std::shared_ptr<VoxelBrickModel>& voxel_brick_model );
+
+std::shared_ptr<VoxelBrickModel> load_voxel_brick_model( shake::content::ContentManager* content_manager, const io::Path& path );
+
+} // namespace load
+} // namespace content
+} // namespace shake
+
+#endif // LOAD_VOXEL_BRICK_MODEL_HPP
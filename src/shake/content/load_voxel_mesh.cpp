@@ -0,0 +1,64 @@
+#include "load_voxel_mesh.hpp"
+
+#include "shake/content/content_manager.hpp"
+#include "shake/content/load_voxel_model.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+//----------------------------------------------------------------
+VoxelMesh make_voxel_mesh( shake::content::ContentManager* content_manager, const VoxelModel& voxel_model )
+{
+    const auto n_chunks = voxel_model.chunks.size();
+
+    auto grids = std::vector<DenseVoxelGrid>( n_chunks );
+    content_manager->parallel_for( n_chunks, [ & ]( const std::size_t chunk_index )
+    {
+        grids[ chunk_index ] = make_dense_voxel_grid( voxel_model.chunks[ chunk_index ] );
+    } );
+
+    // every face direction of every chunk is meshed independently
+    auto face_meshes = std::vector<VoxelMesh>( n_chunks * n_voxel_faces );
+    content_manager->parallel_for( face_meshes.size(), [ & ]( const std::size_t index )
+    {
+        face_meshes[ index ] = make_voxel_mesh_faces( grids[ index / n_voxel_faces ], index % n_voxel_faces );
+    } );
+
+    auto voxel_mesh = VoxelMesh { };
+    for ( std::size_t chunk_index = 0; chunk_index < n_chunks; ++chunk_index )
+    {
+        const auto first_index = voxel_mesh.indices.size();
+        for ( std::size_t face_index = 0; face_index < n_voxel_faces; ++face_index )
+        {
+            append_voxel_mesh( voxel_mesh, face_meshes[ chunk_index * n_voxel_faces + face_index ] );
+        }
+        voxel_mesh.submeshes.push_back( VoxelSubmesh { first_index, voxel_mesh.indices.size() - first_index } );
+    }
+    return voxel_mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelMesh> decode_voxel_mesh( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto bytes = content_manager->read_scratch_content( path );
+    const auto voxel_mesh = std::make_shared<VoxelMesh>( make_voxel_mesh( content_manager, parse_voxel_model( bytes ) ) );
+    content_manager->report_content_size( voxel_mesh->vertices.size() * sizeof( VoxelMeshVertex ) + voxel_mesh->indices.size() * sizeof( uint32_t ) );
+    return voxel_mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelMesh> upload_voxel_mesh( shake::content::ContentManager*, const std::shared_ptr<VoxelMesh>& voxel_mesh )
+{
+    return voxel_mesh;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelMesh> load_voxel_mesh( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_voxel_mesh( content_manager, decode_voxel_mesh( content_manager, path ) );
+}
+
+} // namespace load
+} // namespace content
+} // namespace shake
@@ -0,0 +1,35 @@
+#ifndef LOAD_VOXEL_MESH_HPP
+#define LOAD_VOXEL_MESH_HPP
+
+#include <memory>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/voxel_mesh.hpp"
+
+namespace shake {
+namespace content {
+
+class ContentManager;
+
+namespace load {
+
+//----------------------------------------------------------------
+// Meshes every chunk of a voxel model, 
+// using the worker pool of the content manager to mesh chunks and face directions in parallel.
+// The chunks are appended in order, with one submesh each.
+VoxelMesh make_voxel_mesh( shake::content::ContentManager* content_manager, const VoxelModel& voxel_model );
+
+// Loads a .vox file as a surface mesh, instead of as a list of voxels to draw as instanced cubes.
+// A voxel mesh lives in cpu memory only,
+// so it is constructed entirely by the decoder.
+std::shared_ptr<VoxelMesh> decode_voxel_mesh( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<VoxelMesh> upload_voxel_mesh( shake::content::ContentManager* content_manager, const std::shared_ptr<VoxelMesh>& voxel_mesh );
+
+std::shared_ptr<VoxelMesh> load_voxel_mesh( shake::content::ContentManager* content_manager, const io::Path& path );
+
+} // namespace load
+} // namespace content
+} // namespace shake
+
+#endif // LOAD_VOXEL_MESH_HPP
@@ -0,0 +1,238 @@
+#include "load_voxel_model.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/content/content_manager.hpp"
+
+namespace shake {
+namespace content {
+namespace load {
+
+namespace { // anonymous
+
+// Magica Voxel constants and structs
+// See https://github.com/ephtracy/voxel-model/blob/master/MagicaVoxel-file-format-vox.txt
+
+//----------------------------------------------------------------
+constexpr uint32_t make_chunk_id( const char ( &id )[ 5 ] )
+{
+    return static_cast<uint32_t>( id[ 0 ] )
+        | ( static_cast<uint32_t>( id[ 1 ] ) << 8  )
+        | ( static_cast<uint32_t>( id[ 2 ] ) << 16 )
+        | ( static_cast<uint32_t>( id[ 3 ] ) << 24 );
+}
+
+constexpr uint32_t file_id      = make_chunk_id( "VOX " );
+constexpr uint32_t main_id      = make_chunk_id( "MAIN" );
+constexpr uint32_t pack_id      = make_chunk_id( "PACK" );
+constexpr uint32_t size_id      = make_chunk_id( "SIZE" );
+constexpr uint32_t voxels_id    = make_chunk_id( "XYZI" );
+constexpr uint32_t palette_id   = make_chunk_id( "RGBA" );
+
+constexpr VoxelPalette default_palette
+{
+    0x00000000, 0xffffffff, 0xffccffff, 0xff99ffff, 0xff66ffff, 0xff33ffff, 0xff00ffff, 0xffffccff, 0xffccccff, 0xff99ccff, 0xff66ccff, 0xff33ccff, 0xff00ccff, 0xffff99ff, 0xffcc99ff, 0xff9999ff,
+    0xff6699ff, 0xff3399ff, 0xff0099ff, 0xffff66ff, 0xffcc66ff, 0xff9966ff, 0xff6666ff, 0xff3366ff, 0xff0066ff, 0xffff33ff, 0xffcc33ff, 0xff9933ff, 0xff6633ff, 0xff3333ff, 0xff0033ff, 0xffff00ff,
+    0xffcc00ff, 0xff9900ff, 0xff6600ff, 0xff3300ff, 0xff0000ff, 0xffffffcc, 0xffccffcc, 0xff99ffcc, 0xff66ffcc, 0xff33ffcc, 0xff00ffcc, 0xffffcccc, 0xffcccccc, 0xff99cccc, 0xff66cccc, 0xff33cccc,
+    0xff00cccc, 0xffff99cc, 0xffcc99cc, 0xff9999cc, 0xff6699cc, 0xff3399cc, 0xff0099cc, 0xffff66cc, 0xffcc66cc, 0xff9966cc, 0xff6666cc, 0xff3366cc, 0xff0066cc, 0xffff33cc, 0xffcc33cc, 0xff9933cc,
+    0xff6633cc, 0xff3333cc, 0xff0033cc, 0xffff00cc, 0xffcc00cc, 0xff9900cc, 0xff6600cc, 0xff3300cc, 0xff0000cc, 0xffffff99, 0xffccff99, 0xff99ff99, 0xff66ff99, 0xff33ff99, 0xff00ff99, 0xffffcc99,
+    0xffcccc99, 0xff99cc99, 0xff66cc99, 0xff33cc99, 0xff00cc99, 0xffff9999, 0xffcc9999, 0xff999999, 0xff669999, 0xff339999, 0xff009999, 0xffff6699, 0xffcc6699, 0xff996699, 0xff666699, 0xff336699,
+    0xff006699, 0xffff3399, 0xffcc3399, 0xff993399, 0xff663399, 0xff333399, 0xff003399, 0xffff0099, 0xffcc0099, 0xff990099, 0xff660099, 0xff330099, 0xff000099, 0xffffff66, 0xffccff66, 0xff99ff66,
+    0xff66ff66, 0xff33ff66, 0xff00ff66, 0xffffcc66, 0xffcccc66, 0xff99cc66, 0xff66cc66, 0xff33cc66, 0xff00cc66, 0xffff9966, 0xffcc9966, 0xff999966, 0xff669966, 0xff339966, 0xff009966, 0xffff6666,
+    0xffcc6666, 0xff996666, 0xff666666, 0xff336666, 0xff006666, 0xffff3366, 0xffcc3366, 0xff993366, 0xff663366, 0xff333366, 0xff003366, 0xffff0066, 0xffcc0066, 0xff990066, 0xff660066, 0xff330066,
+    0xff000066, 0xffffff33, 0xffccff33, 0xff99ff33, 0xff66ff33, 0xff33ff33, 0xff00ff33, 0xffffcc33, 0xffcccc33, 0xff99cc33, 0xff66cc33, 0xff33cc33, 0xff00cc33, 0xffff9933, 0xffcc9933, 0xff999933,
+    0xff669933, 0xff339933, 0xff009933, 0xffff6633, 0xffcc6633, 0xff996633, 0xff666633, 0xff336633, 0xff006633, 0xffff3333, 0xffcc3333, 0xff993333, 0xff663333, 0xff333333, 0xff003333, 0xffff0033,
+    0xffcc0033, 0xff990033, 0xff660033, 0xff330033, 0xff000033, 0xffffff00, 0xffccff00, 0xff99ff00, 0xff66ff00, 0xff33ff00, 0xff00ff00, 0xffffcc00, 0xffcccc00, 0xff99cc00, 0xff66cc00, 0xff33cc00,
+    0xff00cc00, 0xffff9900, 0xffcc9900, 0xff999900, 0xff669900, 0xff339900, 0xff009900, 0xffff6600, 0xffcc6600, 0xff996600, 0xff666600, 0xff336600, 0xff006600, 0xffff3300, 0xffcc3300, 0xff993300,
+    0xff663300, 0xff333300, 0xff003300, 0xffff0000, 0xffcc0000, 0xff990000, 0xff660000, 0xff330000, 0xff0000ee, 0xff0000dd, 0xff0000bb, 0xff0000aa, 0xff000088, 0xff000077, 0xff000055, 0xff000044,
+    0xff000022, 0xff000011, 0xff00ee00, 0xff00dd00, 0xff00bb00, 0xff00aa00, 0xff008800, 0xff007700, 0xff005500, 0xff004400, 0xff002200, 0xff001100, 0xffee0000, 0xffdd0000, 0xffbb0000, 0xffaa0000,
+    0xff880000, 0xff770000, 0xff550000, 0xff440000, 0xff220000, 0xff110000, 0xffeeeeee, 0xffdddddd, 0xffbbbbbb, 0xffaaaaaa, 0xff888888, 0xff777777, 0xff555555, 0xff444444, 0xff222222, 0xff111111
+};
+
+struct FileHeader
+{
+    uint32_t id;
+    uint32_t version_number;
+};
+
+struct ChunkHeader
+{
+    uint32_t id;
+    uint32_t n_bytes_content;
+    uint32_t n_bytes_children;
+};
+
+struct SizeChunk
+{
+    uint32_t x_size;
+    uint32_t y_size;
+    uint32_t z_size;
+};
+
+struct PaletteChunk
+{
+    uint32_t colors[ 256 ];
+};
+
+//----------------------------------------------------------------
+// Copies a struct out of the bytes, which might not be suitably aligned to read it in place
+template<typename T>
+T read_struct( const uint8_t* data )
+{
+    auto value = T { };
+    std::memcpy( &value, data, sizeof( T ) );
+    return value;
+}
+
+//----------------------------------------------------------------
+// Calls visit( chunk_header, content ) for each chunk within the main chunk,
+// where content points to the bytes of the chunk in place, so nothing is copied.
+template<typename Visit_T>
+void for_each_chunk( const ContentBytes& bytes, Visit_T&& visit )
+{
+    CHECK_GE( bytes.size(), sizeof( FileHeader ) + sizeof( ChunkHeader ), "Vox File is too short. It might be corrupted." );
+
+    const auto header = read_struct<FileHeader>( bytes.data() );
+    CHECK_EQ( header.id, file_id, "Header of VOX file is not as expected." );
+
+    auto position = sizeof( FileHeader );
+    const auto main_chunk = read_struct<ChunkHeader>( bytes.data() + position );
+    position += sizeof( ChunkHeader );
+    CHECK_EQ( main_chunk.id, main_id, "Main chunk not found" );
+    CHECK_EQ( main_chunk.n_bytes_content, 0, "Main chunk contains unexpected content." );
+
+    const auto end_position = position + main_chunk.n_bytes_children;
+    CHECK_LE( end_position, bytes.size(), "Vox File is too short. It might be corrupted." );
+
+    while ( position < end_position )
+    {
+        CHECK_LE( position + sizeof( ChunkHeader ), end_position, "Vox File is too short. It might be corrupted." );
+        const auto chunk_header = read_struct<ChunkHeader>( bytes.data() + position );
+        position += sizeof( ChunkHeader );
+
+        const auto n_bytes_chunk = static_cast<std::size_t>( chunk_header.n_bytes_content ) + chunk_header.n_bytes_children;
+        CHECK_LE( position + n_bytes_chunk, end_position, "Vox File is too short. It might be corrupted." );
+
+        visit( chunk_header, bytes.data() + position );
+
+        // skip over the content and children of the chunk
+        position += n_bytes_chunk;
+    }
+}
+
+//----------------------------------------------------------------
+// Colors [0-254] of the chunk are mapped to palette index [1-255],
+// also see the official .vox file format documentation
+void read_palette_chunk( const ChunkHeader& chunk_header, const uint8_t* content, VoxelPalette& palette )
+{
+    CHECK_EQ( chunk_header.n_bytes_content, sizeof( PaletteChunk ), "Chunk is not of expected size." );
+    palette[ 0 ] = 0;
+    std::memcpy( palette.data() + 1, content, ( palette.size() - 1 ) * sizeof( uint32_t ) );
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+VoxelModel parse_voxel_model( const ContentBytes& bytes )
+{
+    auto voxel_model = VoxelModel { };
+    voxel_model.palette = default_palette;
+
+    // every XYZI chunk is preceded by the SIZE chunk of the same model
+    std::size_t n_voxel_chunks { 0 };
+
+    for_each_chunk( bytes, [ & ]( const ChunkHeader& chunk_header, const uint8_t* content )
+    {
+        if ( chunk_header.id == pack_id )
+        {
+            CHECK_EQ( chunk_header.n_bytes_content, sizeof( uint32_t ), "Chunk is not of expected size." );
+            // every model takes a SIZE and an XYZI chunk, so a corrupt count can't reserve more than the file holds
+            const auto n_models = read_struct<uint32_t>( content );
+            voxel_model.chunks.reserve( std::min<std::size_t>( n_models, bytes.size() / ( 2 * sizeof( ChunkHeader ) ) ) );
+        }
+        else if ( chunk_header.id == size_id )
+        {
+            CHECK_EQ( chunk_header.n_bytes_content, sizeof( SizeChunk ), "Chunk is not of expected size." );
+            const auto size_chunk = read_struct<SizeChunk>( content );
+            CHECK( size_chunk.x_size <= 256 && size_chunk.y_size <= 256 && size_chunk.z_size <= 256, "Vox model is larger than 256^3." );
+
+            auto voxel_chunk = VoxelChunk { };
+            voxel_chunk.size = glm::ivec3
+            {
+                static_cast<int>( size_chunk.x_size ),
+                static_cast<int>( size_chunk.y_size ),
+                static_cast<int>( size_chunk.z_size )
+            };
+            voxel_model.chunks.emplace_back( std::move( voxel_chunk ) );
+        }
+        else if ( chunk_header.id == voxels_id )
+        {
+            CHECK_EQ( n_voxel_chunks + 1, voxel_model.chunks.size(), "XYZI chunk is not preceded by a SIZE chunk." );
+            ++n_voxel_chunks;
+
+            CHECK_GE( chunk_header.n_bytes_content, sizeof( uint32_t ), "Chunk is not of expected size." );
+            const auto n_voxels = read_struct<uint32_t>( content );
+            CHECK_EQ( chunk_header.n_bytes_content, sizeof( uint32_t ) + n_voxels * sizeof( Voxel ), "Chunk is not of expected size." );
+
+            // the layout of voxels in the file matches ours, so copy them at once
+            auto& voxel_chunk = voxel_model.chunks.back();
+            voxel_chunk.voxels.resize( n_voxels );
+            std::memcpy( voxel_chunk.voxels.data(), content + sizeof( uint32_t ), n_voxels * sizeof( Voxel ) );
+
+            // later stages index dense grids with these coordinates
+            for ( const auto& voxel : voxel_chunk.voxels )
+            {
+                CHECK( voxel.x < voxel_chunk.size.x && voxel.y < voxel_chunk.size.y && voxel.z < voxel_chunk.size.z, "Voxel lies outside of its model." );
+            }
+        }
+        else if ( chunk_header.id == palette_id )
+        {
+            read_palette_chunk( chunk_header, content, voxel_model.palette );
+        }
+    } );
+
+    CHECK_EQ( n_voxel_chunks, voxel_model.chunks.size(), "SIZE chunk is not followed by an XYZI chunk." );
+    return voxel_model;
+}
+
+//----------------------------------------------------------------
+VoxelPalette parse_voxel_palette( const ContentBytes& bytes )
+{
+    auto palette = default_palette;
+    for_each_chunk( bytes, [ & ]( const ChunkHeader& chunk_header, const uint8_t* content )
+    {
+        if ( chunk_header.id == palette_id )
+        {
+            read_palette_chunk( chunk_header, content, palette );
+        }
+    } );
+    return palette;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelModel> decode_voxel_model( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    const auto bytes = content_manager->read_scratch_content( path );
+    const auto voxel_model = std::make_shared<VoxelModel>( parse_voxel_model( bytes ) );
+    content_manager->report_content_size( voxel_model->get_n_voxels() * sizeof( Voxel ) + sizeof( VoxelPalette ) );
+    return voxel_model;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelModel> upload_voxel_model( shake::content::ContentManager*, const std::shared_ptr<VoxelModel>& voxel_model )
+{
+    return voxel_model;
+}
+
+//----------------------------------------------------------------
+std::shared_ptr<VoxelModel> load_voxel_model( shake::content::ContentManager* content_manager, const io::Path& path )
+{
+    return upload_voxel_model( content_manager, decode_voxel_model( content_manager, path ) );
+}
+
+} // namespace load
+} // namespace content
+} // namespace shake
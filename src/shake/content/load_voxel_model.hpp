@@ -0,0 +1,39 @@
+#ifndef LOAD_VOXEL_MODEL_HPP
+#define LOAD_VOXEL_MODEL_HPP
+
+#include <memory>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/content_bytes.hpp"
+#include "shake/content/voxel_model.hpp"
+
+namespace shake {
+namespace content {
+
+class ContentManager;
+
+namespace load {
+
+//----------------------------------------------------------------
+// Parses a MagicaVoxel .vox file in a single pass over its bytes.
+// Reads the MAIN, PACK, SIZE, XYZI and RGBA chunks, and skips all others.
+VoxelModel parse_voxel_model( const ContentBytes& bytes );
+
+//----------------------------------------------------------------
+// Only reads the palette of a .vox file, skipping over the voxels.
+// Files without an RGBA chunk use the default MagicaVoxel palette.
+VoxelPalette parse_voxel_palette( const ContentBytes& bytes );
+
+// A voxel model lives in cpu memory only,
+// so it is constructed entirely by the decoder.
+std::shared_ptr<VoxelModel> decode_voxel_model( shake::content::ContentManager* content_manager, const io::Path& path );
+std::shared_ptr<VoxelModel> upload_voxel_model( shake::content::ContentManager* content_manager, const std::shared_ptr<VoxelModel>& voxel_model );
+
+std::shared_ptr<VoxelModel> load_voxel_model( shake::content::ContentManager* content_manager, const io::Path& path );
+
+} // namespace load
+} // namespace content
+} // namespace shake
+
+#endif // LOAD_VOXEL_MODEL_HPP
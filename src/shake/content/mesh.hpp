@@ -0,0 +1,82 @@
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "shake/core/math/math.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A level of detail of a mesh, as a range of its indices.
+// Coarser levels use fewer vertices, which come first, so a level only uses the first n_vertices vertices.
+struct MeshLod
+{
+    std::size_t first_index { };
+    std::size_t n_indices   { };
+    std::size_t n_vertices  { };
+    // how far the level strays from the full detail mesh, in the units of the positions
+    float       error       { };
+};
+
+//----------------------------------------------------------------
+// An indexed triangle list, with its vertex attributes stored as separate streams.
+// Normals and texture coordinates are optional, and are either empty or hold one value per vertex.
+// Levels of detail are optional too, ordered from full detail to coarsest, with indices holding those of all levels.
+// A mesh lives in cpu memory only, the graphics side uploads it as it sees fit.
+struct Mesh
+{
+    std::vector<glm::vec3>  positions   { };
+    std::vector<glm::vec3>  normals     { };
+    std::vector<glm::vec2>  uvs         { };
+    std::vector<uint32_t>   indices     { };
+    std::vector<MeshLod>    lods        { };
+
+    //----------------------------------------------------------------
+    inline std::size_t get_n_vertices()     const { return positions.size(); }
+    inline std::size_t get_n_triangles()    const { return indices.size() / 3; }
+    inline bool        has_normals()        const { return !normals.empty(); }
+    inline bool        has_uvs()            const { return !uvs.empty(); }
+    inline bool        has_lods()           const { return !lods.empty(); }
+
+    //----------------------------------------------------------------
+    inline std::size_t get_n_bytes() const
+    {
+        return positions.size() * sizeof( glm::vec3 )
+            + normals.size()    * sizeof( glm::vec3 )
+            + uvs.size()        * sizeof( glm::vec2 )
+            + indices.size()    * sizeof( uint32_t )
+            + lods.size()       * sizeof( MeshLod );
+    }
+};
+
+//----------------------------------------------------------------
+// The coarse levels of detail of a mesh only, to draw while the full mesh streams in.
+// It is loaded from the same file as the mesh, reading only the start of it.
+struct CoarseMesh : Mesh { };
+
+//----------------------------------------------------------------
+// The size on screen, in pixels, of one unit of length at the given distance from a perspective camera.
+// Scale it by the scale of the mesh, if any.
+inline float get_pixels_per_unit( const float distance, const float vertical_field_of_view, const float viewport_height )
+{
+    return viewport_height / ( 2.f * std::tan( vertical_field_of_view / 2.f ) * distance );
+}
+
+//----------------------------------------------------------------
+// Picks the coarsest level of detail whose error covers at most max_screen_error pixels on screen.
+// Returns 0 for a mesh without levels of detail.
+inline std::size_t select_mesh_lod( const Mesh& mesh, const float pixels_per_unit, const float max_screen_error = 1.f )
+{
+    std::size_t lod_index { 0 };
+    while ( lod_index + 1 < mesh.lods.size() && mesh.lods[ lod_index + 1 ].error * pixels_per_unit <= max_screen_error ) { ++lod_index; }
+    return lod_index;
+}
+
+} // namespace content
+} // namespace shake
+
+#endif // MESH_HPP
@@ -0,0 +1,77 @@
+#ifndef MESH_FORMAT_HPP
+#define MESH_FORMAT_HPP
+
+#include <cstdint>
+
+namespace shake {
+namespace content {
+namespace mesh_format {
+
+//----------------------------------------------------------------
+// Layout of a cooked mesh (.smesh):
+//
+//     Header
+//     Lod, for each level of detail, starting at the full detail level
+//     for each level of detail, starting at the coarsest level:
+//         positions, normals if any, and texture coordinates if any, of the vertices the level adds,
+//         and indices of the level, each aligned to stream_alignment
+//
+// Coarser levels use the first vertices, and finer levels add vertices after them,
+// so the coarse levels of a mesh can be loaded by reading only the start of the file.
+// Attributes are either stored as floats, or quantized:
+//     positions as 4 unorm16 per vertex, the last being padding, within the position bounds
+//     normals as 2 snorm16 per vertex, octahedron encoded
+//     texture coordinates as 2 unorm16 per vertex, within the uv bounds
+// Indices are 16 bit when all vertices can be indexed by them, and 32 bit otherwise.
+// Each stream is read with a single copy, or a single pass when it is quantized.
+
+constexpr uint32_t magic                = 0x48534D53; // *reinterpret_cast<const uint32_t*>( "SMSH" );
+constexpr uint32_t version              = 2;
+constexpr uint64_t stream_alignment     = 16;
+constexpr uint32_t max_n_lods           = 16;
+
+constexpr const char* file_extension    = ".smesh";
+
+enum class AttributeFormat : uint32_t
+{
+    Float,
+    Quantized
+};
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t n_vertices;
+    uint32_t n_lods;
+    uint32_t index_size;
+    uint32_t attribute_format;
+    uint32_t has_normals;
+    uint32_t has_uvs;
+    float    position_min[ 3 ];
+    float    position_max[ 3 ];
+    float    uv_min[ 2 ];
+    float    uv_max[ 2 ];
+};
+
+struct Lod
+{
+    uint64_t position_offset;
+    uint64_t normal_offset;
+    uint64_t uv_offset;
+    uint64_t index_offset;
+    uint32_t n_indices;
+    // used by the level, including those of coarser levels
+    uint32_t n_vertices;
+    float    error;
+    uint32_t padding;
+};
+
+static_assert( sizeof( Header   ) == 72, "Unexpected padding in cooked mesh header." );
+static_assert( sizeof( Lod      ) == 48, "Unexpected padding in cooked mesh level of detail." );
+
+} // namespace mesh_format
+} // namespace content
+} // namespace shake
+
+#endif // MESH_FORMAT_HPP
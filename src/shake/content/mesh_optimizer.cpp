@@ -0,0 +1,451 @@
+#include "mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/content/content_id.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+constexpr auto no_index = std::numeric_limits<uint32_t>::max();
+
+// Tuned by Forsyth for caches of 16 to 64 vertices
+constexpr std::size_t   forsyth_cache_size      = 32;
+constexpr float         last_triangle_score     = 0.75f;
+constexpr float         cache_decay_power       = 1.5f;
+constexpr float         valence_boost_scale     = 2.f;
+constexpr float         valence_boost_power     = 0.5f;
+
+//----------------------------------------------------------------
+// Vertices that are in the cache score higher, as do vertices with few triangles left,
+// so lone triangles are not left behind to be drawn with a cold cache later
+float get_vertex_score( const int cache_position, const uint32_t n_remaining_triangles )
+{
+    if ( n_remaining_triangles == 0 ) { return -1.f; }
+
+    float score { 0.f };
+    if ( cache_position >= 0 )
+    {
+        // the vertices of the last triangle score the same, no matter their order
+        score = cache_position < 3
+            ? last_triangle_score
+            : std::pow( 1.f - static_cast<float>( cache_position - 3 ) / ( forsyth_cache_size - 3 ), cache_decay_power );
+    }
+    return score + valence_boost_scale * std::pow( static_cast<float>( n_remaining_triangles ), -valence_boost_power );
+}
+
+//----------------------------------------------------------------
+// Attributes compared by their bits, with negative zero folded into zero
+struct VertexKey
+{
+    std::array<uint32_t, 8> bits { };
+
+    bool operator==( const VertexKey& other ) const { return bits == other.bits; }
+};
+
+struct VertexKeyHash
+{
+    std::size_t operator()( const VertexKey& key ) const
+    {
+        return static_cast<std::size_t>( hash_string( reinterpret_cast<const char*>( key.bits.data() ), sizeof( key.bits ) ) );
+    }
+};
+
+//----------------------------------------------------------------
+VertexKey make_vertex_key( const Mesh& mesh, const uint32_t vertex )
+{
+    auto values = std::array<float, 8> { };
+    for ( int axis = 0; axis < 3; ++axis )
+    {
+        values[ axis ]                                      = mesh.positions[ vertex ][ axis ];
+        if ( mesh.has_normals() ) { values[ 3 + axis ]      = mesh.normals  [ vertex ][ axis ]; }
+    }
+    if ( mesh.has_uvs() )
+    {
+        values[ 6 ] = mesh.uvs[ vertex ].x;
+        values[ 7 ] = mesh.uvs[ vertex ].y;
+    }
+
+    auto key = VertexKey { };
+    for ( std::size_t value_index = 0; value_index < values.size(); ++value_index )
+    {
+        const auto value = values[ value_index ] + 0.f;
+        std::memcpy( &key.bits[ value_index ], &value, sizeof( value ) );
+    }
+    return key;
+}
+
+//----------------------------------------------------------------
+void append_vertex( Mesh& mesh, const Mesh& source, const uint32_t vertex )
+{
+    mesh.positions.emplace_back( source.positions[ vertex ] );
+    if ( source.has_normals() ) { mesh.normals.emplace_back( source.normals[ vertex ] ); }
+    if ( source.has_uvs() )     { mesh.uvs.emplace_back( source.uvs[ vertex ] ); }
+}
+
+//----------------------------------------------------------------
+std::size_t get_n_vertices( const std::vector<uint32_t>& indices )
+{
+    return indices.empty() ? 0 : static_cast<std::size_t>( *std::max_element( indices.begin(), indices.end() ) ) + 1;
+}
+
+//----------------------------------------------------------------
+// The number of vertices of each triangle that miss a fifo cache
+std::vector<uint8_t> simulate_vertex_cache( const std::vector<uint32_t>& indices, const std::size_t n_vertices, const std::size_t cache_size )
+{
+    // a vertex is in the cache if fewer than cache_size vertices were transformed since it was
+    auto transformed_at = std::vector<std::size_t>( n_vertices, 0 );
+    std::size_t n_transformed { 0 };
+
+    auto n_misses = std::vector<uint8_t>( indices.size() / 3, 0 );
+    for ( std::size_t index_index = 0; index_index < n_misses.size() * 3; ++index_index )
+    {
+        const auto vertex = indices[ index_index ];
+        if ( transformed_at[ vertex ] == 0 || n_transformed - transformed_at[ vertex ] >= cache_size )
+        {
+            transformed_at[ vertex ] = ++n_transformed;
+            ++n_misses[ index_index / 3 ];
+        }
+    }
+    return n_misses;
+}
+
+//----------------------------------------------------------------
+// Reorders the clusters, which start at the given triangles, by how much they face away from the center of the mesh
+std::vector<uint32_t> sort_clusters
+(
+    const std::vector<uint32_t>&    indices,
+    const std::vector<glm::vec3>&   positions,
+    const std::vector<std::size_t>& cluster_starts
+)
+{
+    const auto n_triangles = indices.size() / 3;
+    const auto get_corner = [ & ]( const std::size_t triangle, const std::size_t corner ) { return positions[ indices[ triangle * 3 + corner ] ]; };
+
+    // centroids and normals weighted by area, which is half the length of the cross product
+    auto mesh_centroid  = glm::vec3 { 0.f };
+    auto mesh_area      = 0.f;
+    auto cluster_centroids  = std::vector<glm::vec3>( cluster_starts.size(), glm::vec3 { 0.f } );
+    auto cluster_normals    = std::vector<glm::vec3>( cluster_starts.size(), glm::vec3 { 0.f } );
+    auto cluster_areas      = std::vector<float>    ( cluster_starts.size(), 0.f );
+    for ( std::size_t cluster = 0; cluster < cluster_starts.size(); ++cluster )
+    {
+        const auto end = cluster + 1 < cluster_starts.size() ? cluster_starts[ cluster + 1 ] : n_triangles;
+        for ( auto triangle = cluster_starts[ cluster ]; triangle < end; ++triangle )
+        {
+            const auto a = get_corner( triangle, 0 );
+            const auto b = get_corner( triangle, 1 );
+            const auto c = get_corner( triangle, 2 );
+            const auto normal   = glm::cross( b - a, c - a );
+            const auto area     = glm::length( normal );
+            const auto centroid = ( a + b + c ) * ( area / 3.f );
+
+            cluster_centroids[ cluster ]    = cluster_centroids[ cluster ] + centroid;
+            cluster_normals[ cluster ]      = cluster_normals[ cluster ] + normal;
+            cluster_areas[ cluster ]        += area;
+            mesh_centroid                   = mesh_centroid + centroid;
+            mesh_area                       += area;
+        }
+    }
+    if ( mesh_area > 0.f ) { mesh_centroid = mesh_centroid * ( 1.f / mesh_area ); }
+
+    auto sort_keys = std::vector<float>( cluster_starts.size(), 0.f );
+    for ( std::size_t cluster = 0; cluster < cluster_starts.size(); ++cluster )
+    {
+        const auto normal_length = glm::length( cluster_normals[ cluster ] );
+        if ( cluster_areas[ cluster ] <= 0.f || normal_length <= 0.f ) { continue; }
+        const auto centroid = cluster_centroids[ cluster ] * ( 1.f / cluster_areas[ cluster ] );
+        sort_keys[ cluster ] = glm::dot( centroid - mesh_centroid, cluster_normals[ cluster ] * ( 1.f / normal_length ) );
+    }
+
+    auto cluster_order = std::vector<std::size_t>( cluster_starts.size() );
+    std::iota( cluster_order.begin(), cluster_order.end(), std::size_t { 0 } );
+    std::stable_sort( cluster_order.begin(), cluster_order.end(), [ & ]( const std::size_t a, const std::size_t b ) { return sort_keys[ a ] > sort_keys[ b ]; } );
+
+    auto sorted_indices = std::vector<uint32_t> { };
+    sorted_indices.reserve( indices.size() );
+    for ( const auto cluster : cluster_order )
+    {
+        const auto begin    = cluster_starts[ cluster ] * 3;
+        const auto end      = ( cluster + 1 < cluster_starts.size() ? cluster_starts[ cluster + 1 ] : n_triangles ) * 3;
+        sorted_indices.insert( sorted_indices.end(), indices.begin() + begin, indices.begin() + end );
+    }
+    return sorted_indices;
+}
+
+//----------------------------------------------------------------
+// Clusters start where all vertices of a triangle miss the cache, which reordering can't make worse,
+// and, if allowed, where two vertices miss while the cluster so far does better than the threshold
+std::vector<std::size_t> find_cluster_starts
+(
+    const std::vector<uint8_t>& n_misses,
+    const float                 max_cluster_acmr,
+    const bool                  is_soft_split_allowed
+)
+{
+    auto cluster_starts = std::vector<std::size_t> { 0 };
+    std::size_t n_cluster_misses    { 0 };
+    std::size_t n_cluster_triangles { 0 };
+    for ( std::size_t triangle = 0; triangle < n_misses.size(); ++triangle )
+    {
+        const auto is_hard_split = n_misses[ triangle ] == 3;
+        const auto is_soft_split = is_soft_split_allowed
+            && n_misses[ triangle ] == 2
+            && n_cluster_triangles != 0
+            && static_cast<float>( n_cluster_misses ) / n_cluster_triangles <= max_cluster_acmr;
+        if ( triangle != 0 && ( is_hard_split || is_soft_split ) )
+        {
+            cluster_starts.emplace_back( triangle );
+            n_cluster_misses    = 0;
+            n_cluster_triangles = 0;
+        }
+        n_cluster_misses += n_misses[ triangle ];
+        ++n_cluster_triangles;
+    }
+    return cluster_starts;
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+VertexCacheStatistics analyze_vertex_cache( const std::vector<uint32_t>& indices, const std::size_t n_vertices, const std::size_t cache_size )
+{
+    const auto n_misses = simulate_vertex_cache( indices, n_vertices, cache_size );
+
+    auto is_used = std::vector<bool>( n_vertices, false );
+    for ( const auto index : indices ) { is_used[ index ] = true; }
+    const auto n_used_vertices = static_cast<std::size_t>( std::count( is_used.begin(), is_used.end(), true ) );
+
+    auto statistics = VertexCacheStatistics { };
+    for ( const auto n_triangle_misses : n_misses ) { statistics.n_transformed += n_triangle_misses; }
+    statistics.acmr = n_misses.empty()      ? 0.f : static_cast<float>( statistics.n_transformed ) / n_misses.size();
+    statistics.atvr = n_used_vertices == 0  ? 0.f : static_cast<float>( statistics.n_transformed ) / n_used_vertices;
+    return statistics;
+}
+
+//----------------------------------------------------------------
+void weld_vertices( Mesh& mesh )
+{
+    auto welded = Mesh { };
+    welded.indices.reserve( mesh.indices.size() );
+    welded.lods = mesh.lods;
+
+    auto vertices = std::unordered_map<VertexKey, uint32_t, VertexKeyHash> { };
+    vertices.reserve( mesh.get_n_vertices() );
+    for ( const auto index : mesh.indices )
+    {
+        const auto [ it, is_new ] = vertices.emplace( make_vertex_key( mesh, index ), static_cast<uint32_t>( welded.get_n_vertices() ) );
+        if ( is_new ) { append_vertex( welded, mesh, index ); }
+        welded.indices.emplace_back( it->second );
+    }
+
+    mesh = std::move( welded );
+}
+
+//----------------------------------------------------------------
+void optimize_vertex_cache( std::vector<uint32_t>& indices, const std::size_t n_vertices )
+{
+    CHECK_EQ( indices.size() % 3, 0, "Indices should form a triangle list." );
+    const auto n_triangles = indices.size() / 3;
+    if ( n_triangles == 0 ) { return; }
+
+    // the triangles of every vertex, stored contiguously, with the ones that are left at the front
+    auto triangle_offsets = std::vector<uint32_t>( n_vertices + 1, 0 );
+    for ( const auto index : indices ) { ++triangle_offsets[ index + 1 ]; }
+    std::partial_sum( triangle_offsets.begin(), triangle_offsets.end(), triangle_offsets.begin() );
+
+    auto n_remaining_triangles = std::vector<uint32_t>( n_vertices );
+    for ( std::size_t vertex = 0; vertex < n_vertices; ++vertex ) { n_remaining_triangles[ vertex ] = triangle_offsets[ vertex + 1 ] - triangle_offsets[ vertex ]; }
+
+    auto vertex_triangles   = std::vector<uint32_t>( indices.size() );
+    auto fill_offsets       = triangle_offsets;
+    for ( std::size_t index_index = 0; index_index < indices.size(); ++index_index )
+    {
+        vertex_triangles[ fill_offsets[ indices[ index_index ] ]++ ] = static_cast<uint32_t>( index_index / 3 );
+    }
+
+    auto cache_positions    = std::vector<int>( n_vertices, -1 );
+    auto vertex_scores      = std::vector<float>( n_vertices );
+    for ( std::size_t vertex = 0; vertex < n_vertices; ++vertex ) { vertex_scores[ vertex ] = get_vertex_score( -1, n_remaining_triangles[ vertex ] ); }
+
+    auto triangle_scores    = std::vector<float>( n_triangles );
+    for ( std::size_t triangle = 0; triangle < n_triangles; ++triangle )
+    {
+        triangle_scores[ triangle ] = vertex_scores[ indices[ triangle * 3 ] ] + vertex_scores[ indices[ triangle * 3 + 1 ] ] + vertex_scores[ indices[ triangle * 3 + 2 ] ];
+    }
+    auto is_emitted = std::vector<bool>( n_triangles, false );
+
+    auto optimized_indices = std::vector<uint32_t> { };
+    optimized_indices.reserve( indices.size() );
+
+    // the emitted triangle goes in front, so the cache briefly holds 3 more vertices
+    auto cache      = std::vector<uint32_t> { };
+    auto new_cache  = std::vector<uint32_t> { };
+    cache.reserve       ( forsyth_cache_size + 3 );
+    new_cache.reserve   ( forsyth_cache_size + 3 );
+
+    auto best_triangle = static_cast<uint32_t>( std::max_element( triangle_scores.begin(), triangle_scores.end() ) - triangle_scores.begin() );
+    std::size_t next_unemitted_triangle { 0 };
+
+    while ( optimized_indices.size() < indices.size() )
+    {
+        // when no triangle uses a cached vertex, continue in input order
+        if ( best_triangle == no_index )
+        {
+            while ( is_emitted[ next_unemitted_triangle ] ) { ++next_unemitted_triangle; }
+            best_triangle = static_cast<uint32_t>( next_unemitted_triangle );
+        }
+
+        is_emitted[ best_triangle ] = true;
+        new_cache.clear();
+        for ( std::size_t corner = 0; corner < 3; ++corner )
+        {
+            const auto vertex = indices[ best_triangle * 3 + corner ];
+            optimized_indices.emplace_back( vertex );
+            new_cache.emplace_back( vertex );
+
+            const auto begin    = vertex_triangles.begin() + triangle_offsets[ vertex ];
+            const auto end      = begin + n_remaining_triangles[ vertex ];
+            std::iter_swap( std::find( begin, end, best_triangle ), end - 1 );
+            --n_remaining_triangles[ vertex ];
+        }
+        for ( const auto vertex : cache )
+        {
+            if ( std::find( new_cache.begin(), new_cache.begin() + 3, vertex ) == new_cache.begin() + 3 ) { new_cache.emplace_back( vertex ); }
+        }
+
+        // rescore the vertices in the cache, including those that just fell out of it, and their triangles
+        for ( std::size_t cache_index = 0; cache_index < new_cache.size(); ++cache_index )
+        {
+            const auto vertex = new_cache[ cache_index ];
+            cache_positions[ vertex ] = cache_index < forsyth_cache_size ? static_cast<int>( cache_index ) : -1;
+
+            const auto score = get_vertex_score( cache_positions[ vertex ], n_remaining_triangles[ vertex ] );
+            const auto score_difference = score - vertex_scores[ vertex ];
+            vertex_scores[ vertex ] = score;
+
+            const auto begin = vertex_triangles.begin() + triangle_offsets[ vertex ];
+            for ( auto it = begin; it != begin + n_remaining_triangles[ vertex ]; ++it ) { triangle_scores[ *it ] += score_difference; }
+        }
+        if ( new_cache.size() > forsyth_cache_size ) { new_cache.resize( forsyth_cache_size ); }
+        std::swap( cache, new_cache );
+
+        // the next triangle is the best one that uses a cached vertex
+        best_triangle = no_index;
+        auto best_score = std::numeric_limits<float>::lowest();
+        for ( const auto vertex : cache )
+        {
+            const auto begin = vertex_triangles.begin() + triangle_offsets[ vertex ];
+            for ( auto it = begin; it != begin + n_remaining_triangles[ vertex ]; ++it )
+            {
+                if ( triangle_scores[ *it ] > best_score )
+                {
+                    best_score      = triangle_scores[ *it ];
+                    best_triangle   = *it;
+                }
+            }
+        }
+    }
+
+    indices = std::move( optimized_indices );
+}
+
+//----------------------------------------------------------------
+void optimize_overdraw( std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, const float threshold )
+{
+    if ( indices.empty() ) { return; }
+
+    const auto n_vertices   = get_n_vertices( indices );
+    const auto n_misses     = simulate_vertex_cache( indices, n_vertices, default_vertex_cache_size );
+    const auto acmr         = analyze_vertex_cache( indices, n_vertices ).acmr;
+
+    // splitting into more clusters sorts better, but costs cache misses at the splits,
+    // so fall back to fewer clusters, and then to the original order, if the cost is over the threshold
+    for ( const auto is_soft_split_allowed : { true, false } )
+    {
+        const auto cluster_starts = find_cluster_starts( n_misses, acmr * threshold, is_soft_split_allowed );
+        auto sorted_indices = sort_clusters( indices, positions, cluster_starts );
+        if ( analyze_vertex_cache( sorted_indices, n_vertices ).acmr <= acmr * threshold )
+        {
+            indices = std::move( sorted_indices );
+            return;
+        }
+    }
+}
+
+//----------------------------------------------------------------
+void optimize_vertex_fetch( Mesh& mesh )
+{
+    auto remap = std::vector<uint32_t>( mesh.get_n_vertices(), no_index );
+
+    auto reordered = Mesh { };
+    reordered.indices   = mesh.indices;
+    reordered.lods      = mesh.lods;
+
+    // the vertices of coarser levels come first, finer levels only add vertices after them
+    const auto remap_indices = [ & ]( const std::size_t first_index, const std::size_t n_indices )
+    {
+        for ( auto index_index = first_index; index_index < first_index + n_indices; ++index_index )
+        {
+            const auto vertex = mesh.indices[ index_index ];
+            if ( remap[ vertex ] == no_index )
+            {
+                remap[ vertex ] = static_cast<uint32_t>( reordered.get_n_vertices() );
+                append_vertex( reordered, mesh, vertex );
+            }
+            reordered.indices[ index_index ] = remap[ vertex ];
+        }
+    };
+
+    if ( mesh.has_lods() )
+    {
+        for ( auto lod = reordered.lods.rbegin(); lod != reordered.lods.rend(); ++lod )
+        {
+            remap_indices( lod->first_index, lod->n_indices );
+            lod->n_vertices = reordered.get_n_vertices();
+        }
+    }
+    else { remap_indices( 0, mesh.indices.size() ); }
+
+    mesh = std::move( reordered );
+}
+
+//----------------------------------------------------------------
+void optimize_mesh( Mesh& mesh )
+{
+    weld_vertices( mesh );
+
+    // every level of detail is drawn on its own
+    const auto optimize_triangles = [ & ]( std::vector<uint32_t>& indices )
+    {
+        optimize_vertex_cache( indices, mesh.get_n_vertices() );
+        optimize_overdraw( indices, mesh.positions );
+    };
+
+    if ( mesh.has_lods() )
+    {
+        for ( const auto& lod : mesh.lods )
+        {
+            const auto begin = mesh.indices.begin() + static_cast<std::ptrdiff_t>( lod.first_index );
+            auto lod_indices = std::vector<uint32_t>( begin, begin + static_cast<std::ptrdiff_t>( lod.n_indices ) );
+            optimize_triangles( lod_indices );
+            std::copy( lod_indices.begin(), lod_indices.end(), begin );
+        }
+    }
+    else { optimize_triangles( mesh.indices ); }
+
+    optimize_vertex_fetch( mesh );
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,74 @@
+#ifndef MESH_OPTIMIZER_HPP
+#define MESH_OPTIMIZER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "shake/core/math/math.hpp"
+
+#include "shake/content/mesh.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// The size of the fifo cache that vertex cache statistics are measured with,
+// which is about the number of vertices that recent gpus keep of previous triangles
+constexpr std::size_t default_vertex_cache_size = 16;
+
+//----------------------------------------------------------------
+struct VertexCacheStatistics
+{
+    // average cache miss ratio, vertices transformed per triangle, between 0.5 and 3
+    float       acmr                { };
+    // average transform to vertex ratio, vertices transformed per vertex, 1 is optimal
+    float       atvr                { };
+    std::size_t n_transformed       { };
+};
+
+VertexCacheStatistics analyze_vertex_cache
+(
+    const std::vector<uint32_t>&    indices,
+    const std::size_t               n_vertices,
+    const std::size_t               cache_size = default_vertex_cache_size
+);
+
+//----------------------------------------------------------------
+// Merges vertices with exactly equal attributes, such as the corners of a triangle soup,
+// so triangles share them, and drops vertices that no triangle refers to.
+// Vertices are no longer ordered by level of detail afterwards, until optimize_vertex_fetch().
+void weld_vertices( Mesh& mesh );
+
+//----------------------------------------------------------------
+// Reorders triangles so they reuse recently transformed vertices,
+// using Forsyth's linear speed vertex cache optimization, which does not depend on the exact cache size.
+void optimize_vertex_cache( std::vector<uint32_t>& indices, const std::size_t n_vertices );
+
+//----------------------------------------------------------------
+// Reorders clusters of triangles so that those facing outwards are drawn first,
+// which lets them occlude the rest of the mesh from most view directions.
+// Clusters are split where the vertex cache misses anyway,
+// and the cache miss ratio grows by at most the threshold, such as 1.05 for 5%.
+// Call after optimize_vertex_cache().
+void optimize_overdraw
+(
+    std::vector<uint32_t>&          indices,
+    const std::vector<glm::vec3>&   positions,
+    const float                     threshold = 1.05f
+);
+
+//----------------------------------------------------------------
+// Reorders vertices in the order triangles first use them, so they are fetched from memory in order.
+// The vertices of coarser levels of detail come first, and the vertex counts of the levels are updated.
+// Call after reordering triangles.
+void optimize_vertex_fetch( Mesh& mesh );
+
+//----------------------------------------------------------------
+// Welds the mesh, and optimizes it for the vertex cache, overdraw and vertex fetch, in that order.
+// The triangles of each level of detail are optimized separately.
+void optimize_mesh( Mesh& mesh );
+
+} // namespace content
+} // namespace shake
+
+#endif // MESH_OPTIMIZER_HPP
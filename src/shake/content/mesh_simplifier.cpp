@@ -0,0 +1,440 @@
+#include "mesh_simplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+// A collapse may turn the triangles around it by at most about 75 degrees, so the surface does not fold over
+constexpr float min_normal_cos = 0.25f;
+
+// Levels of detail with an error above this part of the extent of the mesh no longer resemble it
+constexpr float max_relative_lod_error = 0.5f;
+
+//----------------------------------------------------------------
+// The sum of the squared distances of a point to a set of planes,
+// as the upper half of a symmetric 4x4 matrix: xx xy xz xw yy yz yw zz zw ww
+struct Quadric
+{
+    std::array<double, 10> m { };
+
+    //----------------------------------------------------------------
+    void add_plane( const glm::vec3& normal, const float distance )
+    {
+        const auto plane = std::array<double, 4> { normal.x, normal.y, normal.z, distance };
+        std::size_t element { 0 };
+        for ( std::size_t row = 0; row < 4; ++row )
+        for ( std::size_t column = row; column < 4; ++column )
+        {
+            m[ element++ ] += plane[ row ] * plane[ column ];
+        }
+    }
+
+    //----------------------------------------------------------------
+    void add( const Quadric& other )
+    {
+        for ( std::size_t element = 0; element < m.size(); ++element ) { m[ element ] += other.m[ element ]; }
+    }
+
+    //----------------------------------------------------------------
+    double evaluate( const glm::vec3& point ) const
+    {
+        const double x = point.x;
+        const double y = point.y;
+        const double z = point.z;
+        const auto error =
+              m[ 0 ] * x * x + 2. * m[ 1 ] * x * y + 2. * m[ 2 ] * x * z + 2. * m[ 3 ] * x
+            + m[ 4 ] * y * y + 2. * m[ 5 ] * y * z + 2. * m[ 6 ] * y
+            + m[ 7 ] * z * z + 2. * m[ 8 ] * z
+            + m[ 9 ];
+        return std::max( error, 0. );
+    }
+};
+
+//----------------------------------------------------------------
+struct Collapse
+{
+    uint32_t    from    { };
+    uint32_t    to      { };
+    double      cost    { };
+};
+
+//----------------------------------------------------------------
+// Vertices with equal positions, split by seams, are treated as one, by the first of them.
+// Quadrics, locks and adjacency are stored by that vertex.
+class Simplifier
+{
+public:
+    //----------------------------------------------------------------
+    Simplifier( const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices )
+        : m_positions       { positions }
+        , m_position_ids    ( positions.size() )
+        , m_is_locked       ( positions.size(), false )
+        , m_quadrics        ( positions.size() )
+    {
+        CHECK_EQ( indices.size() % 3, 0, "Indices should form a triangle list." );
+
+        // vertices with equal positions are next to each other once sorted
+        auto sorted_vertices = std::vector<uint32_t>( positions.size() );
+        std::iota( sorted_vertices.begin(), sorted_vertices.end(), 0u );
+        const auto to_tuple = [ & ]( const uint32_t vertex ) { return std::make_tuple( positions[ vertex ].x, positions[ vertex ].y, positions[ vertex ].z ); };
+        std::stable_sort( sorted_vertices.begin(), sorted_vertices.end(), [ & ]( const uint32_t a, const uint32_t b ) { return to_tuple( a ) < to_tuple( b ); } );
+        for ( std::size_t sorted_index = 0; sorted_index < sorted_vertices.size(); ++sorted_index )
+        {
+            const auto vertex = sorted_vertices[ sorted_index ];
+            const auto is_new_position = sorted_index == 0 || to_tuple( sorted_vertices[ sorted_index - 1 ] ) != to_tuple( vertex );
+            m_position_ids[ vertex ] = is_new_position ? vertex : m_position_ids[ sorted_vertices[ sorted_index - 1 ] ];
+        }
+
+        // triangles without area in any direction can't be simplified, and don't need to be drawn
+        m_indices.reserve( indices.size() );
+        for ( std::size_t triangle = 0; triangle < indices.size() / 3; ++triangle )
+        {
+            if ( !is_degenerate( indices[ triangle * 3 ], indices[ triangle * 3 + 1 ], indices[ triangle * 3 + 2 ] ) )
+            {
+                m_indices.insert( m_indices.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3 );
+            }
+        }
+
+        lock_seams();
+        lock_borders();
+
+        for ( std::size_t triangle = 0; triangle < get_n_triangles(); ++triangle )
+        {
+            const auto& a = m_positions[ m_indices[ triangle * 3     ] ];
+            const auto& b = m_positions[ m_indices[ triangle * 3 + 1 ] ];
+            const auto& c = m_positions[ m_indices[ triangle * 3 + 2 ] ];
+            const auto normal = glm::cross( b - a, c - a );
+            const auto length = glm::length( normal );
+            if ( length <= 0.f ) { continue; }
+
+            const auto unit_normal = normal * ( 1.f / length );
+            auto quadric = Quadric { };
+            quadric.add_plane( unit_normal, -glm::dot( unit_normal, a ) );
+            for ( std::size_t corner = 0; corner < 3; ++corner ) { m_quadrics[ get_position_id( m_indices[ triangle * 3 + corner ] ) ].add( quadric ); }
+        }
+    }
+
+    //----------------------------------------------------------------
+    void simplify( const std::size_t target_n_triangles )
+    {
+        while ( get_n_triangles() > target_n_triangles && collapse_edges( target_n_triangles ) ) { }
+    }
+
+    inline const std::vector<uint32_t>& get_indices() const { return m_indices; }
+    inline std::size_t get_n_triangles() const { return m_indices.size() / 3; }
+    // the largest error of any collapse so far, as a distance
+    inline float get_error() const { return static_cast<float>( std::sqrt( m_max_cost ) ); }
+
+private:
+    //----------------------------------------------------------------
+    inline uint32_t get_position_id( const uint32_t vertex ) const { return m_position_ids[ vertex ]; }
+
+    //----------------------------------------------------------------
+    bool is_degenerate( const uint32_t a, const uint32_t b, const uint32_t c ) const
+    {
+        const auto id_a = get_position_id( a );
+        const auto id_b = get_position_id( b );
+        const auto id_c = get_position_id( c );
+        return id_a == id_b || id_b == id_c || id_c == id_a;
+    }
+
+    //----------------------------------------------------------------
+    // Positions shared by vertices with different normals or texture coordinates
+    void lock_seams()
+    {
+        auto first_vertices = std::vector<uint32_t>( m_positions.size(), std::numeric_limits<uint32_t>::max() );
+        for ( const auto vertex : m_indices )
+        {
+            auto& first_vertex = first_vertices[ get_position_id( vertex ) ];
+            if      ( first_vertex == std::numeric_limits<uint32_t>::max() )    { first_vertex = vertex; }
+            else if ( first_vertex != vertex )                                  { m_is_locked[ get_position_id( vertex ) ] = true; }
+        }
+    }
+
+    //----------------------------------------------------------------
+    // Positions on edges that don't have exactly two triangles, which are open or non manifold
+    void lock_borders()
+    {
+        auto edges = std::vector<std::pair<uint32_t, uint32_t>> { };
+        edges.reserve( m_indices.size() );
+        for ( std::size_t triangle = 0; triangle < get_n_triangles(); ++triangle )
+        {
+            for ( std::size_t corner = 0; corner < 3; ++corner )
+            {
+                const auto a = get_position_id( m_indices[ triangle * 3 + corner ] );
+                const auto b = get_position_id( m_indices[ triangle * 3 + ( corner + 1 ) % 3 ] );
+                edges.emplace_back( std::min( a, b ), std::max( a, b ) );
+            }
+        }
+        std::sort( edges.begin(), edges.end() );
+
+        for ( std::size_t edge_index = 0; edge_index < edges.size(); )
+        {
+            auto next_edge_index = edge_index + 1;
+            while ( next_edge_index < edges.size() && edges[ next_edge_index ] == edges[ edge_index ] ) { ++next_edge_index; }
+            if ( next_edge_index - edge_index != 2 )
+            {
+                m_is_locked[ edges[ edge_index ].first  ] = true;
+                m_is_locked[ edges[ edge_index ].second ] = true;
+            }
+            edge_index = next_edge_index;
+        }
+    }
+
+    //----------------------------------------------------------------
+    // The triangles around every position, stored contiguously
+    void build_adjacency()
+    {
+        m_triangle_offsets.assign( m_positions.size() + 1, 0 );
+        for ( const auto vertex : m_indices ) { ++m_triangle_offsets[ get_position_id( vertex ) + 1 ]; }
+        std::partial_sum( m_triangle_offsets.begin(), m_triangle_offsets.end(), m_triangle_offsets.begin() );
+
+        m_position_triangles.resize( m_indices.size() );
+        auto fill_offsets = m_triangle_offsets;
+        for ( std::size_t index_index = 0; index_index < m_indices.size(); ++index_index )
+        {
+            m_position_triangles[ fill_offsets[ get_position_id( m_indices[ index_index ] ) ]++ ] = static_cast<uint32_t>( index_index / 3 );
+        }
+    }
+
+    //----------------------------------------------------------------
+    // The other positions of the triangles around a position, that are still triangles after the collapses so far
+    void find_neighbors( const uint32_t position_id, std::vector<uint32_t>& neighbors ) const
+    {
+        neighbors.clear();
+        for ( auto offset = m_triangle_offsets[ position_id ]; offset < m_triangle_offsets[ position_id + 1 ]; ++offset )
+        {
+            const auto triangle = m_position_triangles[ offset ];
+            const auto a = m_remap[ m_indices[ triangle * 3     ] ];
+            const auto b = m_remap[ m_indices[ triangle * 3 + 1 ] ];
+            const auto c = m_remap[ m_indices[ triangle * 3 + 2 ] ];
+            if ( is_degenerate( a, b, c ) ) { continue; }
+
+            for ( const auto vertex : { a, b, c } )
+            {
+                if ( get_position_id( vertex ) != position_id ) { neighbors.emplace_back( get_position_id( vertex ) ); }
+            }
+        }
+        std::sort( neighbors.begin(), neighbors.end() );
+        neighbors.erase( std::unique( neighbors.begin(), neighbors.end() ), neighbors.end() );
+    }
+
+    //----------------------------------------------------------------
+    // A collapse is valid if it doesn't flip any triangle,
+    // and if the positions only share the neighbors of the triangles that are removed, so the surface stays manifold.
+    // Returns the number of triangles the collapse removes, or 0 if it is not valid.
+    std::size_t check_collapse( const Collapse& collapse )
+    {
+        const auto from_id  = get_position_id( collapse.from );
+        const auto to_id    = get_position_id( collapse.to );
+        const auto& to_position = m_positions[ collapse.to ];
+
+        std::size_t n_removed_triangles { 0 };
+        for ( auto offset = m_triangle_offsets[ from_id ]; offset < m_triangle_offsets[ from_id + 1 ]; ++offset )
+        {
+            const auto triangle = m_position_triangles[ offset ];
+            auto corners = std::array<uint32_t, 3>
+            {
+                m_remap[ m_indices[ triangle * 3     ] ],
+                m_remap[ m_indices[ triangle * 3 + 1 ] ],
+                m_remap[ m_indices[ triangle * 3 + 2 ] ]
+            };
+            if ( is_degenerate( corners[ 0 ], corners[ 1 ], corners[ 2 ] ) ) { continue; }
+
+            auto positions      = std::array<glm::vec3, 3> { };
+            auto new_positions  = std::array<glm::vec3, 3> { };
+            auto has_to         = false;
+            for ( std::size_t corner = 0; corner < 3; ++corner )
+            {
+                const auto corner_id = get_position_id( corners[ corner ] );
+                has_to                  = has_to || corner_id == to_id;
+                positions[ corner ]     = m_positions[ corners[ corner ] ];
+                new_positions[ corner ] = corner_id == from_id ? to_position : positions[ corner ];
+            }
+            if ( has_to )
+            {
+                ++n_removed_triangles;
+                continue;
+            }
+
+            const auto normal       = glm::cross( positions[ 1 ] - positions[ 0 ], positions[ 2 ] - positions[ 0 ] );
+            const auto new_normal   = glm::cross( new_positions[ 1 ] - new_positions[ 0 ], new_positions[ 2 ] - new_positions[ 0 ] );
+            if ( glm::dot( normal, new_normal ) <= min_normal_cos * glm::length( normal ) * glm::length( new_normal ) ) { return 0; }
+        }
+        if ( n_removed_triangles == 0 ) { return 0; }
+
+        find_neighbors( from_id,    m_from_neighbors    );
+        find_neighbors( to_id,      m_to_neighbors      );
+        m_shared_neighbors.clear();
+        std::set_intersection
+        (
+            m_from_neighbors.begin(),   m_from_neighbors.end(),
+            m_to_neighbors.begin(),     m_to_neighbors.end(),
+            std::back_inserter( m_shared_neighbors )
+        );
+        return m_shared_neighbors.size() == n_removed_triangles ? n_removed_triangles : 0;
+    }
+
+    //----------------------------------------------------------------
+    // Collapses the cheapest edges first, collapsing each position at most once,
+    // as the costs of collapses around it are out of date afterwards.
+    // Returns false if no edge could be collapsed.
+    bool collapse_edges( const std::size_t target_n_triangles )
+    {
+        build_adjacency();
+
+        auto collapses = std::vector<Collapse> { };
+        collapses.reserve( m_indices.size() * 2 );
+        for ( std::size_t triangle = 0; triangle < get_n_triangles(); ++triangle )
+        {
+            for ( std::size_t corner = 0; corner < 3; ++corner )
+            {
+                const auto a = m_indices[ triangle * 3 + corner ];
+                const auto b = m_indices[ triangle * 3 + ( corner + 1 ) % 3 ];
+                for ( const auto& [ from, to ] : { std::make_pair( a, b ), std::make_pair( b, a ) } )
+                {
+                    if ( m_is_locked[ get_position_id( from ) ] ) { continue; }
+
+                    auto quadric = m_quadrics[ get_position_id( from ) ];
+                    quadric.add( m_quadrics[ get_position_id( to ) ] );
+                    collapses.emplace_back( Collapse { from, to, quadric.evaluate( m_positions[ to ] ) } );
+                }
+            }
+        }
+        std::sort( collapses.begin(), collapses.end(), []( const Collapse& a, const Collapse& b ) { return a.cost < b.cost; } );
+
+        m_remap.resize( m_positions.size() );
+        std::iota( m_remap.begin(), m_remap.end(), 0u );
+        auto is_collapsed = std::vector<bool>( m_positions.size(), false );
+
+        auto n_triangles = get_n_triangles();
+        std::size_t n_collapses { 0 };
+        for ( const auto& collapse : collapses )
+        {
+            if ( n_triangles <= target_n_triangles ) { break; }
+
+            const auto from_id  = get_position_id( collapse.from );
+            const auto to_id    = get_position_id( collapse.to );
+            if ( is_collapsed[ from_id ] || is_collapsed[ to_id ] ) { continue; }
+
+            const auto n_removed_triangles = check_collapse( collapse );
+            if ( n_removed_triangles == 0 ) { continue; }
+
+            // unlocked positions have a single vertex, the one that is collapsed
+            m_remap[ collapse.from ]    = collapse.to;
+            is_collapsed[ from_id ]     = true;
+            is_collapsed[ to_id ]       = true;
+            m_quadrics[ to_id ].add( m_quadrics[ from_id ] );
+            m_max_cost = std::max( m_max_cost, collapse.cost );
+            n_triangles -= n_removed_triangles;
+            ++n_collapses;
+        }
+
+        auto indices = std::vector<uint32_t> { };
+        indices.reserve( n_triangles * 3 );
+        for ( std::size_t triangle = 0; triangle < get_n_triangles(); ++triangle )
+        {
+            const auto a = m_remap[ m_indices[ triangle * 3     ] ];
+            const auto b = m_remap[ m_indices[ triangle * 3 + 1 ] ];
+            const auto c = m_remap[ m_indices[ triangle * 3 + 2 ] ];
+            if ( !is_degenerate( a, b, c ) ) { indices.insert( indices.end(), { a, b, c } ); }
+        }
+        m_indices = std::move( indices );
+
+        return n_collapses != 0;
+    }
+
+    const std::vector<glm::vec3>&   m_positions;
+    std::vector<uint32_t>           m_position_ids;
+    std::vector<bool>               m_is_locked;
+    std::vector<Quadric>            m_quadrics;
+    std::vector<uint32_t>           m_indices               { };
+    double                          m_max_cost              { 0. };
+
+    // for the collapses of a single pass
+    std::vector<uint32_t>           m_triangle_offsets      { };
+    std::vector<uint32_t>           m_position_triangles    { };
+    std::vector<uint32_t>           m_remap                 { };
+    std::vector<uint32_t>           m_from_neighbors        { };
+    std::vector<uint32_t>           m_to_neighbors          { };
+    std::vector<uint32_t>           m_shared_neighbors      { };
+};
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+float simplify_mesh
+(
+    const std::vector<glm::vec3>&   positions,
+    std::vector<uint32_t>&          indices,
+    const std::size_t               target_n_triangles
+)
+{
+    auto simplifier = Simplifier { positions, indices };
+    simplifier.simplify( target_n_triangles );
+    indices = simplifier.get_indices();
+    return simplifier.get_error();
+}
+
+//----------------------------------------------------------------
+void generate_mesh_lods
+(
+    Mesh&               mesh,
+    const std::size_t   max_n_lods,
+    const float         reduction,
+    const std::size_t   min_n_triangles
+)
+{
+    CHECK( !mesh.has_lods(), "Mesh already has levels of detail." );
+    CHECK( reduction > 0.f && reduction < 1.f, "Each level of detail should have fewer triangles than the previous one." );
+
+    mesh.lods.emplace_back( MeshLod { 0, mesh.indices.size(), mesh.get_n_vertices(), 0.f } );
+
+    auto extent = 0.f;
+    if ( !mesh.positions.empty() )
+    {
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            const auto bounds = std::minmax_element( mesh.positions.begin(), mesh.positions.end(), [ axis ]( const glm::vec3& lhs, const glm::vec3& rhs ) { return lhs[ axis ] < rhs[ axis ]; } );
+            extent = std::max( extent, ( *bounds.second )[ axis ] - ( *bounds.first )[ axis ] );
+        }
+    }
+
+    // a single simplifier keeps the quadrics of the full detail mesh
+    auto simplifier = Simplifier { mesh.positions, mesh.indices };
+    auto lod_indices = std::vector<std::vector<uint32_t>> { };
+    auto n_triangles = mesh.get_n_triangles();
+    while ( mesh.lods.size() < max_n_lods && n_triangles >= min_n_triangles )
+    {
+        const auto target_n_triangles = static_cast<std::size_t>( n_triangles * reduction );
+        simplifier.simplify( target_n_triangles );
+
+        // stop once less than half of the triangles that should be removed can be
+        if ( simplifier.get_n_triangles() > ( n_triangles + target_n_triangles ) / 2 ) { break; }
+        if ( simplifier.get_error() > max_relative_lod_error * extent ) { break; }
+
+        n_triangles = simplifier.get_n_triangles();
+        lod_indices.emplace_back( simplifier.get_indices() );
+        mesh.lods.emplace_back( MeshLod { 0, lod_indices.back().size(), mesh.get_n_vertices(), simplifier.get_error() } );
+    }
+
+    for ( std::size_t lod_index = 1; lod_index < mesh.lods.size(); ++lod_index )
+    {
+        mesh.lods[ lod_index ].first_index = mesh.indices.size();
+        mesh.indices.insert( mesh.indices.end(), lod_indices[ lod_index - 1 ].begin(), lod_indices[ lod_index - 1 ].end() );
+    }
+}
+
+} // namespace content
+} // namespace shake
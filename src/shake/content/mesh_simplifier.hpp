@@ -0,0 +1,44 @@
+#ifndef MESH_SIMPLIFIER_HPP
+#define MESH_SIMPLIFIER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "shake/content/mesh.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Removes triangles by collapsing edges onto one of their vertices, cheapest first,
+// using the quadric error of the planes of the original triangles around each vertex (Garland and Heckbert).
+// Vertices are never moved or added, so the simplified indices refer to the same vertices.
+// Vertices on open borders, and those split by seams in their normals or texture coordinates, are kept,
+// so the simplified mesh has no cracks, at the cost of simplifying less around them.
+// Simplifies the indices to at most target_n_triangles, if possible,
+// and returns their error, in the units of the positions.
+float simplify_mesh
+(
+    const std::vector<glm::vec3>&   positions,
+    std::vector<uint32_t>&          indices,
+    const std::size_t               target_n_triangles
+);
+
+//----------------------------------------------------------------
+// Adds levels of detail to the mesh, each with about reduction times the triangles of the previous one,
+// until a level has fewer than min_n_triangles, or the mesh can't be simplified any further without losing its shape.
+// The levels are simplified from each other, so coarser levels use a subset of the vertices of finer levels,
+// and their errors are measured against the full detail mesh.
+// Call optimize_mesh() afterwards, to order the vertices used by coarser levels first.
+void generate_mesh_lods
+(
+    Mesh&               mesh,
+    const std::size_t   max_n_lods      = 8,
+    const float         reduction       = 0.5f,
+    const std::size_t   min_n_triangles = 64
+);
+
+} // namespace content
+} // namespace shake
+
+#endif // MESH_SIMPLIFIER_HPP
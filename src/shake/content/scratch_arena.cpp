@@ -0,0 +1,136 @@
+#include "scratch_arena.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+thread_local std::size_t scope_depth { 0 };
+
+std::mutex          statistics_mutex    { };
+ScratchStatistics   statistics          { };
+
+//----------------------------------------------------------------
+ScratchArena& get_thread_arena()
+{
+    thread_local ScratchArena arena { };
+    return arena;
+}
+
+//----------------------------------------------------------------
+void record_scope( const ScratchCounts& counts )
+{
+    const auto lock = std::lock_guard<std::mutex> { statistics_mutex };
+    ++statistics.n_scopes;
+    if ( counts.n_overflow_allocations != 0 ) { ++statistics.n_overflowing_scopes; }
+    statistics.n_allocations            += counts.n_allocations;
+    statistics.n_bytes                  += counts.n_bytes;
+    statistics.n_overflow_allocations   += counts.n_overflow_allocations;
+    statistics.n_overflow_bytes         += counts.n_overflow_bytes;
+    statistics.max_n_bytes_per_scope    = std::max( statistics.max_n_bytes_per_scope, counts.n_bytes );
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+ScratchArena::ScratchArena( const std::size_t n_initial_bytes, const std::size_t max_n_retained_bytes )
+    : m_max_n_retained_bytes    { max_n_retained_bytes }
+    , m_n_buffer_bytes          { n_initial_bytes }
+    , m_buffer                  { new std::byte[ n_initial_bytes ] }
+{
+    m_resource.emplace( m_buffer.get(), m_n_buffer_bytes, &m_heap );
+}
+
+//----------------------------------------------------------------
+void ScratchArena::reset()
+{
+    // frees what was allocated from the heap
+    m_resource.reset();
+
+    // grow the buffer to fit everything that was allocated, with some room for alignment
+    if ( m_counts.n_overflow_allocations != 0 && m_n_buffer_bytes < m_max_n_retained_bytes )
+    {
+        const auto n_used_bytes = m_counts.n_bytes + m_counts.n_allocations * alignof( std::max_align_t );
+        m_n_buffer_bytes = std::min( std::max( m_n_buffer_bytes * 2, n_used_bytes ), m_max_n_retained_bytes );
+        m_buffer.reset( new std::byte[ m_n_buffer_bytes ] );
+    }
+
+    m_counts = ScratchCounts { };
+    m_resource.emplace( m_buffer.get(), m_n_buffer_bytes, &m_heap );
+}
+
+//----------------------------------------------------------------
+void* ScratchArena::do_allocate( const std::size_t n_bytes, const std::size_t alignment )
+{
+    ++m_counts.n_allocations;
+    m_counts.n_bytes += n_bytes;
+    return m_resource->allocate( n_bytes, alignment );
+}
+
+//----------------------------------------------------------------
+void* ScratchArena::HeapResource::do_allocate( const std::size_t n_bytes, const std::size_t alignment )
+{
+    ++m_counts.n_overflow_allocations;
+    m_counts.n_overflow_bytes += n_bytes;
+    return std::pmr::new_delete_resource()->allocate( n_bytes, alignment );
+}
+
+//----------------------------------------------------------------
+void ScratchArena::HeapResource::do_deallocate( void* pointer, const std::size_t n_bytes, const std::size_t alignment )
+{
+    std::pmr::new_delete_resource()->deallocate( pointer, n_bytes, alignment );
+}
+
+//----------------------------------------------------------------
+ScratchStatistics get_scratch_statistics()
+{
+    const auto lock = std::lock_guard<std::mutex> { statistics_mutex };
+    return statistics;
+}
+
+//----------------------------------------------------------------
+void reset_scratch_statistics()
+{
+    const auto lock = std::lock_guard<std::mutex> { statistics_mutex };
+    statistics = ScratchStatistics { };
+}
+
+//----------------------------------------------------------------
+ScratchScope::ScratchScope()
+{
+    ++scope_depth;
+}
+
+//----------------------------------------------------------------
+ScratchScope::~ScratchScope()
+{
+    if ( --scope_depth != 0 ) { return; }
+
+    auto& arena = get_thread_arena();
+    record_scope( arena.get_counts() );
+    arena.reset();
+}
+
+//----------------------------------------------------------------
+bool ScratchScope::is_active()
+{
+    return scope_depth != 0;
+}
+
+//----------------------------------------------------------------
+ScratchCounts ScratchScope::get_counts()
+{
+    return is_active() ? get_thread_arena().get_counts() : ScratchCounts { };
+}
+
+//----------------------------------------------------------------
+std::pmr::memory_resource* get_scratch_resource()
+{
+    return ScratchScope::is_active() ? &get_thread_arena() : std::pmr::get_default_resource();
+}
+
+} // namespace content
+} // namespace shake
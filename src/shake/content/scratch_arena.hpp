@@ -0,0 +1,128 @@
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Allocations made from the arena since it was last reset.
+// Only allocations through the arena are counted, not those a load makes from the heap directly.
+struct ScratchCounts
+{
+    std::size_t n_allocations           { };
+    std::size_t n_bytes                 { };
+    // allocations the arena passed on to the heap, because its buffer was full
+    std::size_t n_overflow_allocations  { };
+    std::size_t n_overflow_bytes        { };
+};
+
+//----------------------------------------------------------------
+// A monotonic arena for data that only lives while content is loaded,
+// such as the bytes of a file that is decoded into something else.
+// Deallocation does nothing, all memory is freed at once by reset().
+// The arena keeps its buffer between resets, and grows it to fit the largest use so far,
+// so loads that are no larger than earlier ones fit into it without allocating from the heap.
+// Nothing is freed before the reset, so allocate once per load, not once per item in a loop.
+// Loaders only read files into it, through ContentManager::read_scratch_content(),
+// what they decode those files into is allocated from the heap as usual.
+class ScratchArena final : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t default_n_initial_bytes        = 64 * 1024;
+    // a single huge load should not keep its memory for good
+    static constexpr std::size_t default_max_n_retained_bytes   = 32 * 1024 * 1024;
+
+    explicit ScratchArena
+    (
+        const std::size_t n_initial_bytes       = default_n_initial_bytes,
+        const std::size_t max_n_retained_bytes  = default_max_n_retained_bytes
+    );
+    NON_COPYABLE( ScratchArena )
+
+    void reset();
+
+    inline const ScratchCounts& get_counts()            const { return m_counts; }
+    inline std::size_t          get_n_buffer_bytes()    const { return m_n_buffer_bytes; }
+
+private:
+    void*   do_allocate     ( std::size_t n_bytes, std::size_t alignment ) override;
+    void    do_deallocate   ( void*, std::size_t, std::size_t ) override { }
+    bool    do_is_equal     ( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+
+    //----------------------------------------------------------------
+    // Counts what the arena allocates from the heap once its buffer is full
+    class HeapResource final : public std::pmr::memory_resource
+    {
+    public:
+        explicit HeapResource( ScratchCounts& counts ) : m_counts { counts } { }
+
+    private:
+        void*   do_allocate     ( std::size_t n_bytes, std::size_t alignment ) override;
+        void    do_deallocate   ( void* pointer, std::size_t n_bytes, std::size_t alignment ) override;
+        bool    do_is_equal     ( const std::pmr::memory_resource& other ) const noexcept override { return this == &other; }
+
+    private:
+        ScratchCounts& m_counts;
+    };
+
+private:
+    std::size_t                                             m_max_n_retained_bytes;
+    std::size_t                                             m_n_buffer_bytes;
+    std::unique_ptr<std::byte[]>                            m_buffer;
+    ScratchCounts                                           m_counts    { };
+    HeapResource                                            m_heap      { m_counts };
+    std::optional<std::pmr::monotonic_buffer_resource>      m_resource  { };
+};
+
+//----------------------------------------------------------------
+// Over all outermost scratch scopes that ended so far
+struct ScratchStatistics
+{
+    // loads, and parts of loads that were decoded on other threads
+    std::size_t n_scopes                { };
+    // scopes that allocated more than the buffer of their arena held
+    std::size_t n_overflowing_scopes    { };
+    std::size_t n_allocations           { };
+    std::size_t n_bytes                 { };
+    std::size_t n_overflow_allocations  { };
+    std::size_t n_overflow_bytes        { };
+    std::size_t max_n_bytes_per_scope   { };
+};
+
+ScratchStatistics   get_scratch_statistics();
+void                reset_scratch_statistics();
+
+//----------------------------------------------------------------
+// Every thread has its own scratch arena, that loaders use through get_scratch_resource().
+// The content manager opens a scope around every load, and around the parts of loads decoded on the worker pool.
+// Scopes nest, and only the outermost scope resets the arena,
+// so scratch memory of a load stays valid while the content it depends on is loaded.
+class ScratchScope
+{
+public:
+    ScratchScope();
+    ~ScratchScope();
+    NON_COPYABLE( ScratchScope )
+
+    static bool is_active();
+
+    //----------------------------------------------------------------
+    // Of the arena of the calling thread, since its outermost scope began
+    static ScratchCounts get_counts();
+};
+
+//----------------------------------------------------------------
+// The arena of the calling thread within a scratch scope, and the default resource outside of one
+std::pmr::memory_resource* get_scratch_resource();
+
+} // namespace content
+} // namespace shake
+
+#endif // SCRATCH_ARENA_HPP
@@ -0,0 +1,165 @@
+#include "shader_preprocessor.hpp"
+
+#include <set>
+
+#include "shake/core/contracts/contracts.hpp"
+
+#include "shake/content/content_id.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+//----------------------------------------------------------------
+std::string_view trim_leading_whitespace( std::string_view line )
+{
+    const auto begin = line.find_first_not_of( " \t" );
+    return begin == std::string_view::npos ? std::string_view { } : line.substr( begin );
+}
+
+//----------------------------------------------------------------
+// Returns whether the line is the given preprocessor directive, allowing whitespace after the #
+bool is_directive( std::string_view line, const std::string_view directive )
+{
+    line = trim_leading_whitespace( line );
+    if ( line.empty() || line.front() != '#' ) { return false; }
+    line = trim_leading_whitespace( line.substr( 1 ) );
+    return line.substr( 0, directive.size() ) == directive
+        && ( line.size() == directive.size() || line[ directive.size() ] == ' ' || line[ directive.size() ] == '\t' || line[ directive.size() ] == '"' || line[ directive.size() ] == '<' );
+}
+
+//----------------------------------------------------------------
+// The path of an #include "path" or #include <path> directive
+io::Path parse_include_path( const std::string_view line )
+{
+    const auto begin = line.find_first_of( "\"<" );
+    CHECK( begin != std::string_view::npos, "Malformed shader include: " + std::string { line } );
+    const auto end = line.find( line[ begin ] == '"' ? '"' : '>', begin + 1 );
+    CHECK( end != std::string_view::npos, "Malformed shader include: " + std::string { line } );
+    return io::Path { std::string { line.substr( begin + 1, end - begin - 1 ) } };
+}
+
+//----------------------------------------------------------------
+class ShaderPreprocessor
+{
+public:
+    ShaderPreprocessor( const ShaderDefines& defines, const ReadShaderInclude& read_include )
+        : m_defines         { defines }
+        , m_read_include    { read_include }
+    { }
+
+    PreprocessedShader run( const std::string_view source )
+    {
+        // without a #version directive, the defines go first
+        if ( !has_version_directive( source ) )
+        {
+            append_defines();
+            append_line_directive( 1, 0 );
+        }
+        append_file( source, 0 );
+
+        m_result.hash = hash_string( m_result.source.data(), m_result.source.size() );
+        return std::move( m_result );
+    }
+
+private:
+    static bool has_version_directive( const std::string_view source )
+    {
+        bool has_version { false };
+        for_each_line( source, [ &has_version ]( const std::string_view line, std::size_t ) { has_version |= is_directive( line, "version" ); } );
+        return has_version;
+    }
+
+    template<typename Function_T>
+    static void for_each_line( const std::string_view source, Function_T&& function )
+    {
+        std::size_t line_number { 1 };
+        for ( std::size_t begin = 0; begin < source.size(); ++line_number )
+        {
+            auto end = source.find( '\n', begin );
+            if ( end == std::string_view::npos ) { end = source.size(); }
+
+            auto line = source.substr( begin, end - begin );
+            if ( !line.empty() && line.back() == '\r' ) { line.remove_suffix( 1 ); }
+            function( line, line_number );
+            begin = end + 1;
+        }
+    }
+
+    void append_file( const std::string_view source, const std::size_t file_index )
+    {
+        for_each_line( source, [ & ]( const std::string_view line, const std::size_t line_number )
+        {
+            if ( file_index == 0 && is_directive( line, "version" ) )
+            {
+                append_line( line );
+                append_defines();
+                append_line_directive( line_number + 1, file_index );
+            }
+            else if ( is_directive( line, "include" ) )
+            {
+                const auto include_path = parse_include_path( line );
+                // files that were included before are left out, as if they had include guards
+                if ( m_included_paths.insert( include_path.get_string() ).second )
+                {
+                    m_result.included_paths.emplace_back( include_path );
+                    const auto include_source = m_read_include( include_path );
+                    append_line_directive( 1, m_result.included_paths.size() );
+                    append_file( include_source, m_result.included_paths.size() );
+                    append_line_directive( line_number + 1, file_index );
+                }
+                else
+                {
+                    // keeps the line numbers as they are
+                    append_line( { } );
+                }
+            }
+            else
+            {
+                append_line( line );
+            }
+        } );
+    }
+
+    void append_defines()
+    {
+        for ( const auto& [ name, value ] : m_defines )
+        {
+            append_line( value.empty() ? "#define " + name : "#define " + name + " " + value );
+        }
+    }
+
+    void append_line_directive( const std::size_t line_number, const std::size_t file_index )
+    {
+        append_line( "#line " + std::to_string( line_number ) + " " + std::to_string( file_index ) );
+    }
+
+    void append_line( const std::string_view line )
+    {
+        m_result.source.append( line );
+        m_result.source.push_back( '\n' );
+    }
+
+private:
+    const ShaderDefines&        m_defines;
+    const ReadShaderInclude&    m_read_include;
+    PreprocessedShader          m_result            { };
+    std::set<std::string>       m_included_paths    { };
+};
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+PreprocessedShader preprocess_shader
+(
+    const std::string_view      source,
+    const ShaderDefines&        defines,
+    const ReadShaderInclude&    read_include
+)
+{
+    return ShaderPreprocessor { defines, read_include }.run( source );
+}
+
+} // namespace content
+} // namespace shake
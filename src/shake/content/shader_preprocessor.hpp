@@ -0,0 +1,51 @@
+#ifndef SHADER_PREPROCESSOR_HPP
+#define SHADER_PREPROCESSOR_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Names and values of the macros to define in a shader variant
+using ShaderDefines = std::map<std::string, std::string>;
+
+//----------------------------------------------------------------
+struct PreprocessedShader
+{
+    std::string             source          { };
+    // identifies the variant, equal sources have equal hashes
+    uint64_t                hash            { };
+    // every file that was included, directly or indirectly, in order of inclusion.
+    // #line directives refer to a file by its index in this list plus one, the main source is 0.
+    std::vector<io::Path>   included_paths  { };
+};
+
+//----------------------------------------------------------------
+// Returns the source of the file with the given content path
+using ReadShaderInclude = std::function<std::string( const io::Path& )>;
+
+//----------------------------------------------------------------
+// Resolves #include "path" directives, where paths are content paths,
+// and defines the macros right after the #version directive, which has to stay first.
+// Every file is included only once, so files can include each other freely.
+// #line directives keep the line numbers in compile errors pointing into the original files.
+// Does not need a graphics context.
+PreprocessedShader preprocess_shader
+(
+    const std::string_view      source,
+    const ShaderDefines&        defines,
+    const ReadShaderInclude&    read_include
+);
+
+} // namespace content
+} // namespace shake
+
+#endif // SHADER_PREPROCESSOR_HPP
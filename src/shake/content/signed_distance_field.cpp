@@ -0,0 +1,155 @@
+#include "signed_distance_field.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+// Larger than any squared distance in an image, but small enough to add to
+constexpr float infinity = 1e20f;
+
+//----------------------------------------------------------------
+// The squared euclidean distance transform of a single row or column,
+// using the lower envelope of parabolas by Felzenszwalb and Huttenlocher.
+// Runs in linear time, and only touches contiguous buffers,
+// which lets the compiler vectorize the loops over rows.
+void transform_1d
+(
+    const float*    f,
+    float*          d,
+    int*            v,
+    float*          z,
+    const int       n
+)
+{
+    int k { 0 };
+    v[ 0 ] = 0;
+    z[ 0 ] = -infinity;
+    z[ 1 ] = +infinity;
+
+    for ( int q = 1; q < n; ++q )
+    {
+        auto s = ( ( f[ q ] + q * q ) - ( f[ v[ k ] ] + v[ k ] * v[ k ] ) ) / ( 2.f * ( q - v[ k ] ) );
+        while ( s <= z[ k ] )
+        {
+            --k;
+            s = ( ( f[ q ] + q * q ) - ( f[ v[ k ] ] + v[ k ] * v[ k ] ) ) / ( 2.f * ( q - v[ k ] ) );
+        }
+        ++k;
+        v[ k ] = q;
+        z[ k ] = s;
+        z[ k + 1 ] = +infinity;
+    }
+
+    k = 0;
+    for ( int q = 0; q < n; ++q )
+    {
+        while ( z[ k + 1 ] < q ) { ++k; }
+        const auto offset = static_cast<float>( q - v[ k ] );
+        d[ q ] = offset * offset + f[ v[ k ] ];
+    }
+}
+
+//----------------------------------------------------------------
+// Transforms, in place, a grid where sources are 0 and everything else is infinity,
+// into the squared distance of every cell to its nearest source
+void transform_2d( std::vector<float>& grid, const int width, const int height )
+{
+    const auto n = std::max( width, height );
+    auto f = std::vector<float> ( n );
+    auto d = std::vector<float> ( n );
+    auto v = std::vector<int>   ( n );
+    auto z = std::vector<float> ( n + 1 );
+
+    // columns, gathered into a contiguous buffer
+    for ( int x = 0; x < width; ++x )
+    {
+        for ( int y = 0; y < height; ++y ) { f[ y ] = grid[ static_cast<std::size_t>( y ) * width + x ]; }
+        transform_1d( f.data(), d.data(), v.data(), z.data(), height );
+        for ( int y = 0; y < height; ++y ) { grid[ static_cast<std::size_t>( y ) * width + x ] = d[ y ]; }
+    }
+
+    // rows, which are contiguous already
+    for ( int y = 0; y < height; ++y )
+    {
+        auto* row = grid.data() + static_cast<std::size_t>( y ) * width;
+        std::copy( row, row + width, f.begin() );
+        transform_1d( f.data(), row, v.data(), z.data(), width );
+    }
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+load::Image make_signed_distance_field( const load::Image& coverage, const int spread, const int downscale )
+{
+    CHECK_EQ( coverage.n_channels, 1, "Signed distance fields are made from single channel images." );
+    CHECK_GT( spread, 0, "Spread should be positive." );
+    CHECK_GT( downscale, 0, "Downscale should be positive." );
+
+    // pad, and round up to a whole number of output pixels
+    const auto padding  = spread * downscale;
+    const auto width    = ( ( coverage.width  + 2 * padding + downscale - 1 ) / downscale ) * downscale;
+    const auto height   = ( ( coverage.height + 2 * padding + downscale - 1 ) / downscale ) * downscale;
+    const auto n_pixels = static_cast<std::size_t>( width ) * height;
+
+    // pixels that are at least half covered are inside
+    auto distance_outside   = std::vector<float>( n_pixels, infinity );
+    auto distance_inside    = std::vector<float>( n_pixels, 0.f );
+    for ( int y = 0; y < coverage.height; ++y )
+    {
+        for ( int x = 0; x < coverage.width; ++x )
+        {
+            const auto is_inside = coverage.pixels.get()[ static_cast<std::size_t>( y ) * coverage.width + x ] >= 128;
+            const auto pixel_index = static_cast<std::size_t>( y + padding ) * width + x + padding;
+            distance_outside[ pixel_index ] = is_inside ? 0.f      : infinity;
+            distance_inside [ pixel_index ] = is_inside ? infinity : 0.f;
+        }
+    }
+
+    transform_2d( distance_outside, width, height );
+    transform_2d( distance_inside,  width, height );
+
+    // both distances are measured between pixel centers, while the edge lies halfway
+    auto signed_distance = std::vector<float>( n_pixels );
+    for ( std::size_t pixel_index = 0; pixel_index < n_pixels; ++pixel_index )
+    {
+        signed_distance[ pixel_index ] = distance_inside[ pixel_index ] > 0.f
+            ? std::sqrt( distance_inside[ pixel_index ] ) - 0.5f
+            : 0.5f - std::sqrt( distance_outside[ pixel_index ] );
+    }
+
+    // average blocks of the high resolution field, and convert to pixels of the output
+    const auto field_width  = width  / downscale;
+    const auto field_height = height / downscale;
+    const auto scale = 127.f / ( static_cast<float>( spread ) * downscale * downscale * downscale );
+
+    auto pixels = std::vector<uint8_t>( static_cast<std::size_t>( field_width ) * field_height );
+    for ( int field_y = 0; field_y < field_height; ++field_y )
+    {
+        for ( int field_x = 0; field_x < field_width; ++field_x )
+        {
+            float sum { 0.f };
+            for ( int y = field_y * downscale; y < ( field_y + 1 ) * downscale; ++y )
+            {
+                for ( int x = field_x * downscale; x < ( field_x + 1 ) * downscale; ++x )
+                {
+                    sum += signed_distance[ static_cast<std::size_t>( y ) * width + x ];
+                }
+            }
+            const auto value = std::round( 128.f + sum * scale );
+            pixels[ static_cast<std::size_t>( field_y ) * field_width + field_x ] = static_cast<uint8_t>( std::clamp( value, 0.f, 255.f ) );
+        }
+    }
+
+    return load::make_image( std::move( pixels ), field_width, field_height, 1 );
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,24 @@
+#ifndef SIGNED_DISTANCE_FIELD_HPP
+#define SIGNED_DISTANCE_FIELD_HPP
+
+#include "shake/content/load_image.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Converts a single channel coverage image, such as a glyph rasterized at a high resolution,
+// into a signed distance field that is downscale times smaller.
+//
+// The field is padded by spread pixels on every side,
+// and stores the distance to the nearest edge, in pixels of the field,
+// remapped from [ -spread, spread ] to [ 0, 255 ].
+// The edge lies at 128 and the inside is brighter,
+// so rendering thresholds the sampled distance at 0.5 instead of blending coverage.
+// Because the distance varies linearly, it can be magnified without becoming blurry.
+load::Image make_signed_distance_field( const load::Image& coverage, const int spread, const int downscale );
+
+} // namespace content
+} // namespace shake
+
+#endif // SIGNED_DISTANCE_FIELD_HPP
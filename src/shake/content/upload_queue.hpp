@@ -0,0 +1,78 @@
+#ifndef UPLOAD_QUEUE_HPP
+#define UPLOAD_QUEUE_HPP
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// Worker threads push the gpu side of content loading here,
+// and the thread that owns the graphics context drains it.
+class UploadQueue
+{
+public:
+    using Upload = std::function<void()>;
+
+    UploadQueue() = default;
+    NON_COPYABLE( UploadQueue )
+
+    //----------------------------------------------------------------
+    void push( Upload upload )
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_mutex };
+        m_uploads.emplace_back( std::move( upload ) );
+    }
+
+    //----------------------------------------------------------------
+    // Runs at most max_n_uploads uploads on the calling thread,
+    // so a frame can limit how much time it spends on uploading.
+    // Returns the number of uploads that were run.
+    std::size_t process( const std::size_t max_n_uploads = std::numeric_limits<std::size_t>::max() )
+    {
+        std::size_t n_uploads { 0 };
+        while ( n_uploads < max_n_uploads )
+        {
+            auto upload = Upload { };
+            {
+                const auto lock = std::lock_guard<std::mutex> { m_mutex };
+                if ( m_uploads.empty() ) { break; }
+                upload = std::move( m_uploads.front() );
+                m_uploads.pop_front();
+            }
+            // run without holding the lock,
+            // uploads may load nested content that pushes new uploads
+            upload();
+            ++n_uploads;
+        }
+        return n_uploads;
+    }
+
+    //----------------------------------------------------------------
+    std::size_t get_size()
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_mutex };
+        return m_uploads.size();
+    }
+
+    //----------------------------------------------------------------
+    void clear()
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_mutex };
+        m_uploads.clear();
+    }
+
+private:
+    std::deque<Upload>  m_uploads;
+    std::mutex          m_mutex;
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // UPLOAD_QUEUE_HPP
@@ -0,0 +1,247 @@
+#include "voxel_brick_map.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+namespace { // anonymous
+
+//----------------------------------------------------------------
+// Spreads the lower 10 bits of value apart, so there are two zero bits between each of them
+uint32_t spread_bits( uint32_t value )
+{
+    value &= 0x000003ff;
+    value = ( value | ( value << 16 ) ) & 0x030000ff;
+    value = ( value | ( value << 8  ) ) & 0x0300f00f;
+    value = ( value | ( value << 4  ) ) & 0x030c30c3;
+    value = ( value | ( value << 2  ) ) & 0x09249249;
+    return value;
+}
+
+//----------------------------------------------------------------
+// Interleaves the bits of the coordinates, which are at most 10 bits each
+uint32_t get_morton_code( const glm::ivec3& position )
+{
+    return spread_bits( static_cast<uint32_t>( position.x ) )
+        | ( spread_bits( static_cast<uint32_t>( position.y ) ) << 1 )
+        | ( spread_bits( static_cast<uint32_t>( position.z ) ) << 2 );
+}
+
+//----------------------------------------------------------------
+// Steps a ray through a grid of cells, one cell at a time, as by Amanatides and Woo.
+// Used both to step through the bricks of a map, and through the voxels of a brick.
+struct GridTraversal
+{
+    glm::ivec3  cell    { };
+    glm::ivec3  step    { };
+    glm::vec3   t_max   { };
+    glm::vec3   t_delta { };
+    float       t       { };
+    // The axis along which the current cell was entered, -1 if unknown
+    int         axis    { -1 };
+
+    //----------------------------------------------------------------
+    // Starts at the cell that contains the ray at distance t_start,
+    // clamped to [ min_cell, max_cell ] to be robust against rounding errors at cell borders
+    GridTraversal
+    (
+        const glm::vec3&    origin,
+        const glm::vec3&    direction,
+        const float         t_start,
+        const int           axis_start,
+        const int           cell_size,
+        const glm::ivec3&   min_cell,
+        const glm::ivec3&   max_cell
+    )
+        : t     { t_start }
+        , axis  { axis_start }
+    {
+        for ( int i = 0; i < 3; ++i )
+        {
+            const auto position = origin[ i ] + direction[ i ] * t_start;
+            cell[ i ] = std::clamp( static_cast<int>( std::floor( position / cell_size ) ), min_cell[ i ], max_cell[ i ] );
+
+            if ( direction[ i ] == 0.f )
+            {
+                step[ i ]       = 0;
+                t_max[ i ]      = std::numeric_limits<float>::max();
+                t_delta[ i ]    = std::numeric_limits<float>::max();
+                continue;
+            }
+
+            step[ i ] = direction[ i ] > 0.f ? 1 : -1;
+            const auto border = static_cast<float>( ( cell[ i ] + ( step[ i ] > 0 ? 1 : 0 ) ) * cell_size );
+            t_max[ i ]      = ( border - origin[ i ] ) / direction[ i ];
+            t_delta[ i ]    = static_cast<float>( cell_size ) / std::abs( direction[ i ] );
+        }
+    }
+
+    //----------------------------------------------------------------
+    void advance()
+    {
+        axis = t_max.x < t_max.y
+            ? ( t_max.x < t_max.z ? 0 : 2 )
+            : ( t_max.y < t_max.z ? 1 : 2 );
+        t = t_max[ axis ];
+        cell[ axis ]  += step[ axis ];
+        t_max[ axis ] += t_delta[ axis ];
+    }
+
+    //----------------------------------------------------------------
+    bool is_within( const glm::ivec3& min_cell, const glm::ivec3& max_cell ) const
+    {
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( cell[ i ] < min_cell[ i ] || cell[ i ] > max_cell[ i ] ) { return false; }
+        }
+        return true;
+    }
+
+    //----------------------------------------------------------------
+    glm::ivec3 get_normal() const
+    {
+        auto normal = glm::ivec3 { 0 };
+        if ( axis >= 0 ) { normal[ axis ] = -step[ axis ]; }
+        return normal;
+    }
+};
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+VoxelBrickMap::VoxelBrickMap( const VoxelChunk& voxel_chunk )
+    : m_size            { voxel_chunk.size }
+    , m_size_in_bricks  
+    { 
+        ( voxel_chunk.size.x + brick_size - 1 ) / brick_size,
+        ( voxel_chunk.size.y + brick_size - 1 ) / brick_size,
+        ( voxel_chunk.size.z + brick_size - 1 ) / brick_size
+    }
+{
+    m_brick_indices.resize( static_cast<std::size_t>( m_size_in_bricks.x ) * m_size_in_bricks.y * m_size_in_bricks.z, empty_brick );
+
+    // find the bricks that contain voxels
+    auto occupied_bricks = std::vector<std::pair<uint32_t, std::size_t>> { };
+    for ( const auto& voxel : voxel_chunk.voxels )
+    {
+        const auto brick_position = glm::ivec3 { voxel.x / brick_size, voxel.y / brick_size, voxel.z / brick_size };
+        auto& brick_index = m_brick_indices[ get_brick_cell( brick_position ) ];
+        if ( brick_index == empty_brick )
+        {
+            brick_index = 0;
+            occupied_bricks.emplace_back( get_morton_code( brick_position ), get_brick_cell( brick_position ) );
+        }
+    }
+
+    // store them in morton order
+    std::sort( occupied_bricks.begin(), occupied_bricks.end() );
+    for ( std::size_t i = 0; i < occupied_bricks.size(); ++i )
+    {
+        m_brick_indices[ occupied_bricks[ i ].second ] = static_cast<uint32_t>( i );
+    }
+    m_bricks.resize( occupied_bricks.size() );
+
+    for ( const auto& voxel : voxel_chunk.voxels )
+    {
+        const auto brick_position = glm::ivec3 { voxel.x / brick_size, voxel.y / brick_size, voxel.z / brick_size };
+        const auto local_position = glm::ivec3 { voxel.x % brick_size, voxel.y % brick_size, voxel.z % brick_size };
+        auto& brick = m_bricks[ m_brick_indices[ get_brick_cell( brick_position ) ] ];
+        brick.color_indices[ get_morton_code( local_position ) ] = voxel.color_index;
+    }
+}
+
+//----------------------------------------------------------------
+uint8_t VoxelBrickMap::get_color_index( const glm::ivec3& position ) const
+{
+    if 
+    ( 
+        position.x < 0 || position.y < 0 || position.z < 0 
+        || position.x >= m_size.x || position.y >= m_size.y || position.z >= m_size.z 
+    )
+    {
+        return 0;
+    }
+
+    const auto brick = find_brick( glm::ivec3 { position.x / brick_size, position.y / brick_size, position.z / brick_size } );
+    if ( brick == nullptr ) { return 0; }
+    return brick->color_indices[ get_morton_code( glm::ivec3 { position.x % brick_size, position.y % brick_size, position.z % brick_size } ) ];
+}
+
+//----------------------------------------------------------------
+std::optional<VoxelRayHit> VoxelBrickMap::raycast( const glm::vec3& origin, const glm::vec3& direction, const float max_distance ) const
+{
+    if ( m_bricks.empty() ) { return std::nullopt; }
+
+    // clip the ray against the bounds of the map
+    auto t_enter    = 0.f;
+    auto t_exit     = max_distance;
+    auto entry_axis = -1;
+    for ( int i = 0; i < 3; ++i )
+    {
+        if ( direction[ i ] == 0.f )
+        {
+            if ( origin[ i ] < 0.f || origin[ i ] >= static_cast<float>( m_size[ i ] ) ) { return std::nullopt; }
+            continue;
+        }
+
+        auto t_near = ( 0.f - origin[ i ] ) / direction[ i ];
+        auto t_far  = ( static_cast<float>( m_size[ i ] ) - origin[ i ] ) / direction[ i ];
+        if ( t_near > t_far ) { std::swap( t_near, t_far ); }
+        if ( t_near > t_enter ) 
+        { 
+            t_enter     = t_near; 
+            entry_axis  = i; 
+        }
+        t_exit = std::min( t_exit, t_far );
+    }
+    if ( t_enter > t_exit ) { return std::nullopt; }
+
+    const auto max_brick = m_size_in_bricks - glm::ivec3 { 1 };
+    auto bricks = GridTraversal { origin, direction, t_enter, entry_axis, brick_size, glm::ivec3 { 0 }, max_brick };
+
+    while ( bricks.t <= t_exit && bricks.is_within( glm::ivec3 { 0 }, max_brick ) )
+    {
+        if ( const auto brick = find_brick( bricks.cell ) )
+        {
+            const auto min_voxel = bricks.cell * brick_size;
+            const auto max_voxel = min_voxel + glm::ivec3 { brick_size - 1 };
+            auto voxels = GridTraversal { origin, direction, bricks.t, bricks.axis, 1, min_voxel, max_voxel };
+
+            while ( voxels.t <= t_exit && voxels.is_within( min_voxel, max_voxel ) )
+            {
+                const auto color_index = brick->color_indices[ get_morton_code( voxels.cell - min_voxel ) ];
+                if ( color_index != 0 )
+                {
+                    return VoxelRayHit { voxels.cell, voxels.get_normal(), voxels.t, color_index };
+                }
+                voxels.advance();
+            }
+        }
+        bricks.advance();
+    }
+
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+const VoxelBrickMap::Brick* VoxelBrickMap::find_brick( const glm::ivec3& brick_position ) const
+{
+    const auto brick_index = m_brick_indices[ get_brick_cell( brick_position ) ];
+    return brick_index == empty_brick ? nullptr : &m_bricks[ brick_index ];
+}
+
+//----------------------------------------------------------------
+std::size_t VoxelBrickMap::get_brick_cell( const glm::ivec3& brick_position ) const
+{
+    return static_cast<std::size_t>( brick_position.x ) 
+        + static_cast<std::size_t>( m_size_in_bricks.x ) * ( static_cast<std::size_t>( brick_position.y ) + static_cast<std::size_t>( m_size_in_bricks.y ) * brick_position.z );
+}
+
+} // namespace content
+} // namespace shake
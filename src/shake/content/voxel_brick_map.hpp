@@ -0,0 +1,95 @@
+#ifndef VOXEL_BRICK_MAP_HPP
+#define VOXEL_BRICK_MAP_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "shake/core/math/math.hpp"
+
+#include "shake/content/voxel_model.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+struct VoxelRayHit
+{
+    glm::ivec3  position    { };
+    // Points out of the face that was hit, zero if the ray started inside the voxel
+    glm::ivec3  normal      { };
+    float       distance    { };
+    uint8_t     color_index { };
+};
+
+//----------------------------------------------------------------
+// A voxel chunk split into bricks of 8^3 voxels, of which only the non empty ones are stored.
+// Bricks are stored in morton order, as are the voxels within them,
+// so voxels that are close in space are also close in memory.
+// Point queries take constant time,
+// and rays skip over empty bricks as a whole.
+class VoxelBrickMap
+{
+public:
+    static constexpr int brick_size = 8;
+
+    //----------------------------------------------------------------
+    struct Brick
+    {
+        std::array<uint8_t, brick_size * brick_size * brick_size> color_indices { };
+    };
+
+public:
+    VoxelBrickMap() = default;
+    explicit VoxelBrickMap( const VoxelChunk& voxel_chunk );
+
+    //----------------------------------------------------------------
+    // Returns 0, which is empty, for positions outside of the map
+    uint8_t get_color_index( const glm::ivec3& position ) const;
+
+    //----------------------------------------------------------------
+    // Finds the first non empty voxel along the ray, within max_distance.
+    // The direction does not need to be normalized, distances are in multiples of it.
+    std::optional<VoxelRayHit> raycast
+    ( 
+        const glm::vec3&    origin, 
+        const glm::vec3&    direction, 
+        const float         max_distance = std::numeric_limits<float>::max() 
+    ) const;
+
+    //----------------------------------------------------------------
+    inline const glm::ivec3&    get_size()      const { return m_size; }
+    inline std::size_t          get_n_bricks()  const { return m_bricks.size(); }
+    inline std::size_t          get_n_bytes()   const { return m_bricks.size() * sizeof( Brick ) + m_brick_indices.size() * sizeof( uint32_t ); }
+
+private:
+    static constexpr uint32_t empty_brick = std::numeric_limits<uint32_t>::max();
+
+    //----------------------------------------------------------------
+    // Returns the brick at the given brick coordinates, or nullptr if it is empty
+    const Brick* find_brick( const glm::ivec3& brick_position ) const;
+
+    std::size_t get_brick_cell( const glm::ivec3& brick_position ) const;
+
+private:
+    glm::ivec3              m_size              { };
+    glm::ivec3              m_size_in_bricks    { };
+    // Per brick of the map, in linear order, the index of the brick in m_bricks
+    std::vector<uint32_t>   m_brick_indices     { };
+    std::vector<Brick>      m_bricks            { };
+};
+
+//----------------------------------------------------------------
+// A voxel model of which each chunk is stored as a brick map
+struct VoxelBrickModel
+{
+    std::vector<VoxelBrickMap>  chunks  { };
+    VoxelPalette                palette { };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // VOXEL_BRICK_MAP_HPP
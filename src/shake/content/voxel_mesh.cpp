@@ -0,0 +1,134 @@
+#include "voxel_mesh.hpp"
+
+#include <algorithm>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+DenseVoxelGrid make_dense_voxel_grid( const VoxelChunk& voxel_chunk )
+{
+    auto grid = DenseVoxelGrid { };
+    grid.size = voxel_chunk.size;
+    grid.color_indices.resize( static_cast<std::size_t>( grid.size.x ) * grid.size.y * grid.size.z, 0 );
+    for ( const auto& voxel : voxel_chunk.voxels )
+    {
+        grid.color_indices[ grid.get_index( voxel.x, voxel.y, voxel.z ) ] = voxel.color_index;
+    }
+    return grid;
+}
+
+//----------------------------------------------------------------
+VoxelMesh make_voxel_mesh_faces( const DenseVoxelGrid& grid, const std::size_t face_index )
+{
+    CHECK_LT( face_index, n_voxel_faces, "Face index out of range." );
+
+    // the face points along axis d, and spans the axes u and v,
+    // which are ordered such that u x v points along d
+    const auto d = static_cast<int>( face_index / 2 );
+    const auto u = ( d + 1 ) % 3;
+    const auto v = ( d + 2 ) % 3;
+    const auto is_positive = face_index % 2 == 0;
+
+    auto normal = glm::ivec3 { 0 };
+    normal[ d ] = is_positive ? 1 : -1;
+
+    const auto size_u = grid.size[ u ];
+    const auto size_v = grid.size[ v ];
+
+    auto mesh = VoxelMesh { };
+
+    // the colors of the visible faces within a single slice,
+    // 0 where there is no face, or where the face was already merged into a quad
+    auto mask = std::vector<uint8_t>( static_cast<std::size_t>( size_u ) * size_v );
+
+    for ( int slice = 0; slice < grid.size[ d ]; ++slice )
+    {
+        auto position = glm::ivec3 { 0 };
+        position[ d ] = slice;
+        for ( int j = 0; j < size_v; ++j )
+        {
+            position[ v ] = j;
+            for ( int i = 0; i < size_u; ++i )
+            {
+                position[ u ] = i;
+                const auto color_index = grid.get_color_index( position );
+                const auto is_visible = color_index != 0 && grid.get_color_index( position + normal ) == 0;
+                mask[ static_cast<std::size_t>( j ) * size_u + i ] = is_visible ? color_index : 0;
+            }
+        }
+
+        // the faces lie on the far side of the voxels when pointing along the positive axis
+        const auto plane = static_cast<float>( is_positive ? slice + 1 : slice );
+
+        for ( int j = 0; j < size_v; ++j )
+        {
+            for ( int i = 0; i < size_u; )
+            {
+                const auto color_index = mask[ static_cast<std::size_t>( j ) * size_u + i ];
+                if ( color_index == 0 ) { ++i; continue; }
+
+                // grow the quad along u first, and then along v for as long as entire rows match
+                int width { 1 };
+                while ( i + width < size_u && mask[ static_cast<std::size_t>( j ) * size_u + i + width ] == color_index ) { ++width; }
+
+                int height { 1 };
+                for ( ; j + height < size_v; ++height )
+                {
+                    const auto row = mask.data() + static_cast<std::size_t>( j + height ) * size_u + i;
+                    bool is_row_matching { true };
+                    for ( int k = 0; k < width && is_row_matching; ++k ) { is_row_matching = row[ k ] == color_index; }
+                    if ( !is_row_matching ) { break; }
+                }
+
+                for ( int l = 0; l < height; ++l )
+                {
+                    std::fill_n( mask.data() + static_cast<std::size_t>( j + l ) * size_u + i, width, uint8_t { 0 } );
+                }
+
+                auto corner = glm::vec3 { 0.f };
+                corner[ d ] = plane;
+                corner[ u ] = static_cast<float>( i );
+                corner[ v ] = static_cast<float>( j );
+                auto du = glm::vec3 { 0.f };
+                du[ u ] = static_cast<float>( width );
+                auto dv = glm::vec3 { 0.f };
+                dv[ v ] = static_cast<float>( height );
+
+                const auto first_vertex = static_cast<uint32_t>( mesh.vertices.size() );
+                for ( const auto& vertex_position : { corner, corner + du, corner + du + dv, corner + dv } )
+                {
+                    mesh.vertices.push_back( VoxelMeshVertex { vertex_position, static_cast<uint8_t>( face_index ), color_index } );
+                }
+
+                // counter clockwise when seen from the side the face points to
+                if ( is_positive )
+                {
+                    mesh.indices.insert( mesh.indices.end(), { first_vertex, first_vertex + 1, first_vertex + 2, first_vertex, first_vertex + 2, first_vertex + 3 } );
+                }
+                else
+                {
+                    mesh.indices.insert( mesh.indices.end(), { first_vertex, first_vertex + 2, first_vertex + 1, first_vertex, first_vertex + 3, first_vertex + 2 } );
+                }
+
+                i += width;
+            }
+        }
+    }
+
+    return mesh;
+}
+
+//----------------------------------------------------------------
+void append_voxel_mesh( VoxelMesh& mesh, const VoxelMesh& other )
+{
+    const auto first_vertex = static_cast<uint32_t>( mesh.vertices.size() );
+    mesh.vertices.insert( mesh.vertices.end(), other.vertices.begin(), other.vertices.end() );
+    mesh.indices.reserve( mesh.indices.size() + other.indices.size() );
+    for ( const auto index : other.indices ) { mesh.indices.push_back( first_vertex + index ); }
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,103 @@
+#ifndef VOXEL_MESH_HPP
+#define VOXEL_MESH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "shake/core/math/math.hpp"
+
+#include "shake/content/voxel_model.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// The color indices of a voxel chunk, stored densely,
+// so the neighbours of a voxel can be looked up in constant time
+struct DenseVoxelGrid
+{
+    glm::ivec3              size            { };
+    std::vector<uint8_t>    color_indices   { };
+
+    //----------------------------------------------------------------
+    inline std::size_t get_index( const int x, const int y, const int z ) const
+    {
+        return static_cast<std::size_t>( x ) + static_cast<std::size_t>( size.x ) * ( static_cast<std::size_t>( y ) + static_cast<std::size_t>( size.y ) * z );
+    }
+
+    //----------------------------------------------------------------
+    // Returns 0, which is empty, for positions outside of the grid
+    inline uint8_t get_color_index( const glm::ivec3& position ) const
+    {
+        if 
+        ( 
+            position.x < 0 || position.y < 0 || position.z < 0 
+            || position.x >= size.x || position.y >= size.y || position.z >= size.z 
+        )
+        {
+            return 0;
+        }
+        return color_indices[ get_index( position.x, position.y, position.z ) ];
+    }
+};
+
+DenseVoxelGrid make_dense_voxel_grid( const VoxelChunk& voxel_chunk );
+
+//----------------------------------------------------------------
+// Faces are ordered +x, -x, +y, -y, +z, -z
+constexpr std::size_t n_voxel_faces = 6;
+
+//----------------------------------------------------------------
+// Positions are in voxels, relative to the corner of the chunk.
+// The normal and color are shared by all vertices of a quad,
+// so they are stored as indices, to be looked up in the shader.
+struct VoxelMeshVertex
+{
+    glm::vec3   position    { };
+    uint8_t     face_index  { };
+    uint8_t     color_index { };
+    uint8_t     padding[ 2 ]{ };
+};
+static_assert( sizeof( VoxelMeshVertex ) == 16, "Voxel mesh vertices should be tightly packed." );
+
+//----------------------------------------------------------------
+// The indices that belong to a single chunk of a voxel model
+struct VoxelSubmesh
+{
+    std::size_t first_index { };
+    std::size_t n_indices   { };
+};
+
+//----------------------------------------------------------------
+// The visible surface of a voxel model as an indexed triangle list,
+// with one submesh per chunk of the model
+struct VoxelMesh
+{
+    std::vector<VoxelMeshVertex>    vertices    { };
+    std::vector<uint32_t>           indices     { };
+    std::vector<VoxelSubmesh>       submeshes   { };
+
+    //----------------------------------------------------------------
+    inline std::size_t get_n_triangles() const { return indices.size() / 3; }
+};
+
+//----------------------------------------------------------------
+// Meshes the faces of the grid that point in one direction.
+// Faces between two filled voxels are culled,
+// and the remaining faces are greedily merged into quads of a single color.
+// Each direction can be meshed on a separate thread.
+VoxelMesh make_voxel_mesh_faces( const DenseVoxelGrid& grid, const std::size_t face_index );
+
+//----------------------------------------------------------------
+// Appends the vertices and indices of other to mesh.
+// Submeshes are left to the caller.
+void append_voxel_mesh( VoxelMesh& mesh, const VoxelMesh& other );
+
+//----------------------------------------------------------------
+// Drawing every voxel as an instanced cube takes 12 triangles per voxel
+inline std::size_t get_n_instanced_cube_triangles( const VoxelModel& voxel_model ) { return voxel_model.get_n_voxels() * 12; }
+
+} // namespace content
+} // namespace shake
+
+#endif // VOXEL_MESH_HPP
@@ -0,0 +1,58 @@
+#ifndef VOXEL_MODEL_HPP
+#define VOXEL_MODEL_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "shake/core/math/math.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A single voxel, laid out exactly as in the XYZI chunk of a .vox file,
+// so voxels can be copied out of the file in bulk and used as instance data as is.
+struct Voxel
+{
+    uint8_t x           { };
+    uint8_t y           { };
+    uint8_t z           { };
+    uint8_t color_index { };
+};
+static_assert( sizeof( Voxel ) == 4, "Voxels should be tightly packed." );
+
+//----------------------------------------------------------------
+// Colors are stored as RGBA bytes, and are indexed by Voxel::color_index.
+// Index 0 is empty.
+using VoxelPalette = std::array<uint32_t, 256>;
+
+//----------------------------------------------------------------
+// A sparse list of the voxels within a grid of the given size
+struct VoxelChunk
+{
+    glm::ivec3          size    { };
+    std::vector<Voxel>  voxels  { };
+};
+
+//----------------------------------------------------------------
+// The contents of a .vox file,
+// which can hold multiple chunks that share a palette
+struct VoxelModel
+{
+    std::vector<VoxelChunk> chunks  { };
+    VoxelPalette            palette { };
+
+    //----------------------------------------------------------------
+    inline std::size_t get_n_voxels() const
+    {
+        std::size_t n_voxels { 0 };
+        for ( const auto& chunk : chunks ) { n_voxels += chunk.voxels.size(); }
+        return n_voxels;
+    }
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // VOXEL_MODEL_HPP
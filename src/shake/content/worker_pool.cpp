@@ -0,0 +1,133 @@
+#include "worker_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "shake/core/contracts/contracts.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+WorkerPool::WorkerPool( const std::size_t n_threads )
+{
+    CHECK_GT( n_threads, 0, "A worker pool needs at least one thread." );
+    m_threads.reserve( n_threads );
+    for ( std::size_t thread_index = 0; thread_index < n_threads; ++thread_index )
+    {
+        m_threads.emplace_back( [ this ]() { run(); } );
+    }
+}
+
+//----------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_mutex };
+        m_is_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for ( auto& thread : m_threads )
+    {
+        thread.join();
+    }
+}
+
+//----------------------------------------------------------------
+void WorkerPool::submit( Task task )
+{
+    {
+        const auto lock = std::lock_guard<std::mutex> { m_mutex };
+        m_tasks.emplace_back( std::move( task ) );
+    }
+    m_condition.notify_one();
+}
+
+//----------------------------------------------------------------
+void WorkerPool::parallel_for
+( 
+    const std::size_t                               n_indices, 
+    const std::function<void( std::size_t )>&       function, 
+    const std::size_t                               max_concurrency 
+)
+{
+    if ( n_indices == 0 ) { return; }
+
+    // Helpers may only get to run after all indices are done,
+    // so everything they touch is shared instead of living on this stack.
+    struct State
+    {
+        std::function<void( std::size_t )> function        { };
+        std::size_t                         n_indices       { };
+        std::atomic<std::size_t>            next_index      { 0 };
+        std::size_t                         n_done_indices  { 0 };
+        std::exception_ptr                  exception       { };
+        std::mutex                          mutex           { };
+        std::condition_variable             condition       { };
+    };
+
+    const auto state = std::make_shared<State>();
+    state->function = function;
+    state->n_indices = n_indices;
+
+    const auto run_indices = [ state ]()
+    {
+        for ( auto index = state->next_index++; index < state->n_indices; index = state->next_index++ )
+        {
+            auto exception = std::exception_ptr { };
+            try                 { state->function( index ); }
+            catch ( ... )       { exception = std::current_exception(); }
+
+            const auto lock = std::lock_guard<std::mutex> { state->mutex };
+            if ( exception && !state->exception ) { state->exception = exception; }
+            if ( ++state->n_done_indices == state->n_indices ) { state->condition.notify_all(); }
+        }
+    };
+
+    const auto max_n_threads = ( max_concurrency == 0 ) ? get_n_threads() + 1 : max_concurrency;
+    const auto n_helpers = std::min( { max_n_threads - 1, get_n_threads(), n_indices - 1 } );
+    for ( std::size_t helper_index = 0; helper_index < n_helpers; ++helper_index )
+    {
+        submit( run_indices );
+    }
+
+    run_indices();
+
+    auto lock = std::unique_lock<std::mutex> { state->mutex };
+    state->condition.wait( lock, [ &state ]() { return state->n_done_indices == state->n_indices; } );
+    if ( state->exception ) { std::rethrow_exception( state->exception ); }
+}
+
+//----------------------------------------------------------------
+std::size_t WorkerPool::get_default_n_threads()
+{
+    const auto n_hardware_threads = static_cast<std::size_t>( std::thread::hardware_concurrency() );
+    return std::max<std::size_t>( n_hardware_threads, 2 ) - 1;
+}
+
+//----------------------------------------------------------------
+void WorkerPool::run()
+{
+    while ( true )
+    {
+        auto task = Task { };
+        {
+            auto lock = std::unique_lock<std::mutex> { m_mutex };
+            m_condition.wait( lock, [ this ]() { return m_is_stopping || !m_tasks.empty(); } );
+
+            // pending tasks are dropped when stopping,
+            // their promises are broken, which wakes up anyone waiting on them
+            if ( m_is_stopping ) { return; }
+
+            task = std::move( m_tasks.front() );
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace content
+} // namespace shake
@@ -0,0 +1,66 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "shake/core/macros/macro_non_copyable.hpp"
+
+namespace shake {
+namespace content {
+
+//----------------------------------------------------------------
+// A fixed set of threads that run submitted tasks in fifo order.
+// Used by the content manager to run the cpu side of content loading,
+// such as image decoding and glyph rasterization, off the calling thread.
+class WorkerPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkerPool( const std::size_t n_threads = get_default_n_threads() );
+    ~WorkerPool();
+    NON_COPYABLE( WorkerPool )
+
+    //----------------------------------------------------------------
+    void submit( Task task );
+
+    //----------------------------------------------------------------
+    // Calls function( index ) for every index in [0, n_indices), 
+    // on at most max_concurrency threads, where 0 means no limit.
+    // The calling thread takes part instead of only waiting,
+    // so this is also safe to call from tasks that run on the pool itself.
+    // Returns once all indices are done, rethrowing the first exception if any.
+    void parallel_for
+    ( 
+        const std::size_t                               n_indices, 
+        const std::function<void( std::size_t )>&       function, 
+        const std::size_t                               max_concurrency = 0 
+    );
+
+    //----------------------------------------------------------------
+    inline std::size_t get_n_threads() const { return m_threads.size(); }
+
+    //----------------------------------------------------------------
+    // Leave one core for the thread that owns the graphics context
+    static std::size_t get_default_n_threads();
+
+private:
+    void run();
+
+private:
+    std::vector<std::thread>    m_threads;
+    std::deque<Task>            m_tasks;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_condition;
+    bool                        m_is_stopping { false };
+};
+
+} // namespace content
+} // namespace shake
+
+#endif // WORKER_POOL_HPP
@@ -0,0 +1,434 @@
+#include "fixtures.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "shake/core/contracts/contracts.hpp"
+#include "shake/io/file_json.hpp"
+
+#include "shake/content/cook_texture.hpp"
+#include "shake/content/cooked_texture_format.hpp"
+
+namespace shake {
+namespace content_benchmark {
+
+namespace { // anonymous
+
+constexpr auto texture_sizes            = std::array<int, 4>            { 64, 256, 1024, 2048 };
+constexpr auto cube_map_sizes           = std::array<int, 2>            { 128, 512 };
+constexpr auto material_n_uniforms      = std::array<std::size_t, 3>    { 1, 8, 32 };
+// .vox files store voxel coordinates in a byte, so 256 is the largest size
+constexpr auto voxel_model_sizes        = std::array<uint32_t, 4>       { 16, 64, 128, 256 };
+constexpr auto font_pixel_size          = 32;
+constexpr auto mesh_n_segments          = std::array<uint32_t, 3>       { 32, 128, 512 };
+constexpr auto shader_n_includes        = std::array<std::size_t, 3>    { 1, 8, 32 };
+constexpr auto shader_n_functions       = 16;
+
+//----------------------------------------------------------------
+// A fast deterministic random number generator, so fixtures are the same every run
+class Random
+{
+public:
+    explicit Random( const uint64_t seed ) : m_state { seed } { }
+
+    uint32_t next()
+    {
+        m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<uint32_t>( m_state >> 33 );
+    }
+
+private:
+    uint64_t m_state;
+};
+
+//----------------------------------------------------------------
+uint64_t get_file_size( const io::Path& path )
+{
+    return static_cast<uint64_t>( std::filesystem::file_size( path.get_string() ) );
+}
+
+//----------------------------------------------------------------
+// Returns the size of the written file
+uint64_t write_file( const io::Path& path, const void* data, const std::size_t size )
+{
+    std::filesystem::create_directories( std::filesystem::path { path.get_string() }.parent_path() );
+    auto stream = std::ofstream( path.get_string(), std::ios::binary );
+    stream.write( static_cast<const char*>( data ), static_cast<std::streamsize>( size ) );
+    CHECK( stream.good(), "Could not write fixture: " + path.get_string() );
+    return size;
+}
+
+//----------------------------------------------------------------
+uint64_t write_json( const io::Path& path, const json11::Json& json )
+{
+    const auto json_str = json.dump();
+    return write_file( path, json_str.data(), json_str.size() );
+}
+
+//----------------------------------------------------------------
+// Smooth gradients with some noise, so the image compresses about as well as a real texture
+uint64_t write_png( const io::Path& path, const int size, const int n_channels, Random& random )
+{
+    auto pixels = std::vector<uint8_t>( static_cast<std::size_t>( size ) * size * n_channels );
+    for ( int y = 0; y < size; ++y )
+    {
+        for ( int x = 0; x < size; ++x )
+        {
+            for ( int channel = 0; channel < n_channels; ++channel )
+            {
+                const auto gradient = ( x * ( channel + 1 ) + y * ( n_channels - channel ) ) * 255 / ( size * ( n_channels + 1 ) );
+                const auto noise    = static_cast<int>( random.next() & 0x0f );
+                pixels[ ( static_cast<std::size_t>( y ) * size + x ) * n_channels + channel ] = static_cast<uint8_t>( std::min( gradient + noise, 255 ) );
+            }
+        }
+    }
+
+    std::filesystem::create_directories( std::filesystem::path { path.get_string() }.parent_path() );
+    const auto is_written = stbi_write_png( path.get_string().c_str(), size, size, n_channels, pixels.data(), size * n_channels );
+    CHECK( is_written != 0, "Could not write fixture: " + path.get_string() );
+    return get_file_size( path );
+}
+
+//----------------------------------------------------------------
+// A sphere that fills the model, in the magica voxel format
+uint64_t write_vox( const io::Path& path, const uint32_t size, Random& random )
+{
+    auto voxels = std::vector<std::array<uint8_t, 4>> { };
+    const auto center = ( static_cast<float>( size ) - 1.f ) / 2.f;
+    for ( uint32_t z = 0; z < size; ++z )
+    for ( uint32_t y = 0; y < size; ++y )
+    for ( uint32_t x = 0; x < size; ++x )
+    {
+        const auto dx = x - center;
+        const auto dy = y - center;
+        const auto dz = z - center;
+        if ( dx * dx + dy * dy + dz * dz <= center * center )
+        {
+            // colors are 1 based, 0 is empty
+            const auto color_index = static_cast<uint8_t>( 1 + random.next() % 255 );
+            voxels.push_back( { static_cast<uint8_t>( x ), static_cast<uint8_t>( y ), static_cast<uint8_t>( z ), color_index } );
+        }
+    }
+
+    auto bytes = std::vector<uint8_t> { };
+    const auto write_u32 = [ &bytes ]( const uint32_t value )
+    {
+        const auto value_bytes = reinterpret_cast<const uint8_t*>( &value );
+        bytes.insert( bytes.end(), value_bytes, value_bytes + sizeof( value ) );
+    };
+    const auto write_chunk_id = [ &bytes ]( const char ( &id )[ 5 ] ) { bytes.insert( bytes.end(), id, id + 4 ); };
+
+    const auto n_bytes_size     = static_cast<uint32_t>( 3 * sizeof( uint32_t ) );
+    const auto n_bytes_voxels   = static_cast<uint32_t>( sizeof( uint32_t ) + voxels.size() * 4 );
+    const auto n_bytes_palette  = static_cast<uint32_t>( 256 * sizeof( uint32_t ) );
+    const auto n_bytes_chunk_header = static_cast<uint32_t>( 3 * sizeof( uint32_t ) );
+
+    write_chunk_id( "VOX " );
+    write_u32( 150 );
+
+    write_chunk_id( "MAIN" );
+    write_u32( 0 );
+    write_u32( 3 * n_bytes_chunk_header + n_bytes_size + n_bytes_voxels + n_bytes_palette );
+
+    write_chunk_id( "SIZE" );
+    write_u32( n_bytes_size );
+    write_u32( 0 );
+    write_u32( size );
+    write_u32( size );
+    write_u32( size );
+
+    write_chunk_id( "XYZI" );
+    write_u32( n_bytes_voxels );
+    write_u32( 0 );
+    write_u32( static_cast<uint32_t>( voxels.size() ) );
+    for ( const auto& voxel : voxels ) { bytes.insert( bytes.end(), voxel.begin(), voxel.end() ); }
+
+    write_chunk_id( "RGBA" );
+    write_u32( n_bytes_palette );
+    write_u32( 0 );
+    for ( uint32_t color_index = 0; color_index < 256; ++color_index ) { write_u32( 0xff000000 | ( random.next() & 0x00ffffff ) ); }
+
+    return write_file( path, bytes.data(), bytes.size() );
+}
+
+//----------------------------------------------------------------
+// A uv sphere, with its triangles shuffled, as they are in meshes that were never optimized
+uint64_t write_obj_sphere( const io::Path& path, const uint32_t n_segments, Random& random )
+{
+    const auto n_rings = n_segments / 2;
+    const auto pi = 3.14159265f;
+
+    auto stream = std::ostringstream { };
+    for ( uint32_t ring = 0; ring <= n_rings; ++ring )
+    for ( uint32_t segment = 0; segment <= n_segments; ++segment )
+    {
+        const auto u = static_cast<float>( segment ) / n_segments;
+        const auto v = static_cast<float>( ring ) / n_rings;
+        const auto x = std::sin( v * pi ) * std::cos( u * 2.f * pi );
+        const auto y = std::cos( v * pi );
+        const auto z = std::sin( v * pi ) * std::sin( u * 2.f * pi );
+        stream << "v " << x << " " << y << " " << z << "\n";
+        stream << "vn " << x << " " << y << " " << z << "\n";
+        stream << "vt " << u << " " << v << "\n";
+    }
+
+    // obj indices are 1 based
+    auto triangles = std::vector<std::array<uint32_t, 3>> { };
+    const auto get_vertex = [ & ]( const uint32_t ring, const uint32_t segment ) { return ring * ( n_segments + 1 ) + segment + 1; };
+    for ( uint32_t ring = 0; ring < n_rings; ++ring )
+    for ( uint32_t segment = 0; segment < n_segments; ++segment )
+    {
+        triangles.push_back( { get_vertex( ring, segment ), get_vertex( ring, segment + 1 ),     get_vertex( ring + 1, segment + 1 ) } );
+        triangles.push_back( { get_vertex( ring, segment ), get_vertex( ring + 1, segment + 1 ), get_vertex( ring + 1, segment ) } );
+    }
+    for ( auto triangle_index = triangles.size(); triangle_index > 1; --triangle_index )
+    {
+        std::swap( triangles[ triangle_index - 1 ], triangles[ random.next() % triangle_index ] );
+    }
+
+    for ( const auto& triangle : triangles )
+    {
+        stream << "f";
+        for ( const auto vertex : triangle ) { stream << " " << vertex << "/" << vertex << "/" << vertex; }
+        stream << "\n";
+    }
+
+    const auto obj = stream.str();
+    return write_file( path, obj.data(), obj.size() );
+}
+
+//----------------------------------------------------------------
+json11::Json make_texture_json( const std::string& image_path )
+{
+    return json11::Json::object
+    {
+        { "texture",            image_path  },
+        { "image_format",       "png"       },
+        { "texture_format",     "RGBA"      },
+        { "interpolation_mode", "Linear"    },
+        { "generate_mip_maps",  false       }
+    };
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+const char* to_string( const FixtureKind kind )
+{
+    switch ( kind )
+    {
+    case FixtureKind::Texture:      return "texture";
+    case FixtureKind::CubeMap:      return "cube_map";
+    case FixtureKind::Font:         return "font";
+    case FixtureKind::Material:     return "material";
+    case FixtureKind::VoxelModel:   return "voxel_model";
+    }
+    CHECK_FAIL( "Unknown fixture kind." );
+    return ""; // to shut up warning
+}
+
+//----------------------------------------------------------------
+std::vector<Fixture> write_fixtures( const io::Path& directory, const std::optional<io::Path>& font_file_path )
+{
+    auto fixtures = std::vector<Fixture> { };
+    auto random = Random { 42 };
+
+    for ( const auto size : texture_sizes )
+    {
+        const auto name         = std::to_string( size );
+        const auto image_path   = "images/texture_" + name + ".png";
+        const auto path         = io::Path { "textures/" + name + ".json" };
+
+        auto n_source_bytes = write_png( directory / io::Path { image_path }, size, 4, random );
+        n_source_bytes += write_json( directory / path, make_texture_json( image_path ) );
+        fixtures.emplace_back( Fixture { FixtureKind::Texture, "texture/" + name, path, n_source_bytes } );
+    }
+
+    // the fixtures are the only texture files in the directory
+    const auto cooked_directory = io::Path { "cooked" };
+    content::cook_textures( directory, directory / cooked_directory );
+    for ( auto& fixture : fixtures )
+    {
+        if ( fixture.kind != FixtureKind::Texture ) { continue; }
+        auto cooked_path = std::filesystem::path( fixture.path.get_string() );
+        cooked_path.replace_extension( content::cooked_texture_format::file_extension );
+        fixture.cooked_path     = cooked_directory / io::Path { cooked_path.generic_string() };
+        fixture.n_cooked_bytes  = get_file_size( directory / *fixture.cooked_path );
+    }
+
+    for ( const auto size : cube_map_sizes )
+    {
+        const auto name = std::to_string( size );
+        const auto path = io::Path { "cube_maps/" + name + ".json" };
+
+        auto json = json11::Json::object
+        {
+            { "image_format",       "png"       },
+            { "texture_format",     "RGB"       },
+            { "interpolation_mode", "Linear"    },
+            { "generate_mip_maps",  false       }
+        };
+
+        uint64_t n_source_bytes { 0 };
+        for ( const auto face_key : { "right", "left", "top", "bottom", "front", "back" } )
+        {
+            const auto image_path = "images/cube_map_" + name + "_" + face_key + ".png";
+            n_source_bytes += write_png( directory / io::Path { image_path }, size, 3, random );
+            json[ face_key ] = image_path;
+        }
+        n_source_bytes += write_json( directory / path, json );
+        fixtures.emplace_back( Fixture { FixtureKind::CubeMap, "cube_map/" + name, path, n_source_bytes } );
+    }
+
+    if ( font_file_path )
+    {
+        const auto font_path = std::string { "fonts/benchmark.ttf" };
+        std::filesystem::create_directories( ( directory / io::Path { "fonts" } ).get_string() );
+        std::filesystem::copy_file( font_file_path->get_string(), ( directory / io::Path { font_path } ).get_string(), std::filesystem::copy_options::overwrite_existing );
+
+        for ( const auto rendering : { "bitmap", "sdf" } )
+        {
+            const auto path = io::Path { std::string { "fonts/" } + rendering + ".json" };
+            const auto json = json11::Json::object
+            {
+                { "default",        font_path       },
+                { "itallic",        font_path       },
+                { "bold",           font_path       },
+                { "bold_itallic",   font_path       },
+                { "rendering",      rendering       },
+                { "pixel_size",     font_pixel_size }
+            };
+
+            // every face reads the font file
+            const auto n_source_bytes = write_json( directory / path, json ) + 4 * get_file_size( *font_file_path );
+            fixtures.emplace_back( Fixture { FixtureKind::Font, std::string { "font/" } + rendering, path, n_source_bytes } );
+        }
+    }
+
+    for ( const auto n_uniforms : material_n_uniforms )
+    {
+        const auto name = std::to_string( n_uniforms );
+        const auto path = io::Path { "materials/" + name + ".json" };
+
+        auto uniforms = json11::Json::array { };
+        for ( std::size_t uniform_index = 0; uniform_index < n_uniforms; ++uniform_index )
+        {
+            uniforms.emplace_back( json11::Json::object { { "type", "texture" }, { "path", "textures/64.json" } } );
+        }
+
+        // materials are decoded without loading the content they refer to,
+        // so the program does not need to exist
+        const auto json = json11::Json::object { { "shader", "programs/benchmark.glsl" }, { "uniforms", uniforms } };
+        const auto n_source_bytes = write_json( directory / path, json );
+        fixtures.emplace_back( Fixture { FixtureKind::Material, "material/" + name, path, n_source_bytes } );
+    }
+
+    for ( const auto size : voxel_model_sizes )
+    {
+        const auto name = std::to_string( size );
+        const auto path = io::Path { "voxel_models/" + name + ".vox" };
+        const auto n_source_bytes = write_vox( directory / path, size, random );
+        fixtures.emplace_back( Fixture { FixtureKind::VoxelModel, "voxel_model/" + name, path, n_source_bytes } );
+    }
+
+    return fixtures;
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> write_material_descriptors( const io::Path& directory, const std::size_t n_materials )
+{
+    auto paths = std::vector<io::Path> { };
+    paths.reserve( n_materials );
+    for ( std::size_t material_index = 0; material_index < n_materials; ++material_index )
+    {
+        const auto path = io::Path { "materials/" + std::to_string( material_index ) + ".json" };
+
+        auto uniforms = json11::Json::array { };
+        for ( std::size_t uniform_index = 0; uniform_index < material_index % 4 + 1; ++uniform_index )
+        {
+            const auto texture_path = "textures/" + std::to_string( ( material_index + uniform_index ) % 64 ) + ".json";
+            uniforms.emplace_back( json11::Json::object { { "type", "texture" }, { "path", texture_path } } );
+        }
+        uniforms.emplace_back( json11::Json::object { { "type", "cube_map" }, { "path", "cube_maps/sky.json" } } );
+
+        const auto json = json11::Json::object { { "shader", "programs/benchmark.glsl" }, { "uniforms", uniforms } };
+        write_json( directory / path, json );
+        paths.emplace_back( path );
+    }
+    return paths;
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> write_obj_meshes( const io::Path& directory )
+{
+    auto paths = std::vector<io::Path> { };
+    auto random = Random { 42 };
+    for ( const auto n_segments : mesh_n_segments )
+    {
+        const auto path = io::Path { "sphere_" + std::to_string( n_segments ) + ".obj" };
+        write_obj_sphere( directory / path, n_segments, random );
+        paths.emplace_back( path );
+    }
+    return paths;
+}
+
+//----------------------------------------------------------------
+std::vector<io::Path> write_shader_programs( const io::Path& directory )
+{
+    const auto get_include_path = []( const std::size_t include_index ) { return "programs/include_" + std::to_string( include_index ) + ".glsl"; };
+
+    for ( std::size_t include_index = 0; include_index < shader_n_includes.back(); ++include_index )
+    {
+        auto source = std::ostringstream { };
+        if ( include_index != 0 ) { source << "#include \"" << get_include_path( include_index - 1 ) << "\"\n\n"; }
+        for ( int function_index = 0; function_index < shader_n_functions; ++function_index )
+        {
+            source
+                << "vec3 function_" << include_index << "_" << function_index << "( vec3 position, float scale )\n"
+                << "{\n"
+                << "    return normalize( position * scale + vec3( " << function_index << ".0 ) );\n"
+                << "}\n\n";
+        }
+        const auto source_str = source.str();
+        write_file( directory / io::Path { get_include_path( include_index ) }, source_str.data(), source_str.size() );
+    }
+
+    auto paths = std::vector<io::Path> { };
+    for ( const auto n_includes : shader_n_includes )
+    {
+        const auto name = "programs/program_" + std::to_string( n_includes );
+
+        auto source = std::ostringstream { };
+        source << "#version 330 core\n";
+        for ( std::size_t include_index = 0; include_index < n_includes; ++include_index )
+        {
+            source << "#include \"" << get_include_path( include_index ) << "\"\n";
+        }
+        source << "\nout vec4 color;\n\nvoid main()\n{\n    color = vec4( 1.0 );\n}\n";
+        const auto source_str = source.str();
+        write_file( directory / io::Path { name + ".glsl" }, source_str.data(), source_str.size() );
+
+        const auto json = json11::Json::object
+        {
+            { "source",     name + ".glsl" },
+            { "defines",    json11::Json::object { { "SKINNED", "1" }, { "MAX_LIGHTS", "8" } } }
+        };
+        write_json( directory / io::Path { name + ".json" }, json );
+
+        paths.emplace_back( io::Path { name + ".glsl" } );
+        paths.emplace_back( io::Path { name + ".json" } );
+    }
+    return paths;
+}
+
+} // namespace content_benchmark
+} // namespace shake
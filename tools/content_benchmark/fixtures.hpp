@@ -0,0 +1,73 @@
+#ifndef CONTENT_BENCHMARK_FIXTURES_HPP
+#define CONTENT_BENCHMARK_FIXTURES_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "shake/io/path.hpp"
+
+namespace shake {
+namespace content_benchmark {
+
+//----------------------------------------------------------------
+enum class FixtureKind
+{
+    Texture,
+    CubeMap,
+    Font,
+    Material,
+    VoxelModel
+};
+
+const char* to_string( const FixtureKind kind );
+
+//----------------------------------------------------------------
+// Generated content to load in a benchmark
+struct Fixture
+{
+    FixtureKind             kind            { };
+    // names the benchmarks of the fixture, such as "texture/1024"
+    std::string             name            { };
+    // relative to the fixture directory
+    io::Path                path            { };
+    // the size of all files the content is loaded from
+    uint64_t                n_source_bytes  { };
+    // the cooked file of the content, relative to the fixture directory, if it is cooked
+    std::optional<io::Path> cooked_path     { };
+    uint64_t                n_cooked_bytes  { };
+};
+
+//----------------------------------------------------------------
+// Writes synthetic content of various sizes to the directory:
+// textures and cube maps of noisy png images, materials with a varying number of uniforms,
+// and .vox models of spheres.
+// Textures are also cooked, to the cooked directory within the directory.
+// Font fixtures are only written when a font file is given, as the repository contains none.
+// Fixtures are generated deterministically, so results are comparable between runs.
+std::vector<Fixture> write_fixtures( const io::Path& directory, const std::optional<io::Path>& font_file_path );
+
+//----------------------------------------------------------------
+// Writes many small json material files to the directory, with one to four uniforms each,
+// to measure the cost of reading descriptors rather than the content they refer to.
+// Returns their paths, relative to the directory.
+std::vector<io::Path> write_material_descriptors( const io::Path& directory, const std::size_t n_materials );
+
+//----------------------------------------------------------------
+// Writes .obj spheres of increasing resolution to the directory, with normals and texture coordinates,
+// and their triangles shuffled, so cooking them has something to optimize.
+// Returns their paths, relative to the directory.
+std::vector<io::Path> write_obj_meshes( const io::Path& directory );
+
+//----------------------------------------------------------------
+// Writes .glsl programs with an increasing number of includes to the directory,
+// where every include also includes the one before it, as shared shader code tends to,
+// and a json variant of every program that defines a few macros.
+// Returns the paths of the programs, each followed by its variant, relative to the directory.
+std::vector<io::Path> write_shader_programs( const io::Path& directory );
+
+} // namespace content_benchmark
+} // namespace shake
+
+#endif // CONTENT_BENCHMARK_FIXTURES_HPP
@@ -0,0 +1,1395 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "shake/io/file_json.hpp"
+#include "shake/io/path.hpp"
+
+#include "shake/content/compile_descriptor.hpp"
+#include "shake/content/content_manager.hpp"
+#include "shake/content/cook_mesh.hpp"
+#include "shake/content/flat_content_table.hpp"
+#include "shake/content/glyph_atlas.hpp"
+#include "shake/content/load_voxel_model.hpp"
+#include "shake/content/mesh_optimizer.hpp"
+#include "shake/content/mesh_simplifier.hpp"
+#include "shake/content/shader_preprocessor.hpp"
+#include "shake/content/signed_distance_field.hpp"
+#include "shake/content/voxel_brick_map.hpp"
+#include "shake/content/voxel_mesh.hpp"
+
+#include "fixtures.hpp"
+
+//----------------------------------------------------------------
+// Counts the allocations of the whole benchmark, on every thread, to report how many a load makes from the heap.
+// Over-aligned allocations are not counted.
+namespace { // anonymous
+std::atomic<uint64_t> n_heap_allocations { 0 };
+} // namespace anonymous
+
+void* operator new( std::size_t n_bytes )
+{
+    ++n_heap_allocations;
+    if ( const auto pointer = std::malloc( n_bytes == 0 ? 1 : n_bytes ) ) { return pointer; }
+    throw std::bad_alloc { };
+}
+
+void operator delete( void* pointer ) noexcept                  { std::free( pointer ); }
+void operator delete( void* pointer, std::size_t ) noexcept     { std::free( pointer ); }
+
+namespace shake {
+namespace content_benchmark {
+
+namespace { // anonymous
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t default_n_iterations      = 20;
+constexpr std::size_t n_cache_gets              = 1000000;
+constexpr std::size_t n_material_descriptors    = 10000;
+constexpr auto        cache_table_sizes         = std::array<std::size_t, 3> { 1000, 10000, 100000 };
+constexpr std::size_t n_voxel_queries           = 1000000;
+constexpr std::size_t n_voxel_raycasts          = 100000;
+// as many as the glyphs of the four faces of a font
+constexpr std::size_t n_atlas_glyphs            = 512;
+// glyphs are rasterized at a high resolution and downscaled into their distance fields
+constexpr int         sdf_coverage_size         = 1024;
+constexpr int         sdf_spread                = 4;
+constexpr int         sdf_downscale             = 8;
+
+// Fonts are not part of the repository, so a common system font is used if none is given
+const auto default_font_file_paths = std::vector<std::string>
+{
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/TTF/DejaVuSans.ttf",
+    "/System/Library/Fonts/Supplemental/Arial.ttf",
+    "C:/Windows/Fonts/arial.ttf"
+};
+
+//----------------------------------------------------------------
+// Holds decoded content in place of the graphics objects it would be uploaded to,
+// so loads can be measured without a graphics context
+template<typename Decoded_T>
+struct HeadlessContent
+{
+    Decoded_T decoded;
+};
+
+template<typename Decoded_T>
+std::shared_ptr<HeadlessContent<Decoded_T>> upload_headless( content::ContentManager*, const Decoded_T& decoded )
+{
+    return std::make_shared<HeadlessContent<Decoded_T>>( HeadlessContent<Decoded_T> { decoded } );
+}
+
+using HeadlessTexture       = HeadlessContent<content::load::TextureData>;
+using HeadlessCubeMap       = HeadlessContent<content::load::CubeMapData>;
+using HeadlessFont          = HeadlessContent<content::load::FontData>;
+using HeadlessMaterial      = HeadlessContent<content::load::MaterialDescription>;
+using HeadlessVoxelModel    = HeadlessContent<std::shared_ptr<content::VoxelModel>>;
+// programs can only be compiled with a graphics context, so they are preprocessed only
+using HeadlessProgram       = HeadlessContent<content::PreprocessedShader>;
+
+//----------------------------------------------------------------
+struct BenchmarkResult
+{
+    std::string         name            { };
+    // of the samples
+    std::string         unit            { };
+    std::vector<double> samples         { };
+    // the bytes read per sample, to compute the throughput, if any
+    uint64_t            n_bytes         { };
+
+    double get_mean() const
+    {
+        double sum { 0. };
+        for ( const auto sample : samples ) { sum += sample; }
+        return samples.empty() ? 0. : sum / samples.size();
+    }
+
+    double get_median() const
+    {
+        if ( samples.empty() ) { return 0.; }
+        auto sorted_samples = samples;
+        std::sort( sorted_samples.begin(), sorted_samples.end() );
+        return sorted_samples[ sorted_samples.size() / 2 ];
+    }
+
+    double get_min() const { return samples.empty() ? 0. : *std::min_element( samples.begin(), samples.end() ); }
+    double get_max() const { return samples.empty() ? 0. : *std::max_element( samples.begin(), samples.end() ); }
+
+    // only for results in milliseconds
+    double get_megabytes_per_second() const
+    {
+        const auto mean = get_mean();
+        return mean > 0. ? ( n_bytes / 1e6 ) / ( mean / 1e3 ) : 0.;
+    }
+
+    json11::Json to_json() const
+    {
+        auto json = json11::Json::object
+        {
+            { "name",       name                                },
+            { "unit",       unit                                },
+            { "iterations", static_cast<int>( samples.size() )  },
+            { "mean",       get_mean()                          },
+            { "median",     get_median()                        },
+            { "min",        get_min()                           },
+            { "max",        get_max()                           }
+        };
+        if ( n_bytes != 0 )
+        {
+            json[ "bytes" ]                 = static_cast<double>( n_bytes );
+            json[ "megabytes_per_second" ]  = get_megabytes_per_second();
+        }
+        return json;
+    }
+};
+
+//----------------------------------------------------------------
+template<typename Function_T>
+std::vector<double> measure_milliseconds( const std::size_t n_iterations, Function_T&& function )
+{
+    auto samples = std::vector<double> { };
+    samples.reserve( n_iterations );
+    for ( std::size_t iteration = 0; iteration < n_iterations; ++iteration )
+    {
+        const auto begin = Clock::now();
+        function();
+        samples.emplace_back( std::chrono::duration<double, std::milli> { Clock::now() - begin }.count() );
+    }
+    return samples;
+}
+
+//----------------------------------------------------------------
+std::unique_ptr<content::ContentManager> make_content_manager
+(
+    const io::Path&                 fixture_directory,
+    const std::optional<io::Path>&  cache_directory
+)
+{
+    auto content_manager = std::make_unique<content::ContentManager>();
+    content_manager->init();
+    content_manager->host_content_directory( fixture_directory );
+    if ( cache_directory ) { content_manager->set_cache_directory( *cache_directory ); }
+
+    namespace load = content::load;
+    content_manager->register_content_type<HeadlessTexture,       load::TextureData>                     ( load::decode_texture,              upload_headless<load::TextureData>                    );
+    content_manager->register_content_type<HeadlessCubeMap,       load::CubeMapData>                     ( load::decode_cube_map,             upload_headless<load::CubeMapData>                    );
+    content_manager->register_content_type<HeadlessFont,          load::FontData>                        ( load::decode_font,                 upload_headless<load::FontData>                       );
+    content_manager->register_content_type<HeadlessMaterial,      load::MaterialDescription>             ( load::decode_material_description, upload_headless<load::MaterialDescription>            );
+    content_manager->register_content_type<HeadlessVoxelModel,    std::shared_ptr<content::VoxelModel>>  ( load::decode_voxel_model,          upload_headless<std::shared_ptr<content::VoxelModel>> );
+    content_manager->register_content_type<HeadlessProgram,       content::PreprocessedShader>           ( load::preprocess_program,          upload_headless<content::PreprocessedShader>          );
+    return content_manager;
+}
+
+//----------------------------------------------------------------
+template<typename Content_T>
+void load_and_unload( content::ContentManager& content_manager, const io::Path& path )
+{
+    content_manager.get_or_load<Content_T>( path );
+    content_manager.unload<Content_T>( path );
+}
+
+//----------------------------------------------------------------
+std::function<void( content::ContentManager&, const io::Path& )> get_load_and_unload( const FixtureKind kind )
+{
+    switch ( kind )
+    {
+    case FixtureKind::Texture:      return load_and_unload<HeadlessTexture>;
+    case FixtureKind::CubeMap:      return load_and_unload<HeadlessCubeMap>;
+    case FixtureKind::Font:         return load_and_unload<HeadlessFont>;
+    case FixtureKind::Material:     return load_and_unload<HeadlessMaterial>;
+    case FixtureKind::VoxelModel:   return load_and_unload<HeadlessVoxelModel>;
+    }
+    CHECK_FAIL( "Unknown fixture kind." );
+    return { }; // to shut up warning
+}
+
+//----------------------------------------------------------------
+// Cold loads decode everything,
+// warm loads reuse derived data, such as decoded images, from a previous run,
+// and cooked loads read content that was decoded offline, such as .stex textures, without copying it.
+// Serial loads of cube maps decode their faces one after another, as a baseline for decoding them in parallel.
+// Files are read from the operating system's file cache in all cases.
+void run_load_benchmarks
+(
+    const std::vector<Fixture>&     fixtures,
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto cache_directory = fixture_directory / io::Path { "derived_data_cache" };
+    std::filesystem::remove_all( cache_directory.get_string() );
+
+    const auto cold_content_manager     = make_content_manager( fixture_directory, std::nullopt     );
+    const auto warm_content_manager     = make_content_manager( fixture_directory, cache_directory  );
+    const auto serial_content_manager   = make_content_manager( fixture_directory, std::nullopt     );
+    serial_content_manager->set_max_decode_concurrency( 1 );
+
+    for ( const auto& fixture : fixtures )
+    {
+        const auto load_and_unload_fixture = get_load_and_unload( fixture.kind );
+
+        // also fills the derived data cache of the warm loads
+        load_and_unload_fixture( *cold_content_manager, fixture.path );
+        load_and_unload_fixture( *warm_content_manager, fixture.path );
+
+        const auto measure = [ & ]( content::ContentManager& content_manager )
+        {
+            return measure_milliseconds( n_iterations, [ & ]() { load_and_unload_fixture( content_manager, fixture.path ); } );
+        };
+        results.emplace_back( BenchmarkResult { fixture.name + "/cold", "ms", measure( *cold_content_manager ), fixture.n_source_bytes } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/warm", "ms", measure( *warm_content_manager ), fixture.n_source_bytes } );
+
+        // of a single cold load, scratch arenas that overflow included
+        const auto n_heap_allocations_before = n_heap_allocations.load();
+        load_and_unload_fixture( *cold_content_manager, fixture.path );
+        const auto n_load_heap_allocations = static_cast<double>( n_heap_allocations.load() - n_heap_allocations_before );
+        results.emplace_back( BenchmarkResult { fixture.name + "/cold/heap_allocations", "allocations", { n_load_heap_allocations } } );
+
+        if ( fixture.kind == FixtureKind::CubeMap )
+        {
+            load_and_unload_fixture( *serial_content_manager, fixture.path );
+            results.emplace_back( BenchmarkResult { fixture.name + "/cold_serial", "ms", measure( *serial_content_manager ), fixture.n_source_bytes } );
+        }
+
+        if ( fixture.cooked_path )
+        {
+            load_and_unload_fixture( *cold_content_manager, *fixture.cooked_path );
+            const auto cooked_samples = measure_milliseconds( n_iterations, [ & ]() { load_and_unload_fixture( *cold_content_manager, *fixture.cooked_path ); } );
+            results.emplace_back( BenchmarkResult { fixture.name + "/cooked", "ms", cooked_samples, fixture.n_cooked_bytes } );
+        }
+    }
+
+    cold_content_manager->destroy();
+    warm_content_manager->destroy();
+    serial_content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// All textures and cube maps at once, decoded in parallel on the worker pool
+void run_async_benchmark
+(
+    const std::vector<Fixture>&     fixtures,
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto content_manager = make_content_manager( fixture_directory, std::nullopt );
+
+    uint64_t n_bytes { 0 };
+    for ( const auto& fixture : fixtures )
+    {
+        if ( fixture.kind == FixtureKind::Texture || fixture.kind == FixtureKind::CubeMap ) { n_bytes += fixture.n_source_bytes; }
+    }
+
+    const auto load_all = [ & ]()
+    {
+        auto texture_futures    = std::vector<content::ContentFuture<HeadlessTexture>> { };
+        auto cube_map_futures   = std::vector<content::ContentFuture<HeadlessCubeMap>> { };
+        for ( const auto& fixture : fixtures )
+        {
+            if ( fixture.kind == FixtureKind::Texture ) { texture_futures.emplace_back ( content_manager->preload_async<HeadlessTexture>( fixture.path ) ); }
+            if ( fixture.kind == FixtureKind::CubeMap ) { cube_map_futures.emplace_back( content_manager->preload_async<HeadlessCubeMap>( fixture.path ) ); }
+        }
+
+        const auto is_ready = []( const auto& future ) { return future.wait_for( std::chrono::seconds { 0 } ) == std::future_status::ready; };
+        while
+        (
+            !std::all_of( texture_futures.begin(),  texture_futures.end(),  is_ready )
+            || !std::all_of( cube_map_futures.begin(), cube_map_futures.end(), is_ready )
+        )
+        {
+            content_manager->process_uploads();
+        }
+
+        for ( const auto& fixture : fixtures )
+        {
+            if ( fixture.kind == FixtureKind::Texture ) { content_manager->unload<HeadlessTexture>( fixture.path ); }
+            if ( fixture.kind == FixtureKind::CubeMap ) { content_manager->unload<HeadlessCubeMap>( fixture.path ); }
+        }
+    };
+
+    load_all();
+    results.emplace_back( BenchmarkResult { "images/async", "ms", measure_milliseconds( n_iterations, load_all ), n_bytes } );
+    content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// The latency of getting cached content, by path and by id,
+// and of looking up synthetic entries in the maps from paths that content caches used to be,
+// next to the flat tables of ids that replaced them
+void run_cache_get_benchmarks
+(
+    const std::vector<Fixture>&     fixtures,
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto content_manager = make_content_manager( fixture_directory, std::nullopt );
+
+    // fill the cache with some content, so lookups don't hit an empty table
+    auto path = std::optional<io::Path> { };
+    for ( const auto& fixture : fixtures )
+    {
+        if ( fixture.kind != FixtureKind::Texture ) { continue; }
+        content_manager->get_or_load<HeadlessTexture>( fixture.path );
+        path = fixture.path;
+    }
+    CHECK( path.has_value(), "No texture fixtures to get." );
+
+    const auto id = content::ContentId { *path };
+    // keeps the gets from being optimized away
+    volatile uintptr_t sink { 0 };
+    const auto to_nanoseconds_per_get = []( const double milliseconds ) { return milliseconds * 1e6 / n_cache_gets; };
+
+    auto path_samples = measure_milliseconds( n_iterations, [ & ]()
+    {
+        for ( std::size_t get_index = 0; get_index < n_cache_gets; ++get_index ) { sink = sink + reinterpret_cast<uintptr_t>( content_manager->get<HeadlessTexture>( *path ).get() ); }
+    } );
+    auto id_samples = measure_milliseconds( n_iterations, [ & ]()
+    {
+        for ( std::size_t get_index = 0; get_index < n_cache_gets; ++get_index ) { sink = sink + reinterpret_cast<uintptr_t>( content_manager->get<HeadlessTexture>( id ).get() ); }
+    } );
+    std::transform( path_samples.begin(),   path_samples.end(), path_samples.begin(),   to_nanoseconds_per_get );
+    std::transform( id_samples.begin(),     id_samples.end(),   id_samples.begin(),     to_nanoseconds_per_get );
+
+    results.emplace_back( BenchmarkResult { "cache_get/path",   "ns", path_samples  } );
+    results.emplace_back( BenchmarkResult { "cache_get/id",     "ns", id_samples    } );
+    content_manager->destroy();
+
+    for ( const auto n_entries : cache_table_sizes )
+    {
+        auto paths  = std::vector<io::Path> { };
+        auto ids    = std::vector<content::ContentId> { };
+        auto map    = std::map<io::Path, uintptr_t> { };
+        auto table  = content::FlatContentTable<uintptr_t> { };
+        for ( std::size_t entry_index = 0; entry_index < n_entries; ++entry_index )
+        {
+            paths.emplace_back( "textures/synthetic_" + std::to_string( entry_index ) + ".json" );
+            ids.emplace_back( paths.back() );
+            map.emplace( paths.back(), entry_index );
+            table.emplace( ids.back(), entry_index );
+        }
+
+        // entries are visited out of order, as a prime stride visits every entry of a table of a power of ten
+        const auto get_entry_index = [ n_entries ]( const std::size_t get_index ) { return get_index * 7919 % n_entries; };
+        auto map_samples = measure_milliseconds( n_iterations, [ & ]()
+        {
+            for ( std::size_t get_index = 0; get_index < n_cache_gets; ++get_index ) { sink = sink + map.find( paths[ get_entry_index( get_index ) ] )->second; }
+        } );
+        auto table_samples = measure_milliseconds( n_iterations, [ & ]()
+        {
+            for ( std::size_t get_index = 0; get_index < n_cache_gets; ++get_index ) { sink = sink + *table.find( ids[ get_entry_index( get_index ) ] ); }
+        } );
+        std::transform( map_samples.begin(),    map_samples.end(),      map_samples.begin(),    to_nanoseconds_per_get );
+        std::transform( table_samples.begin(),  table_samples.end(),    table_samples.begin(),  to_nanoseconds_per_get );
+
+        const auto name = "cache_table/" + std::to_string( n_entries );
+        results.emplace_back( BenchmarkResult { name + "/map",          "ns", map_samples   } );
+        results.emplace_back( BenchmarkResult { name + "/flat_table",   "ns", table_samples } );
+    }
+}
+
+//----------------------------------------------------------------
+uint64_t get_directory_size( const io::Path& directory )
+{
+    uint64_t n_bytes { 0 };
+    for ( const auto& directory_entry : std::filesystem::recursive_directory_iterator( directory.get_string() ) )
+    {
+        if ( directory_entry.is_regular_file() ) { n_bytes += static_cast<uint64_t>( directory_entry.file_size() ); }
+    }
+    return n_bytes;
+}
+
+//----------------------------------------------------------------
+// Loading many small materials from json, and from the descriptors compiled from it.
+// The compiled descriptors are hosted before the json, as they would be in a shipped game.
+void run_descriptor_benchmarks
+(
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto json_directory       = fixture_directory / io::Path { "descriptors/json"     };
+    const auto compiled_directory   = fixture_directory / io::Path { "descriptors/compiled" };
+    std::filesystem::remove_all( json_directory.get_string()     );
+    std::filesystem::remove_all( compiled_directory.get_string() );
+
+    const auto paths = write_material_descriptors( json_directory, n_material_descriptors );
+    content::compile_descriptors( json_directory, compiled_directory );
+
+    const auto json_content_manager     = make_content_manager( json_directory,     std::nullopt );
+    const auto compiled_content_manager = make_content_manager( compiled_directory, std::nullopt );
+    compiled_content_manager->host_content_directory( json_directory );
+
+    const auto measure = [ & ]( content::ContentManager& content_manager )
+    {
+        const auto load_all = [ & ]()
+        {
+            for ( const auto& path : paths ) { load_and_unload<HeadlessMaterial>( content_manager, path ); }
+        };
+        load_all();
+        return measure_milliseconds( n_iterations, load_all );
+    };
+    const auto name = "material_descriptors/" + std::to_string( n_material_descriptors );
+    results.emplace_back( BenchmarkResult { name + "/json",     "ms", measure( *json_content_manager ),     get_directory_size( json_directory )        } );
+    results.emplace_back( BenchmarkResult { name + "/compiled", "ms", measure( *compiled_content_manager ), get_directory_size( compiled_directory )    } );
+
+    json_content_manager->destroy();
+    compiled_content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// Preprocesses a shader whose includes include each other, and fails if the result is not exactly as expected:
+// every file included once, the defines right after the #version directive,
+// and #line directives that point every line back into the file and line it came from
+void check_shader_preprocessor()
+{
+    const auto include_sources = std::map<std::string, std::string>
+    {
+        { "common.glsl",    "#include \"math.glsl\"\nfloat a;\n"      },
+        { "math.glsl",      "#include \"common.glsl\"\nfloat b;\n"    }
+    };
+    const auto read_include = [ & ]( const io::Path& path ) { return include_sources.at( path.get_string() ); };
+    const auto defines = content::ShaderDefines { { "MAX_LIGHTS", "8" }, { "SKINNED", "" } };
+
+    const auto shader = content::preprocess_shader
+    (
+        "#version 330 core\n"
+        "#include \"common.glsl\"\n"
+        "#include \"math.glsl\"\n"
+        "void main() {}\n",
+        defines,
+        read_include
+    );
+    const auto expected_source = std::string
+    {
+        "#version 330 core\n"
+        "#define MAX_LIGHTS 8\n"
+        "#define SKINNED\n"
+        "#line 2 0\n"
+        "#line 1 1\n"
+        "#line 1 2\n"
+        "\n"
+        "float b;\n"
+        "#line 2 1\n"
+        "float a;\n"
+        "#line 3 0\n"
+        "\n"
+        "void main() {}\n"
+    };
+    CHECK_EQ( shader.source, expected_source, "Shader preprocessor should expand includes once, and keep line numbers." );
+    CHECK( shader.included_paths.size() == 2 && shader.included_paths[ 0 ].get_string() == "common.glsl" && shader.included_paths[ 1 ].get_string() == "math.glsl", "Shader preprocessor should list includes in order of inclusion." );
+
+    // without a #version directive there is nothing to keep first
+    const auto versionless_shader = content::preprocess_shader( "void main() {}\n", defines, read_include );
+    CHECK_EQ( versionless_shader.source, std::string { "#define MAX_LIGHTS 8\n#define SKINNED\n#line 1 0\nvoid main() {}\n" }, "Shader preprocessor should define macros first without a #version directive." );
+
+    const auto variant_shader = content::preprocess_shader( "void main() {}\n", content::ShaderDefines { { "MAX_LIGHTS", "4" } }, read_include );
+    CHECK_NE( variant_shader.hash, versionless_shader.hash, "Shader variants should have different hashes." );
+    CHECK_EQ( content::preprocess_shader( "void main() {}\n", defines, read_include ).hash, versionless_shader.hash, "Equal shaders should have equal hashes." );
+}
+
+//----------------------------------------------------------------
+// Preprocessing programs with an increasing number of includes, and variants of them that define macros.
+// Throughput is relative to the preprocessed source, which holds every file that was read.
+void run_shader_program_benchmarks
+(
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto paths = write_shader_programs( fixture_directory );
+    const auto content_manager = make_content_manager( fixture_directory, std::nullopt );
+    for ( const auto& path : paths )
+    {
+        const auto file_path    = std::filesystem::path( path.get_string() );
+        const auto is_variant   = file_path.extension() == ".json";
+        const auto name         = "program/" + file_path.stem().string().substr( std::string { "program_" }.size() ) + ( is_variant ? "/variant" : "" );
+
+        const auto program = content_manager->get_or_load<HeadlessProgram>( path );
+        CHECK_GT( program->decoded.included_paths.size(), 0u, "Program should include its shared files." );
+        CHECK_EQ( program->decoded.source.rfind( is_variant ? "#version 330 core\n#define MAX_LIGHTS 8\n#define SKINNED 1\n#line 2 0\n" : "#version 330 core\n#line 2 0\n", 0 ), 0u, "Program variant should define its macros right after the #version directive." );
+        const auto n_source_bytes = program->decoded.source.size();
+        content_manager->unload<HeadlessProgram>( path );
+
+        const auto samples = measure_milliseconds( n_iterations, [ & ]() { load_and_unload<HeadlessProgram>( *content_manager, path ); } );
+        results.emplace_back( BenchmarkResult { name, "ms", samples, n_source_bytes } );
+    }
+    content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// Fails if the vertex cache miss ratio of meshes whose misses are known is off:
+// a triangle soup transforms every vertex of every triangle, and a quad shares two of its four vertices
+void check_vertex_cache_analysis()
+{
+    const auto soup_acmr = content::analyze_vertex_cache( { 0, 1, 2, 3, 4, 5 }, 6 ).acmr;
+    const auto quad_acmr = content::analyze_vertex_cache( { 0, 1, 2, 2, 1, 3 }, 4 ).acmr;
+    CHECK_EQ( soup_acmr, 3.f, "Triangle soup should transform three vertices per triangle." );
+    CHECK_EQ( quad_acmr, 2.f, "Quad should transform two vertices per triangle." );
+}
+
+//----------------------------------------------------------------
+// How far a level of detail of a unit sphere strays from the sphere,
+// sampled at the corners, edge midpoints and centroids of its triangles
+float get_max_sphere_deviation( const content::Mesh& mesh, const content::MeshLod& lod )
+{
+    auto max_deviation = 0.f;
+    for ( auto index = lod.first_index; index < lod.first_index + lod.n_indices; index += 3 )
+    {
+        const auto& a = mesh.positions[ mesh.indices[ index     ] ];
+        const auto& b = mesh.positions[ mesh.indices[ index + 1 ] ];
+        const auto& c = mesh.positions[ mesh.indices[ index + 2 ] ];
+        for ( const auto& point : { a, ( a + b ) * 0.5f, ( b + c ) * 0.5f, ( c + a ) * 0.5f, ( a + b + c ) * ( 1.f / 3.f ) } )
+        {
+            max_deviation = std::max( max_deviation, std::abs( 1.f - glm::length( point ) ) );
+        }
+    }
+    return max_deviation;
+}
+
+//----------------------------------------------------------------
+// Fails if a coarser level of detail of the mesh has as many triangles as a finer one, or a lower error,
+// or if select_mesh_lod picks a level whose error covers more than a pixel, or passes over one that covers less
+void check_mesh_lods( const content::Mesh& mesh )
+{
+    for ( std::size_t lod_index = 1; lod_index < mesh.lods.size(); ++lod_index )
+    {
+        const auto& lod         = mesh.lods[ lod_index ];
+        const auto& finer_lod   = mesh.lods[ lod_index - 1 ];
+        CHECK_LT( lod.n_indices,    finer_lod.n_indices,    "Coarser level of detail should have fewer triangles." );
+        CHECK_GE( lod.error,        finer_lod.error,        "Coarser level of detail should not have a lower error." );
+    }
+
+    // nothing of a mesh can be seen at no pixels per unit, and any error can be seen right in front of the camera
+    CHECK_EQ( content::select_mesh_lod( mesh, 0.f ), mesh.lods.size() - 1, "Mesh at no pixels per unit should use its coarsest level of detail." );
+    if ( mesh.lods.size() > 1 && mesh.lods[ 1 ].error > 0.f )
+    {
+        const auto pixels_per_unit = content::get_pixels_per_unit( 1e-3f * mesh.lods[ 1 ].error, 1.f, 1080.f );
+        CHECK_EQ( content::select_mesh_lod( mesh, pixels_per_unit ), 0, "Mesh right in front of the camera should use its full level of detail." );
+    }
+
+    for ( std::size_t lod_index = 1; lod_index < mesh.lods.size(); ++lod_index )
+    {
+        const auto error = mesh.lods[ lod_index ].error;
+        if ( error <= 0.f ) { continue; }
+        CHECK_GE( content::select_mesh_lod( mesh, 0.99f / error ), lod_index, "Level of detail whose error covers less than a pixel should be selected." );
+        CHECK_LT( content::select_mesh_lod( mesh, 1.01f / error ), lod_index, "Level of detail whose error covers more than a pixel should not be selected." );
+    }
+}
+
+//----------------------------------------------------------------
+// Fails if the coarse mesh does not hold exactly the levels of detail of the mesh,
+// starting at the finest one within the triangle budget of coarse meshes
+void check_coarse_mesh( const content::Mesh& mesh, const content::CoarseMesh& coarse_mesh )
+{
+    auto first_lod_index = mesh.lods.size() - 1;
+    for ( std::size_t lod_index = mesh.lods.size(); lod_index-- > 0; )
+    {
+        if ( mesh.lods[ lod_index ].n_indices / 3 <= content::load::coarse_mesh_max_n_triangles ) { first_lod_index = lod_index; }
+    }
+
+    CHECK_EQ( coarse_mesh.lods.size(), mesh.lods.size() - first_lod_index, "Coarse mesh should hold the coarse levels of detail only." );
+    for ( std::size_t lod_index = 0; lod_index < coarse_mesh.lods.size(); ++lod_index )
+    {
+        const auto& coarse_lod  = coarse_mesh.lods[ lod_index ];
+        const auto& lod         = mesh.lods[ first_lod_index + lod_index ];
+        CHECK( coarse_lod.n_indices == lod.n_indices && coarse_lod.n_vertices == lod.n_vertices && coarse_lod.error == lod.error, "Coarse mesh should hold the same levels of detail as the mesh." );
+
+        const auto coarse_indices = coarse_mesh.indices.begin() + coarse_lod.first_index;
+        CHECK( std::equal( coarse_indices, coarse_indices + coarse_lod.n_indices, mesh.indices.begin() + lod.first_index ), "Coarse mesh should hold the same triangles as the mesh." );
+    }
+}
+
+//----------------------------------------------------------------
+// Loading cooked meshes, with float and quantized attributes, in full or only their coarse levels of detail,
+// the vertex cache miss ratio of the meshes before and after optimizing them,
+// and the triangles and error of each level of detail, next to how far it actually strays from the sphere.
+// Before is after welding, as a triangle soup misses the cache on every vertex.
+// Checks the levels of detail of the meshes before and after cooking, and those of the coarse loads.
+void run_mesh_benchmarks
+(
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto obj_directory = fixture_directory / io::Path { "meshes/obj" };
+    std::filesystem::remove_all( ( fixture_directory / io::Path { "meshes" } ).get_string() );
+    const auto obj_paths = write_obj_meshes( obj_directory );
+
+    const auto attribute_formats = std::vector<std::pair<std::string, content::mesh_format::AttributeFormat>>
+    {
+        { "float",      content::mesh_format::AttributeFormat::Float        },
+        { "quantized",  content::mesh_format::AttributeFormat::Quantized    }
+    };
+
+    for ( const auto& obj_path : obj_paths )
+    {
+        const auto name = "mesh/" + std::filesystem::path( obj_path.get_string() ).stem().string();
+
+        auto obj_stream = std::ifstream( ( obj_directory / obj_path ).get_string(), std::ios::binary );
+        auto mesh = content::parse_obj( std::string( std::istreambuf_iterator<char>( obj_stream ), std::istreambuf_iterator<char>() ) );
+        content::weld_vertices( mesh );
+        const auto acmr_before = content::analyze_vertex_cache( mesh.indices, mesh.get_n_vertices() ).acmr;
+        content::generate_mesh_lods( mesh );
+        content::optimize_mesh( mesh );
+
+        const auto& full_lod = mesh.lods.front();
+        const auto full_indices = std::vector<uint32_t>( mesh.indices.begin() + full_lod.first_index, mesh.indices.begin() + full_lod.first_index + full_lod.n_indices );
+        const auto acmr_after = content::analyze_vertex_cache( full_indices, mesh.get_n_vertices() ).acmr;
+        results.emplace_back( BenchmarkResult { name + "/acmr_before",  "acmr", { acmr_before  } } );
+        results.emplace_back( BenchmarkResult { name + "/acmr_after",   "acmr", { acmr_after   } } );
+
+        for ( std::size_t lod_index = 0; lod_index < mesh.lods.size(); ++lod_index )
+        {
+            const auto& lod = mesh.lods[ lod_index ];
+            const auto lod_name = name + "/lod_" + std::to_string( lod_index );
+            results.emplace_back( BenchmarkResult { lod_name + "/triangles", "triangles",   { static_cast<double>( lod.n_indices / 3 )  } } );
+            results.emplace_back( BenchmarkResult { lod_name + "/error",     "units",       { lod.error                                 } } );
+            results.emplace_back( BenchmarkResult { lod_name + "/deviation", "units",       { get_max_sphere_deviation( mesh, lod )     } } );
+        }
+        check_mesh_lods( mesh );
+
+        for ( const auto& [ format_name, attribute_format ] : attribute_formats )
+        {
+            const auto cooked_directory = fixture_directory / io::Path { "meshes/" + format_name };
+            auto cooked_path = std::filesystem::path( obj_path.get_string() );
+            cooked_path.replace_extension( content::mesh_format::file_extension );
+            const auto path = io::Path { cooked_path.generic_string() };
+            content::cook_mesh( obj_directory, obj_path, cooked_directory / path, attribute_format );
+
+            const auto content_manager = make_content_manager( cooked_directory, std::nullopt );
+            {
+                const auto cooked_mesh = content_manager->get_or_load<content::Mesh>( path );
+                check_mesh_lods( *cooked_mesh );
+                check_coarse_mesh( *cooked_mesh, *content_manager->get_or_load<content::CoarseMesh>( path ) );
+                content_manager->unload<content::CoarseMesh>( path );
+                content_manager->unload<content::Mesh>( path );
+            }
+            const auto samples = measure_milliseconds( n_iterations, [ & ]() { load_and_unload<content::Mesh>( *content_manager, path ); } );
+            results.emplace_back( BenchmarkResult { name + "/" + format_name, "ms", samples, content::get_file_size( cooked_directory / path ) } );
+
+            // the throughput of a coarse load is relative to the whole file, which it stands in for until it is loaded
+            load_and_unload<content::CoarseMesh>( *content_manager, path );
+            const auto coarse_samples = measure_milliseconds( n_iterations, [ & ]() { load_and_unload<content::CoarseMesh>( *content_manager, path ); } );
+            results.emplace_back( BenchmarkResult { name + "/" + format_name + "/coarse", "ms", coarse_samples, content::get_file_size( cooked_directory / path ) } );
+            content_manager->destroy();
+        }
+    }
+}
+
+//----------------------------------------------------------------
+bool are_overlapping( const content::AtlasRect& a, const content::AtlasRect& b, const int padding )
+{
+    return a.x < b.x + b.width + padding && b.x < a.x + a.width + padding
+        && a.y < b.y + b.height + padding && b.y < a.y + a.height + padding;
+}
+
+//----------------------------------------------------------------
+// Fills a shelf packer with random rects until one does not fit,
+// and fails if a rect is placed outside of the packer, or closer than the padding to another rect
+void check_shelf_packer()
+{
+    constexpr auto size     = 64;
+    constexpr auto padding  = 1;
+    auto packer = content::ShelfPacker { size, size, padding };
+    auto random = std::mt19937 { 42 };
+
+    auto rects = std::vector<content::AtlasRect> { };
+    long long packed_area { 0 };
+    while ( true )
+    {
+        const auto width    = std::uniform_int_distribution<int> { 1, 12 }( random );
+        const auto height   = std::uniform_int_distribution<int> { 1, 12 }( random );
+        const auto rect     = packer.pack( width, height );
+        if ( !rect ) { break; }
+
+        CHECK( rect->width == width && rect->height == height, "Shelf packer changed the size of a rect." );
+        CHECK( rect->x >= 0 && rect->y >= 0 && rect->x + width <= size && rect->y + height <= size, "Shelf packer placed a rect outside of the atlas." );
+        for ( const auto& other_rect : rects ) { CHECK( !are_overlapping( *rect, other_rect, padding ), "Shelf packer placed rects closer than the padding." ); }
+        rects.emplace_back( *rect );
+        packed_area += static_cast<long long>( width ) * height;
+    }
+
+    CHECK( rects.size() > 1, "Shelf packer should fit more than a single rect." );
+    CHECK( std::abs( packer.get_occupancy() - static_cast<float>( packed_area ) / ( size * size ) ) < 1e-6f, "Shelf packer occupancy should be the packed fraction of the atlas." );
+    CHECK( !packer.pack( size + 1, 1 ).has_value(), "Shelf packer should not fit a rect that is wider than the atlas." );
+}
+
+//----------------------------------------------------------------
+// Fails if the atlas is not a power of two that is square or twice as high as it is wide,
+// or if a bitmap is not copied to its rect, or is closer than the padding to another one
+void check_glyph_atlas( const std::vector<content::load::Image>& bitmaps, const content::GlyphAtlas& atlas, const int padding )
+{
+    const auto& image = atlas.image;
+    CHECK( image.width > 0 && ( image.width & ( image.width - 1 ) ) == 0, "Glyph atlas width should be a power of two." );
+    CHECK( image.height == image.width || image.height == 2 * image.width, "Glyph atlas should be square, or twice as high as it is wide." );
+    CHECK( atlas.rects.size() == bitmaps.size() && atlas.uv_rects.size() == bitmaps.size(), "Glyph atlas should have a rect per bitmap." );
+
+    for ( std::size_t bitmap_index = 0; bitmap_index < bitmaps.size(); ++bitmap_index )
+    {
+        const auto& bitmap  = bitmaps[ bitmap_index ];
+        const auto& rect    = atlas.rects[ bitmap_index ];
+        const auto& uv_rect = atlas.uv_rects[ bitmap_index ];
+        CHECK( rect.width == bitmap.width && rect.height == bitmap.height, "Glyph atlas rect should be the size of its bitmap." );
+        CHECK( rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= image.width && rect.y + rect.height <= image.height, "Glyph atlas rect is outside of the atlas." );
+        CHECK( uv_rect.u_min * image.width == rect.x && uv_rect.v_max * image.height == rect.y + rect.height, "Glyph atlas uv rect should cover its rect." );
+        if ( bitmap.width == 0 || bitmap.height == 0 ) { continue; }
+
+        for ( int row = 0; row < rect.height; ++row )
+        {
+            const auto is_copied = std::equal
+            (
+                bitmap.pixels.get() + static_cast<std::size_t>( row ) * bitmap.width,
+                bitmap.pixels.get() + static_cast<std::size_t>( row + 1 ) * bitmap.width,
+                image.pixels.get() + static_cast<std::size_t>( rect.y + row ) * image.width + rect.x
+            );
+            CHECK( is_copied, "Glyph atlas should hold the pixels of its bitmaps." );
+        }
+        for ( std::size_t other_index = 0; other_index < bitmap_index; ++other_index )
+        {
+            const auto& other_rect = atlas.rects[ other_index ];
+            if ( other_rect.width == 0 || other_rect.height == 0 ) { continue; }
+            CHECK( !are_overlapping( rect, other_rect, padding ), "Glyph atlas rects are closer than the padding." );
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// Random bitmaps of about the size of glyphs, with every 32nd one empty, as a space is
+std::vector<content::load::Image> make_glyph_bitmaps( std::mt19937& random )
+{
+    auto bitmaps = std::vector<content::load::Image> { };
+    bitmaps.reserve( n_atlas_glyphs );
+    for ( std::size_t glyph_index = 0; glyph_index < n_atlas_glyphs; ++glyph_index )
+    {
+        const auto width    = glyph_index % 32 == 0 ? 0 : std::uniform_int_distribution<int> { 4, 24 }( random );
+        const auto height   = glyph_index % 32 == 0 ? 0 : std::uniform_int_distribution<int> { 4, 32 }( random );
+        auto pixels = std::vector<uint8_t>( static_cast<std::size_t>( width ) * height );
+        for ( auto& pixel : pixels ) { pixel = static_cast<uint8_t>( random() ); }
+        bitmaps.emplace_back( content::load::make_image( std::move( pixels ), width, height, 1 ) );
+    }
+    return bitmaps;
+}
+
+//----------------------------------------------------------------
+// Checks the shelf packer and glyph atlas packing, without a graphics context,
+// and measures packing random glyph bitmaps.
+// Of the font fixtures, reports the occupancy of their atlases, 
+// and the time packing takes out of their loads, compared to uploading every glyph as a texture of its own.
+// That takes as many uploads as the font has glyphs that are not empty, instead of one.
+void run_glyph_atlas_benchmarks
+(
+    const std::vector<Fixture>&     fixtures,
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    constexpr auto padding = 1;
+    check_shelf_packer();
+
+    auto random = std::mt19937 { 42 };
+    const auto bitmaps = make_glyph_bitmaps( random );
+    auto atlas = content::GlyphAtlas { };
+    const auto samples = measure_milliseconds( n_iterations, [ & ]() { atlas = content::pack_glyph_atlas( bitmaps, padding ); } );
+    check_glyph_atlas( bitmaps, atlas, padding );
+
+    const auto name = "glyph_atlas/" + std::to_string( n_atlas_glyphs );
+    results.emplace_back( BenchmarkResult { name + "/pack",         "ms",       samples                 } );
+    results.emplace_back( BenchmarkResult { name + "/occupancy",    "fraction", { atlas.occupancy }     } );
+
+    const auto content_manager = make_content_manager( fixture_directory, std::nullopt );
+    for ( const auto& fixture : fixtures )
+    {
+        if ( fixture.kind != FixtureKind::Font ) { continue; }
+
+        const auto font_data = content_manager->get_or_load<HeadlessFont>( fixture.path )->decoded;
+        content_manager->unload<HeadlessFont>( fixture.path );
+
+        // glyph bitmaps only keep their size once they are packed, so pack blank ones of the same size
+        auto font_bitmaps = std::vector<content::load::Image> { };
+        for ( const auto& glyph_bitmaps : font_data.faces )
+        {
+            for ( const auto& glyph_bitmap : glyph_bitmaps )
+            {
+                const auto& glyph_image = glyph_bitmap.image;
+                auto pixels = std::vector<uint8_t>( static_cast<std::size_t>( glyph_image.width ) * glyph_image.height );
+                font_bitmaps.emplace_back( content::load::make_image( std::move( pixels ), glyph_image.width, glyph_image.height, 1 ) );
+            }
+        }
+        const auto n_glyph_textures = std::count_if( font_bitmaps.begin(), font_bitmaps.end(), []( const auto& bitmap ) { return bitmap.width > 0 && bitmap.height > 0; } );
+        const auto pack_samples = measure_milliseconds( n_iterations, [ & ]() { content::pack_glyph_atlas( font_bitmaps, padding ); } );
+
+        results.emplace_back( BenchmarkResult { fixture.name + "/atlas/pack",           "ms",       pack_samples                                        } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/atlas/occupancy",      "fraction", { font_data.atlas.occupancy                     }   } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/atlas/textures",       "textures", { 1.                                            }   } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/per_glyph/textures",   "textures", { static_cast<double>( n_glyph_textures )      }   } );
+    }
+    content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// Builds .vox files chunk by chunk, with the content of each chunk given as 32 bit words,
+// to parse files that the fixtures don't cover
+class VoxFileBuilder
+{
+public:
+    VoxFileBuilder& add_chunk( const char ( &id )[ 5 ], const std::vector<uint32_t>& content )
+    {
+        m_chunks.insert( m_chunks.end(), id, id + 4 );
+        append_words( m_chunks, { static_cast<uint32_t>( content.size() * sizeof( uint32_t ) ), 0 } );
+        append_words( m_chunks, content );
+        return *this;
+    }
+
+    std::vector<uint8_t> build() const
+    {
+        auto bytes = std::vector<uint8_t> { 'V', 'O', 'X', ' ' };
+        append_words( bytes, { 150 } );
+        bytes.insert( bytes.end(), { 'M', 'A', 'I', 'N' } );
+        append_words( bytes, { 0, static_cast<uint32_t>( m_chunks.size() ) } );
+        bytes.insert( bytes.end(), m_chunks.begin(), m_chunks.end() );
+        return bytes;
+    }
+
+    static uint32_t make_voxel( const uint8_t x, const uint8_t y, const uint8_t z, const uint8_t color_index )
+    {
+        return x | ( y << 8 ) | ( z << 16 ) | ( static_cast<uint32_t>( color_index ) << 24 );
+    }
+
+private:
+    static void append_words( std::vector<uint8_t>& bytes, const std::vector<uint32_t>& words )
+    {
+        const auto word_bytes = reinterpret_cast<const uint8_t*>( words.data() );
+        bytes.insert( bytes.end(), word_bytes, word_bytes + words.size() * sizeof( uint32_t ) );
+    }
+
+private:
+    std::vector<uint8_t> m_chunks { };
+};
+
+//----------------------------------------------------------------
+// Parses synthetic .vox files: a PACK of several models, a file without a palette,
+// chunks in an unexpected order, and every truncation of a valid file,
+// and fails if the parser does not read the first two as written, or accepts any of the others
+void check_voxel_model_parser()
+{
+    const auto parse = []( std::vector<uint8_t> bytes ) { return content::load::parse_voxel_model( content::ContentBytes::make_owning( std::move( bytes ) ) ); };
+    const auto fails_to_parse = [ & ]( const std::vector<uint8_t>& bytes )
+    {
+        try                 { parse( bytes ); }
+        catch ( ... )       { return true; }
+        return false;
+    };
+
+    auto palette_words = std::vector<uint32_t>( 256 );
+    for ( uint32_t color_index = 0; color_index < palette_words.size(); ++color_index ) { palette_words[ color_index ] = 0xff000000 | color_index; }
+
+    // chunks that the parser does not read, such as those of the scene graph, are skipped
+    const auto pack_bytes = VoxFileBuilder { }
+        .add_chunk( "PACK", { 2 } )
+        .add_chunk( "SIZE", { 2, 2, 2 } )
+        .add_chunk( "XYZI", { 1, VoxFileBuilder::make_voxel( 1, 1, 1, 5 ) } )
+        .add_chunk( "nTRN", { 0, 0, 0 } )
+        .add_chunk( "SIZE", { 4, 3, 2 } )
+        .add_chunk( "XYZI", { 2, VoxFileBuilder::make_voxel( 3, 2, 1, 7 ), VoxFileBuilder::make_voxel( 0, 0, 0, 9 ) } )
+        .add_chunk( "RGBA", palette_words )
+        .build();
+    const auto pack_model = parse( pack_bytes );
+    CHECK_EQ( pack_model.chunks.size(), 2, "Vox parser should read every model of a PACK." );
+    CHECK( pack_model.chunks[ 0 ].size == glm::ivec3( 2, 2, 2 ) && pack_model.chunks[ 1 ].size == glm::ivec3( 4, 3, 2 ), "Vox parser should read the size of every model." );
+    CHECK( pack_model.chunks[ 0 ].voxels.size() == 1 && pack_model.chunks[ 1 ].voxels.size() == 2, "Vox parser should read the voxels of every model." );
+    const auto& voxel = pack_model.chunks[ 1 ].voxels[ 0 ];
+    CHECK( voxel.x == 3 && voxel.y == 2 && voxel.z == 1 && voxel.color_index == 7, "Vox parser should read voxels as written." );
+    // colors of the chunk are shifted up by one, as index 0 is empty
+    CHECK( pack_model.palette[ 0 ] == 0 && pack_model.palette[ 1 ] == palette_words[ 0 ] && pack_model.palette[ 255 ] == palette_words[ 254 ], "Vox parser should read the palette as written." );
+
+    const auto no_palette_bytes = VoxFileBuilder { }
+        .add_chunk( "SIZE", { 1, 1, 1 } )
+        .add_chunk( "XYZI", { 1, VoxFileBuilder::make_voxel( 0, 0, 0, 1 ) } )
+        .build();
+    const auto no_palette_model = parse( no_palette_bytes );
+    const auto no_palette = content::load::parse_voxel_palette( content::ContentBytes::make_owning( std::vector<uint8_t> { no_palette_bytes } ) );
+    CHECK( no_palette_model.chunks.size() == 1 && no_palette_model.palette == no_palette, "Vox parser should read a file without an RGBA chunk." );
+    CHECK( no_palette[ 0 ] == 0 && no_palette[ 1 ] == 0xffffffff, "Vox file without an RGBA chunk should have the default palette." );
+
+    // the count of a PACK chunk is only a hint, and must not make the parser reserve room for it
+    const auto overcounted_pack_bytes = VoxFileBuilder { }
+        .add_chunk( "PACK", { 0xffffffff } )
+        .add_chunk( "SIZE", { 1, 1, 1 } )
+        .add_chunk( "XYZI", { 1, VoxFileBuilder::make_voxel( 0, 0, 0, 1 ) } )
+        .build();
+    CHECK_EQ( parse( overcounted_pack_bytes ).chunks.size(), 1, "Vox parser should read the models of a PACK with a corrupt count." );
+
+    const auto is_rejected = std::vector<bool>
+    {
+        fails_to_parse( VoxFileBuilder { }.add_chunk( "XYZI", { 0 } ).add_chunk( "SIZE", { 1, 1, 1 } ).build() ),
+        fails_to_parse( VoxFileBuilder { }.add_chunk( "SIZE", { 1, 1, 1 } ).add_chunk( "XYZI", { 0 } ).add_chunk( "XYZI", { 0 } ).build() ),
+        fails_to_parse( VoxFileBuilder { }.add_chunk( "SIZE", { 1, 1, 1 } ).build() ),
+        fails_to_parse( VoxFileBuilder { }.add_chunk( "SIZE", { 1, 1, 1 } ).add_chunk( "XYZI", { 1, VoxFileBuilder::make_voxel( 1, 0, 0, 1 ) } ).build() ),
+        fails_to_parse( VoxFileBuilder { }.add_chunk( "SIZE", { 1, 1, 1 } ).add_chunk( "XYZI", { 2, VoxFileBuilder::make_voxel( 0, 0, 0, 1 ) } ).build() )
+    };
+    CHECK( std::all_of( is_rejected.begin(), is_rejected.end(), []( const bool is_rejected ) { return is_rejected; } ), "Vox parser should reject a model that is not a SIZE chunk followed by a matching XYZI chunk." );
+
+    for ( std::size_t n_bytes = 0; n_bytes < pack_bytes.size(); ++n_bytes )
+    {
+        CHECK( fails_to_parse( std::vector<uint8_t>( pack_bytes.begin(), pack_bytes.begin() + n_bytes ) ), "Vox parser should reject a truncated file." );
+    }
+}
+
+//----------------------------------------------------------------
+// Meshing the voxel model fixtures on the worker pool,
+// and the triangles of the meshes next to those of drawing every voxel as an instanced cube.
+// Fails if meshing does not save triangles, which it should for spheres.
+void run_voxel_mesh_benchmarks
+(
+    const std::vector<Fixture>&     fixtures,
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto content_manager = make_content_manager( fixture_directory, std::nullopt );
+
+    for ( const auto& fixture : fixtures )
+    {
+        if ( fixture.kind != FixtureKind::VoxelModel ) { continue; }
+
+        const auto voxel_model = content_manager->get_or_load<HeadlessVoxelModel>( fixture.path )->decoded;
+        content_manager->unload<HeadlessVoxelModel>( fixture.path );
+
+        auto voxel_mesh = content::VoxelMesh { };
+        const auto samples = measure_milliseconds( n_iterations, [ & ]() { voxel_mesh = content::load::make_voxel_mesh( content_manager.get(), *voxel_model ); } );
+
+        const auto n_mesh_triangles             = voxel_mesh.get_n_triangles();
+        const auto n_instanced_cube_triangles   = content::get_n_instanced_cube_triangles( *voxel_model );
+        CHECK_LT( n_mesh_triangles, n_instanced_cube_triangles, "Voxel mesh should have fewer triangles than instanced cubes." );
+
+        results.emplace_back( BenchmarkResult { fixture.name + "/mesh",                         "ms",           samples                                                     } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/mesh/triangles",               "triangles",    { static_cast<double>( n_mesh_triangles )               }   } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/instanced_cubes/triangles",    "triangles",    { static_cast<double>( n_instanced_cube_triangles )     }   } );
+    }
+
+    content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// Steps through every voxel along the ray, as by Amanatides and Woo, without skipping empty space,
+// as the baseline for the raycasts of a brick map
+std::optional<content::VoxelRayHit> raycast_dense_voxel_grid( const content::DenseVoxelGrid& grid, const glm::vec3& origin, const glm::vec3& direction )
+{
+    auto t_enter    = 0.f;
+    auto t_exit     = std::numeric_limits<float>::max();
+    auto axis       = -1;
+    for ( int i = 0; i < 3; ++i )
+    {
+        if ( direction[ i ] == 0.f )
+        {
+            if ( origin[ i ] < 0.f || origin[ i ] >= static_cast<float>( grid.size[ i ] ) ) { return std::nullopt; }
+            continue;
+        }
+
+        auto t_near = ( 0.f - origin[ i ] ) / direction[ i ];
+        auto t_far  = ( static_cast<float>( grid.size[ i ] ) - origin[ i ] ) / direction[ i ];
+        if ( t_near > t_far ) { std::swap( t_near, t_far ); }
+        if ( t_near > t_enter )
+        {
+            t_enter = t_near;
+            axis    = i;
+        }
+        t_exit = std::min( t_exit, t_far );
+    }
+    if ( t_enter > t_exit ) { return std::nullopt; }
+
+    auto cell       = glm::ivec3 { };
+    auto step       = glm::ivec3 { };
+    auto t_max      = glm::vec3 { };
+    auto t_delta    = glm::vec3 { };
+    for ( int i = 0; i < 3; ++i )
+    {
+        cell[ i ] = std::clamp( static_cast<int>( std::floor( origin[ i ] + direction[ i ] * t_enter ) ), 0, grid.size[ i ] - 1 );
+        step[ i ] = direction[ i ] > 0.f ? 1 : ( direction[ i ] < 0.f ? -1 : 0 );
+        t_max[ i ]      = step[ i ] == 0 ? std::numeric_limits<float>::max() : ( static_cast<float>( cell[ i ] + ( step[ i ] > 0 ? 1 : 0 ) ) - origin[ i ] ) / direction[ i ];
+        t_delta[ i ]    = step[ i ] == 0 ? std::numeric_limits<float>::max() : 1.f / std::abs( direction[ i ] );
+    }
+
+    const auto is_within = [ & ]() 
+    { 
+        return cell.x >= 0 && cell.y >= 0 && cell.z >= 0 && cell.x < grid.size.x && cell.y < grid.size.y && cell.z < grid.size.z; 
+    };
+    for ( auto t = t_enter; t <= t_exit && is_within(); )
+    {
+        if ( const auto color_index = grid.color_indices[ grid.get_index( cell.x, cell.y, cell.z ) ] )
+        {
+            auto normal = glm::ivec3 { 0 };
+            if ( axis >= 0 ) { normal[ axis ] = -step[ axis ]; }
+            return content::VoxelRayHit { cell, normal, t, color_index };
+        }
+
+        axis = t_max.x < t_max.y
+            ? ( t_max.x < t_max.z ? 0 : 2 )
+            : ( t_max.y < t_max.z ? 1 : 2 );
+        t = t_max[ axis ];
+        cell[ axis ]  += step[ axis ];
+        t_max[ axis ] += t_delta[ axis ];
+    }
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+// How far the ray runs within the voxel, in multiples of its direction, negative if it misses the voxel.
+// In double precision, to tell rays that pass through a voxel from rays that only graze its edges or corners.
+double get_ray_voxel_overlap( const glm::vec3& origin, const glm::vec3& direction, const glm::ivec3& voxel )
+{
+    auto t_enter    = std::numeric_limits<double>::lowest();
+    auto t_exit     = std::numeric_limits<double>::max();
+    for ( int i = 0; i < 3; ++i )
+    {
+        if ( direction[ i ] == 0.f ) { continue; }
+        const auto t_a = ( voxel[ i ]     - static_cast<double>( origin[ i ] ) ) / direction[ i ];
+        const auto t_b = ( voxel[ i ] + 1 - static_cast<double>( origin[ i ] ) ) / direction[ i ];
+        t_enter = std::max( t_enter,    std::min( t_a, t_b ) );
+        t_exit  = std::min( t_exit,     std::max( t_a, t_b ) );
+    }
+    return t_exit - t_enter;
+}
+
+//----------------------------------------------------------------
+// Point queries and raycasts of the voxel model fixtures as brick maps, next to dense grids.
+// Points are spread over and just outside the model, rays start around it and aim at a point within it.
+// Fails if the brick map and the dense grid disagree on a query,
+// except on rays that graze a voxel, which rounding might let pass through either.
+void run_voxel_query_benchmarks
+(
+    const std::vector<Fixture>&     fixtures,
+    const io::Path&                 fixture_directory,
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto content_manager = make_content_manager( fixture_directory, std::nullopt );
+
+    for ( const auto& fixture : fixtures )
+    {
+        if ( fixture.kind != FixtureKind::VoxelModel ) { continue; }
+
+        const auto voxel_model  = content_manager->get_or_load<HeadlessVoxelModel>( fixture.path )->decoded;
+        const auto& voxel_chunk = voxel_model->chunks.front();
+        const auto brick_map    = content::VoxelBrickMap { voxel_chunk };
+        const auto dense_grid   = content::make_dense_voxel_grid( voxel_chunk );
+        content_manager->unload<HeadlessVoxelModel>( fixture.path );
+
+        auto random = std::mt19937 { 42 };
+        const auto size = glm::vec3 { voxel_chunk.size.x, voxel_chunk.size.y, voxel_chunk.size.z };
+        const auto get_random_point = [ & ]( const float margin )
+        {
+            auto point = glm::vec3 { };
+            for ( int i = 0; i < 3; ++i ) { point[ i ] = std::uniform_real_distribution<float> { -margin, size[ i ] + margin }( random ); }
+            return point;
+        };
+
+        auto positions = std::vector<glm::ivec3> { };
+        positions.reserve( n_voxel_queries );
+        for ( std::size_t query_index = 0; query_index < n_voxel_queries; ++query_index )
+        {
+            const auto point = get_random_point( 1.f );
+            positions.emplace_back( static_cast<int>( std::floor( point.x ) ), static_cast<int>( std::floor( point.y ) ), static_cast<int>( std::floor( point.z ) ) );
+        }
+
+        auto rays = std::vector<std::pair<glm::vec3, glm::vec3>> { };
+        rays.reserve( n_voxel_raycasts );
+        for ( std::size_t ray_index = 0; ray_index < n_voxel_raycasts; ++ray_index )
+        {
+            const auto origin = get_random_point( size.x );
+            rays.emplace_back( origin, get_random_point( 0.f ) - origin );
+        }
+
+        for ( const auto& position : positions )
+        {
+            CHECK_EQ( brick_map.get_color_index( position ), dense_grid.get_color_index( position ), "Brick map and dense grid disagree on a voxel." );
+        }
+        for ( const auto& [ origin, direction ] : rays )
+        {
+            const auto brick_map_hit    = brick_map.raycast( origin, direction );
+            const auto dense_grid_hit   = raycast_dense_voxel_grid( dense_grid, origin, direction );
+            const auto is_same_hit      = brick_map_hit && dense_grid_hit 
+                ? brick_map_hit->position == dense_grid_hit->position 
+                : brick_map_hit.has_value() == dense_grid_hit.has_value();
+            if ( is_same_hit )
+            {
+                CHECK( !brick_map_hit || brick_map_hit->color_index == dense_grid_hit->color_index, "Brick map and dense grid disagree on the color a ray hits." );
+                continue;
+            }
+
+            // one of them hit a voxel that the other stepped past
+            const auto is_graze = [ & ]( const std::optional<content::VoxelRayHit>& hit ) 
+            { 
+                return hit && get_ray_voxel_overlap( origin, direction, hit->position ) * glm::length( direction ) < 1e-3; 
+            };
+            CHECK( is_graze( brick_map_hit ) || is_graze( dense_grid_hit ), "Brick map and dense grid disagree on the voxel a ray hits." );
+        }
+
+        // keeps the queries from being optimized away
+        volatile uintptr_t sink { 0 };
+        const auto measure_nanoseconds_per_query = [ & ]( const std::size_t n_queries, const auto& query )
+        {
+            auto samples = measure_milliseconds( n_iterations, query );
+            std::transform( samples.begin(), samples.end(), samples.begin(), [ n_queries ]( const double milliseconds ) { return milliseconds * 1e6 / n_queries; } );
+            return samples;
+        };
+        const auto get_samples = [ & ]( const auto& voxels )
+        {
+            return measure_nanoseconds_per_query( n_voxel_queries, [ & ]()
+            {
+                for ( const auto& position : positions ) { sink = sink + voxels.get_color_index( position ); }
+            } );
+        };
+        const auto raycast_samples = [ & ]( const auto& raycast )
+        {
+            return measure_nanoseconds_per_query( n_voxel_raycasts, [ & ]()
+            {
+                for ( const auto& [ origin, direction ] : rays ) { sink = sink + ( raycast( origin, direction ) ? 1 : 0 ); }
+            } );
+        };
+        const auto raycast_brick_map    = [ & ]( const glm::vec3& origin, const glm::vec3& direction ) { return brick_map.raycast( origin, direction ); };
+        const auto raycast_dense_grid   = [ & ]( const glm::vec3& origin, const glm::vec3& direction ) { return raycast_dense_voxel_grid( dense_grid, origin, direction ); };
+
+        results.emplace_back( BenchmarkResult { fixture.name + "/get/brick_map",        "ns",       get_samples( brick_map )                                        } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/get/dense",            "ns",       get_samples( dense_grid )                                       } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/raycast/brick_map",    "ns",       raycast_samples( raycast_brick_map )                            } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/raycast/dense",        "ns",       raycast_samples( raycast_dense_grid )                           } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/bytes/brick_map",      "bytes",    { static_cast<double>( brick_map.get_n_bytes() )            }   } );
+        results.emplace_back( BenchmarkResult { fixture.name + "/bytes/dense",          "bytes",    { static_cast<double>( dense_grid.color_indices.size() )    }   } );
+    }
+
+    content_manager->destroy();
+}
+
+//----------------------------------------------------------------
+// Making a signed distance field from the coverage of a disc, which has a known distance everywhere,
+// and how far the distances read back from the field are from the exact ones.
+// Fails if a distance has the wrong sign, or is off by more than a quarter of a pixel of the field.
+void run_signed_distance_field_benchmarks
+(
+    const std::size_t               n_iterations,
+    std::vector<BenchmarkResult>&   results
+)
+{
+    const auto center = sdf_coverage_size / 2.f;
+    const auto radius = sdf_coverage_size * 0.375f;
+    auto coverage_pixels = std::vector<uint8_t>( static_cast<std::size_t>( sdf_coverage_size ) * sdf_coverage_size );
+    for ( int y = 0; y < sdf_coverage_size; ++y )
+    {
+        for ( int x = 0; x < sdf_coverage_size; ++x )
+        {
+            const auto is_inside = std::hypot( x + 0.5f - center, y + 0.5f - center ) <= radius;
+            coverage_pixels[ static_cast<std::size_t>( y ) * sdf_coverage_size + x ] = is_inside ? 255 : 0;
+        }
+    }
+    const auto coverage = content::load::make_image( std::move( coverage_pixels ), sdf_coverage_size, sdf_coverage_size, 1 );
+
+    auto field = content::load::Image { };
+    const auto samples = measure_milliseconds( n_iterations, [ & ]() { field = content::make_signed_distance_field( coverage, sdf_spread, sdf_downscale ); } );
+
+    const auto get_value = [ & ]( const int field_x, const int field_y ) { return field.pixels.get()[ static_cast<std::size_t>( field_y ) * field.width + field_x ]; };
+    // the field stores [ -spread, spread ] as [ 0, 255 ], with the inside brighter
+    const auto get_distance = [ & ]( const int field_x, const int field_y ) { return ( static_cast<float>( get_value( field_x, field_y ) ) - 128.f ) * sdf_spread / 127.f; };
+    CHECK( get_value( field.width / 2, field.height / 2 ) == 255, "Center of the disc should be as far inside as the field stores." );
+    CHECK( get_value( 0, 0 ) == 0, "Corner of the field should be as far outside as the field stores." );
+
+    // pixels further from the edge than the spread are clamped
+    const auto padding = sdf_spread * sdf_downscale;
+    auto max_error  = 0.f;
+    auto sum_error  = 0.f;
+    std::size_t n_compared_pixels { 0 };
+    for ( int field_y = 0; field_y < field.height; ++field_y )
+    {
+        for ( int field_x = 0; field_x < field.width; ++field_x )
+        {
+            const auto x = ( field_x + 0.5f ) * sdf_downscale - padding;
+            const auto y = ( field_y + 0.5f ) * sdf_downscale - padding;
+            const auto exact_distance = ( radius - std::hypot( x - center, y - center ) ) / sdf_downscale;
+            if ( std::abs( exact_distance ) >= sdf_spread - 1 ) { continue; }
+
+            const auto distance = get_distance( field_x, field_y );
+            CHECK( std::abs( exact_distance ) < 0.5f || ( distance > 0.f ) == ( exact_distance > 0.f ), "Signed distance field has the wrong sign." );
+            max_error = std::max( max_error, std::abs( distance - exact_distance ) );
+            sum_error += std::abs( distance - exact_distance );
+            ++n_compared_pixels;
+        }
+    }
+    CHECK_LT( max_error, 0.25f, "Signed distance field is too far off the exact distance." );
+
+    const auto name = "sdf/" + std::to_string( sdf_coverage_size );
+    // the throughput is of coverage pixels
+    results.emplace_back( BenchmarkResult { name,                   "ms",       samples, static_cast<uint64_t>( coverage.width ) * coverage.height } );
+    results.emplace_back( BenchmarkResult { name + "/max_error",    "pixels",   { max_error                         } } );
+    results.emplace_back( BenchmarkResult { name + "/mean_error",   "pixels",   { sum_error / n_compared_pixels     } } );
+}
+
+//----------------------------------------------------------------
+std::optional<io::Path> find_default_font_file()
+{
+    for ( const auto& font_file_path : default_font_file_paths )
+    {
+        if ( std::filesystem::exists( font_file_path ) ) { return io::Path { font_file_path }; }
+    }
+    return std::nullopt;
+}
+
+//----------------------------------------------------------------
+void print_result( const BenchmarkResult& result )
+{
+    std::cout
+        << std::left << std::setw( 36 ) << result.name << std::right << std::fixed << std::setprecision( 3 )
+        << std::setw( 12 ) << result.get_median() << " " << result.unit << " median"
+        << std::setw( 12 ) << result.get_min()    << " " << result.unit << " min";
+    if ( result.n_bytes != 0 ) { std::cout << std::setw( 12 ) << result.get_megabytes_per_second() << " MB/s"; }
+    std::cout << "\n";
+}
+
+//----------------------------------------------------------------
+int print_usage()
+{
+    std::cout
+        << "usage:\n"
+        << "    shake_content_benchmark <fixture_directory> [--iterations <n>] [--output <results.json>] [--font <font.ttf>]\n"
+        << "Writes synthetic content to the fixture directory, and measures loading it.\n"
+        << "Results are written as json, by default to results.json in the fixture directory.\n";
+    return 1;
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+int run( int argc, char* argv[] )
+{
+    if ( argc < 2 ) { return print_usage(); }
+
+    const auto fixture_directory    = io::Path { argv[ 1 ] };
+    auto n_iterations               = default_n_iterations;
+    auto output_path                = fixture_directory / io::Path { "results.json" };
+    auto font_file_path             = find_default_font_file();
+
+    // options come in pairs
+    if ( argc % 2 != 0 ) { return print_usage(); }
+    for ( int arg_index = 2; arg_index + 1 < argc; arg_index += 2 )
+    {
+        const auto option = std::string { argv[ arg_index ] };
+        const auto value  = std::string { argv[ arg_index + 1 ] };
+        if      ( option == "--iterations"  ) { n_iterations    = static_cast<std::size_t>( std::stoul( value ) ); }
+        else if ( option == "--output"      ) { output_path     = io::Path { value }; }
+        else if ( option == "--font"        ) { font_file_path  = io::Path { value }; }
+        else                                  { return print_usage(); }
+    }
+
+    const auto fixtures = write_fixtures( fixture_directory, font_file_path );
+    if ( !font_file_path ) { std::cout << "No font file found, skipping fonts. Pass one using --font.\n"; }
+
+    // checks that don't need fixtures, and fail before any time is spent measuring
+    check_voxel_model_parser();
+    check_shader_preprocessor();
+    check_vertex_cache_analysis();
+
+    auto results = std::vector<BenchmarkResult> { };
+    run_load_benchmarks                 ( fixtures, fixture_directory, n_iterations, results );
+    run_async_benchmark                 ( fixtures, fixture_directory, n_iterations, results );
+    run_cache_get_benchmarks            ( fixtures, fixture_directory, n_iterations, results );
+    run_descriptor_benchmarks           ( fixture_directory, n_iterations, results );
+    run_mesh_benchmarks                 ( fixture_directory, n_iterations, results );
+    run_shader_program_benchmarks       ( fixture_directory, n_iterations, results );
+    run_glyph_atlas_benchmarks          ( fixtures, fixture_directory, n_iterations, results );
+    run_voxel_mesh_benchmarks           ( fixtures, fixture_directory, n_iterations, results );
+    run_voxel_query_benchmarks          ( fixtures, fixture_directory, n_iterations, results );
+    run_signed_distance_field_benchmarks( n_iterations, results );
+
+    auto results_json = json11::Json::array { };
+    for ( const auto& result : results )
+    {
+        print_result( result );
+        results_json.emplace_back( result.to_json() );
+    }
+
+    // loads whose files did not fit the scratch arenas of their threads
+    const auto scratch_statistics = content::get_scratch_statistics();
+    std::cout
+        << "Scratch: " << scratch_statistics.n_scopes << " scopes, " << scratch_statistics.n_overflowing_scopes << " overflowed their arena, "
+        << scratch_statistics.n_overflow_allocations << " allocations passed on to the heap in total\n";
+
+    const auto scratch_json = json11::Json::object
+    {
+        { "n_scopes",                       static_cast<double>( scratch_statistics.n_scopes                        ) },
+        { "n_overflowing_scopes",           static_cast<double>( scratch_statistics.n_overflowing_scopes            ) },
+        { "n_allocations",                  static_cast<double>( scratch_statistics.n_allocations                   ) },
+        { "n_overflow_allocations",         static_cast<double>( scratch_statistics.n_overflow_allocations          ) },
+        { "n_overflow_bytes",               static_cast<double>( scratch_statistics.n_overflow_bytes                ) },
+        { "max_n_bytes_per_scope",          static_cast<double>( scratch_statistics.max_n_bytes_per_scope           ) }
+    };
+
+    // without a graphics context programs are only preprocessed, so compiles and binary cache hits stay zero
+    const auto program_statistics = content::load::get_program_load_statistics();
+    std::cout
+        << "Programs: " << program_statistics.n_preprocessed << " preprocessed in " << program_statistics.preprocess_seconds << " s, "
+        << program_statistics.n_compiled << " compiled in " << program_statistics.compile_seconds << " s, "
+        << program_statistics.n_binary_cache_hits << " loaded from binaries in " << program_statistics.binary_load_seconds << " s, "
+        << program_statistics.n_variant_hits << " shared with another path\n";
+
+    const auto program_json = json11::Json::object
+    {
+        { "n_preprocessed",         static_cast<double>( program_statistics.n_preprocessed          ) },
+        { "n_compiled",             static_cast<double>( program_statistics.n_compiled              ) },
+        { "n_binary_cache_hits",    static_cast<double>( program_statistics.n_binary_cache_hits     ) },
+        { "n_variant_hits",         static_cast<double>( program_statistics.n_variant_hits          ) },
+        { "preprocess_seconds",     program_statistics.preprocess_seconds                             },
+        { "compile_seconds",        program_statistics.compile_seconds                                },
+        { "binary_load_seconds",    program_statistics.binary_load_seconds                            }
+    };
+
+    const auto output_json = json11::Json::object
+    {
+        { "version",            1                                                               },
+        { "n_worker_threads",   static_cast<int>( content::WorkerPool::get_default_n_threads() ) },
+        { "results",            results_json                                                    },
+        { "scratch",            scratch_json                                                    },
+        { "programs",           program_json                                                    }
+    };
+    auto stream = std::ofstream( output_path.get_string() );
+    stream << output_json.dump() << "\n";
+    std::cout << "Wrote results to " << output_path.get_string() << "\n";
+    return stream.good() ? 0 : 1;
+}
+
+} // namespace content_benchmark
+} // namespace shake
+
+//----------------------------------------------------------------
+int main( int argc, char* argv[] )
+{
+    return shake::content_benchmark::run( argc, argv );
+}
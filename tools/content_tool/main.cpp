@@ -0,0 +1,72 @@
+#include <iostream>
+#include <string>
+
+#include "shake/io/path.hpp"
+
+#include "shake/content/compile_descriptor.hpp"
+#include "shake/content/content_archive.hpp"
+#include "shake/content/cook_mesh.hpp"
+#include "shake/content/cook_texture.hpp"
+
+namespace {
+
+//----------------------------------------------------------------
+int print_usage()
+{
+    std::cout 
+        << "usage:\n"
+        << "    shake_content_tool pack <content_directory> <archive_path>\n"
+        << "    shake_content_tool cook-textures <content_directory> <output_directory>\n"
+        << "    shake_content_tool cook-meshes <content_directory> <output_directory>\n"
+        << "    shake_content_tool compile-descriptors <content_directory> <output_directory>\n";
+    return 1;
+}
+
+//----------------------------------------------------------------
+int pack( const std::string& content_directory, const std::string& archive_path )
+{
+    const auto n_files = shake::content::write_content_archive( shake::io::Path { content_directory }, shake::io::Path { archive_path } );
+    std::cout << "Packed " << n_files << " files into " << archive_path << "\n";
+    return 0;
+}
+
+//----------------------------------------------------------------
+int cook_textures( const std::string& content_directory, const std::string& output_directory )
+{
+    const auto n_textures = shake::content::cook_textures( shake::io::Path { content_directory }, shake::io::Path { output_directory } );
+    std::cout << "Cooked " << n_textures << " textures into " << output_directory << "\n";
+    return 0;
+}
+
+//----------------------------------------------------------------
+int cook_meshes( const std::string& content_directory, const std::string& output_directory )
+{
+    const auto n_meshes = shake::content::cook_meshes( shake::io::Path { content_directory }, shake::io::Path { output_directory } );
+    std::cout << "Cooked " << n_meshes << " meshes into " << output_directory << "\n";
+    return 0;
+}
+
+//----------------------------------------------------------------
+int compile_descriptors( const std::string& content_directory, const std::string& output_directory )
+{
+    const auto n_descriptors = shake::content::compile_descriptors( shake::io::Path { content_directory }, shake::io::Path { output_directory } );
+    std::cout << "Compiled " << n_descriptors << " descriptors into " << output_directory << "\n";
+    return 0;
+}
+
+} // namespace anonymous
+
+//----------------------------------------------------------------
+int main( int argc, char* argv[] )
+{
+    if ( argc < 2 ) { return print_usage(); }
+
+    const auto command = std::string { argv[ 1 ] };
+
+    if ( command == "pack"                  && argc == 4 ) { return pack                ( argv[ 2 ], argv[ 3 ] ); }
+    if ( command == "cook-textures"         && argc == 4 ) { return cook_textures       ( argv[ 2 ], argv[ 3 ] ); }
+    if ( command == "cook-meshes"           && argc == 4 ) { return cook_meshes         ( argv[ 2 ], argv[ 3 ] ); }
+    if ( command == "compile-descriptors"   && argc == 4 ) { return compile_descriptors ( argv[ 2 ], argv[ 3 ] ); }
+
+    return print_usage();
+}